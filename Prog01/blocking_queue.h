@@ -0,0 +1,256 @@
+#ifndef _BLOCKING_QUEUE_H_
+#define _BLOCKING_QUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+
+#include "list.h"
+#include "queue.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Bounded blocking queue for producer/consumer threads
+/// @ingroup MySTL
+/// @tparam T Value type
+/// @tparam Container Underlying container of the wrapped queue
+///
+/// Wraps a mystl::queue with a mutex and two condition variables. Consumers
+/// sleep while the queue is empty and producers sleep while it is full instead
+/// of spinning on empty(). A waker only notifies when some thread is actually
+/// asleep on the condition, so an uncontended push or pop makes no wakeup
+/// call at all, and drain() removes a whole batch under one lock acquisition
+/// and a single notification.
+///
+/// close() starts shutdown: every blocked thread wakes up, further pushes
+/// fail, and pops keep succeeding until the remaining elements are consumed.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T, class Container = list<T>>
+class blocking_queue {
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    /// @param c Capacity, i.e., maximum number of queued elements
+    explicit blocking_queue(size_t c = std::numeric_limits<size_t>::max()) :
+      cap(c), is_closed(false), sleeping_consumers(0), sleeping_producers(0) {}
+
+    blocking_queue(const blocking_queue&) = delete;
+    blocking_queue& operator=(const blocking_queue&) = delete;
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of queue
+    size_t size() const {
+      std::lock_guard<std::mutex> lock(m);
+      return q.size();
+    }
+    /// @return Does the queue contain anything?
+    bool empty() const {
+      std::lock_guard<std::mutex> lock(m);
+      return q.empty();
+    }
+    /// @return Maximum number of queued elements
+    size_t capacity() const {return cap;}
+    /// @return Has close() been called?
+    bool closed() const {
+      std::lock_guard<std::mutex> lock(m);
+      return is_closed;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Add element to back of queue, waiting while the queue is full
+    /// @param val Element
+    /// @return false if the queue was closed, true otherwise
+    bool push(const T& val) {
+      std::unique_lock<std::mutex> lock(m);
+      while(!is_closed && q.size() >= cap)
+        sleep(not_full, sleeping_producers, lock);
+      return enqueue(val);
+    }
+    /// @brief Add element to back of queue, waiting at most \c timeout while
+    ///        the queue is full
+    /// @param val Element
+    /// @param timeout Maximum time to wait
+    /// @return false if the queue was closed or is still full, true otherwise
+    template<class Rep, class Period>
+      bool push(const T& val, const std::chrono::duration<Rep, Period>& timeout) {
+        std::chrono::steady_clock::time_point deadline =
+          std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(m);
+        while(!is_closed && q.size() >= cap)
+          if(!sleep_until(not_full, sleeping_producers, lock, deadline))
+            break;
+        return q.size() < cap && enqueue(val);
+      }
+    /// @brief Remove front element of queue, waiting while the queue is empty
+    /// @param[out] val Removed element
+    /// @return false if the queue is closed and empty, true otherwise
+    bool pop(T& val) {
+      std::unique_lock<std::mutex> lock(m);
+      while(!is_closed && q.empty())
+        sleep(not_empty, sleeping_consumers, lock);
+      return dequeue(val);
+    }
+    /// @brief Remove front element of queue, waiting at most \c timeout while
+    ///        the queue is empty
+    /// @param[out] val Removed element
+    /// @param timeout Maximum time to wait
+    /// @return false if the queue is still empty, true otherwise
+    template<class Rep, class Period>
+      bool pop(T& val, const std::chrono::duration<Rep, Period>& timeout) {
+        std::chrono::steady_clock::time_point deadline =
+          std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(m);
+        while(!is_closed && q.empty())
+          if(!sleep_until(not_empty, sleeping_consumers, lock, deadline))
+            break;
+        return dequeue(val);
+      }
+    /// @brief Remove up to \c max_n elements from the front of the queue,
+    ///        waiting while the queue is empty
+    /// @tparam OutputIterator Output iterator
+    /// @param out Destination of removed elements
+    /// @param max_n Maximum number of elements to remove
+    /// @return Number of removed elements, 0 only if the queue is closed and
+    ///         empty
+    template<class OutputIterator>
+      size_t drain(OutputIterator out, size_t max_n) {
+        std::unique_lock<std::mutex> lock(m);
+        while(!is_closed && q.empty())
+          sleep(not_empty, sleeping_consumers, lock);
+        return dequeue_n(out, max_n);
+      }
+    /// @brief Remove up to \c max_n elements from the front of the queue,
+    ///        waiting at most \c timeout while the queue is empty
+    /// @tparam OutputIterator Output iterator
+    /// @param out Destination of removed elements
+    /// @param max_n Maximum number of elements to remove
+    /// @param timeout Maximum time to wait
+    /// @return Number of removed elements
+    template<class OutputIterator, class Rep, class Period>
+      size_t drain(OutputIterator out, size_t max_n,
+          const std::chrono::duration<Rep, Period>& timeout) {
+        std::chrono::steady_clock::time_point deadline =
+          std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(m);
+        while(!is_closed && q.empty())
+          if(!sleep_until(not_empty, sleeping_consumers, lock, deadline))
+            break;
+        return dequeue_n(out, max_n);
+      }
+    /// @brief Close the queue and wake up all waiting threads
+    void close() {
+      std::lock_guard<std::mutex> lock(m);
+      is_closed = true;
+      not_empty.notify_all();
+      not_full.notify_all();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @brief Wait on \c cv while being counted as a sleeper
+    void sleep(std::condition_variable& cv, size_t& sleepers,
+        std::unique_lock<std::mutex>& lock) {
+      ++sleepers;
+      cv.wait(lock);
+      --sleepers;
+    }
+    /// @brief Wait on \c cv until \c deadline while being counted as a sleeper
+    /// @return false if the deadline has passed
+    bool sleep_until(std::condition_variable& cv, size_t& sleepers,
+        std::unique_lock<std::mutex>& lock,
+        const std::chrono::steady_clock::time_point& deadline) {
+      ++sleepers;
+      std::cv_status s = cv.wait_until(lock, deadline);
+      --sleepers;
+      return s == std::cv_status::no_timeout;
+    }
+
+    /// @brief Push while holding the lock, waking a consumer only if one
+    ///        sleeps
+    /// @return false if the queue is closed
+    bool enqueue(const T& val) {
+      if(is_closed)
+        return false;
+      q.push(val);
+      if(sleeping_consumers > 0)
+        not_empty.notify_one();
+      return true;
+    }
+    /// @brief Pop while holding the lock, waking a producer only if one sleeps
+    /// @return false if the queue is empty
+    bool dequeue(T& val) {
+      if(q.empty())
+        return false;
+      val = q.front();
+      q.pop();
+      if(sleeping_producers > 0)
+        not_full.notify_one();
+      return true;
+    }
+    /// @brief Pop a batch while holding the lock with at most one wakeup call
+    /// @return Number of removed elements
+    template<class OutputIterator>
+      size_t dequeue_n(OutputIterator out, size_t max_n) {
+        size_t n = 0;
+        for(; n < max_n && !q.empty(); ++n, ++out) {
+          *out = q.front();
+          q.pop();
+        }
+        if(n > 0 && sleeping_producers > 0) {
+          if(n == 1)
+            not_full.notify_one();
+          else
+            not_full.notify_all();
+        }
+        return n;
+      }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    queue<T, Container> q;             ///< Queued elements
+    const size_t cap;                  ///< Capacity
+    bool is_closed;                    ///< Has close() been called?
+    size_t sleeping_consumers;         ///< Threads waiting on not_empty
+    size_t sleeping_producers;         ///< Threads waiting on not_full
+    mutable std::mutex m;              ///< Guards all of the above
+    std::condition_variable not_empty; ///< Signaled when elements arrive
+    std::condition_variable not_full;  ///< Signaled when space frees up
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
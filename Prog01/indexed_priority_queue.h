@@ -0,0 +1,205 @@
+#ifndef _INDEXED_PRIORITY_QUEUE_H_
+#define _INDEXED_PRIORITY_QUEUE_H_
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "vector.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Indexed priority queue implemented as a d-ary heap
+/// @ingroup MySTL
+/// @tparam Priority Priority type
+/// @tparam Compare Comparator, top() is the least element by \c Compare
+/// @tparam Arity Number of children of each heap node
+///
+/// Keys are dense indices in [0, n), e.g., graph vertex descriptors. Besides
+/// the heap, a position array maps every key to its slot in the heap, which
+/// allows contains(), decrease_key() and erase() on arbitrary keys in
+/// O(log n) without ever storing a key twice.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Priority, class Compare = std::less<Priority>,
+  size_t Arity = 4>
+class indexed_priority_queue {
+
+  static_assert(Arity >= 2,
+      "indexed_priority_queue requires an arity of at least 2");
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Heap entry
+  //////////////////////////////////////////////////////////////////////////////
+  struct entry {
+    size_t key;        ///< Key
+    Priority priority; ///< Priority of key
+  };
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef size_t key_type;        ///< Dense key type
+    typedef Priority priority_type; ///< Priority type
+
+    static const size_t npos;       ///< Position of keys not in the queue
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    /// @param n Expected number of keys, keys are in [0, n)
+    /// @param cmp Comparator
+    explicit indexed_priority_queue(size_t n = 0,
+        const Compare& cmp = Compare()) : pos(n, npos), comp(cmp) {}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of priority queue
+    size_t size() const {return heap.size();}
+    /// @return Does the priority queue contain anything?
+    bool empty() const {return heap.empty();}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @return Key with the least priority
+    key_type top() const {return heap[0].key;}
+    /// @return Least priority
+    const Priority& top_priority() const {return heap[0].priority;}
+    /// @param k Key, must be contained
+    /// @return Priority of \c k
+    const Priority& priority(key_type k) const {return heap[pos[k]].priority;}
+    /// @param k Key
+    /// @return Is \c k in the priority queue?
+    bool contains(key_type k) const {return k < pos.size() && pos[k] != npos;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Add key to priority queue
+    /// @param k Key, must not be contained
+    /// @param p Priority
+    void push(key_type k, const Priority& p) {
+      if(k >= pos.size())
+        pos.resize(k + 1, npos);
+      entry e = {k, p};
+      heap.push_back(e);
+      sift_up(heap.size() - 1);
+    }
+    /// @brief Remove key with the least priority
+    void pop() {
+      erase(heap[0].key);
+    }
+    /// @brief Lower the priority of a key
+    /// @param k Key, must be contained
+    /// @param p New priority, must not be greater than the current one
+    void decrease_key(key_type k, const Priority& p) {
+      heap[pos[k]].priority = p;
+      sift_up(pos[k]);
+    }
+    /// @brief Remove key from priority queue
+    /// @param k Key, must be contained
+    void erase(key_type k) {
+      size_t i = pos[k];
+      pos[k] = npos;
+      size_t last = heap.size() - 1;
+      if(i != last) {
+        heap[i] = std::move(heap[last]);
+        pos[heap[i].key] = i;
+      }
+      heap.pop_back();
+      if(i != last) {
+        sift_up(i);
+        sift_down(i);
+      }
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @brief Move entry at \c i towards the root until heap order holds
+    /// @param i Index of entry
+    void sift_up(size_t i) {
+      entry e = std::move(heap[i]);
+      while(i != 0) {
+        size_t q = (i - 1)/Arity;
+        if(!comp(e.priority, heap[q].priority))
+          break;
+        heap[i] = std::move(heap[q]);
+        pos[heap[i].key] = i;
+        i = q;
+      }
+      heap[i] = std::move(e);
+      pos[heap[i].key] = i;
+    }
+
+    /// @brief Move entry at \c i towards the leaves until heap order holds
+    /// @param i Index of entry
+    void sift_down(size_t i) {
+      const size_t n = heap.size();
+      entry e = std::move(heap[i]);
+      for(size_t f = Arity*i + 1; f < n; f = Arity*i + 1) {
+        size_t l = f + Arity < n ? f + Arity : n;
+        size_t best = f;
+        for(size_t j = f + 1; j < l; ++j)
+          if(comp(heap[j].priority, heap[best].priority))
+            best = j;
+        if(!comp(heap[best].priority, e.priority))
+          break;
+        heap[i] = std::move(heap[best]);
+        pos[heap[i].key] = i;
+        i = best;
+      }
+      heap[i] = std::move(e);
+      pos[heap[i].key] = i;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    vector<entry> heap; ///< Implicit d-ary heap of (key, priority) entries
+    vector<size_t> pos; ///< Position of each key in heap or npos
+    Compare comp;       ///< Comparator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+template<typename Priority, class Compare, size_t Arity>
+  const size_t indexed_priority_queue<Priority, Compare, Arity>::npos =
+    size_t(-1);
+
+}
+
+#endif
@@ -131,17 +131,14 @@ class list {
     /// @param val Initial value
     list(size_t n = 0, const T& val = T()) : head(NULL), tail(NULL), sz(n) {
 		/// @todo Implement default construction
- 		if(n==0){ //different cases for n<2
-			head=new node(T(),NULL,tail);
-			tail=new node(T(),head,NULL);
-		}
+		//different cases for n<=2, an empty list has no nodes at all
 		if(n==1){
-			head=new node(val,NULL,tail);
-			tail=new node(T(),head,NULL);
+			head=tail=new node(val,NULL,NULL);
 		}
 		if(n==2){
-			head=new node(val,NULL,tail);
+			head=new node(val,NULL,NULL);
 			tail=new node(val,head,NULL);
+			head->next=tail;
 		}
 			
 		if(n>2){ //creates a head and a new node that has a previous point to head
@@ -149,7 +146,7 @@ class list {
 			node* previous_node = new node(val,head,NULL);
 			head->next=previous_node;
 			
-				for(size_t i = 0; i <n-2; i++){ //keeps making new nodes that has a previous that points to the prev and sets the previous's next equal to the new node.
+				for(size_t i = 0; i <n-3; i++){ //keeps making new nodes that has a previous that points to the prev and sets the previous's next equal to the new node.
 					node* tmp = new node(val, previous_node, NULL);
 					previous_node->next=tmp;
 					previous_node = tmp;
@@ -163,7 +160,7 @@ class list {
 	}
     /// @brief Copy constructor
     /// @param v
-    list(const list& v) {
+    list(const list& v) : head(NULL), tail(NULL), sz(0) {
       /// @todo Implement copy construction
 		  clear();	//clears and then pushes back all the elements into the current list
 		  size_t runTotal=v.size();
@@ -265,10 +262,10 @@ class list {
     void push_front(const T& val) {
       /// @todo Implement push front (hint: don't forget the case when the list
       ///       is empty) 
-    node* temp = new node(val, nullptr, head); //pushes to the front by making a new head and then switching pointers
-    if(tail == nullptr)
+    node* temp = new node(val, nullptr, sz == 0 ? nullptr : head); //pushes to the front by making a new head and then switching pointers
+    if(sz == 0)
         tail = temp;
-    if(head != nullptr)
+    else
         head->prev = temp;
     head = temp;
     sz++;
@@ -283,7 +280,8 @@ class list {
 		head = head->next;
 		if(head != nullptr)
 			head->prev = nullptr;
-		--sz;
+		if(--sz == 0) //the list is empty again, forget the old tail
+			head = tail = nullptr;
 		delete tmp;
     }
     /// @brief Add element to end of list
@@ -291,10 +289,10 @@ class list {
     void push_back(const T& val) {
       /// @todo Implement push back (hint: don't forget the case when the list
       ///       is empty)
-		node* temp = new node(val, tail, nullptr); //pushes to the back by making a new tail and switching some pointers
+		node* temp = new node(val, sz==0 ? nullptr : tail, nullptr); //pushes to the back by making a new tail and switching some pointers
 		if(sz==0)
 			head = temp;
-		if(tail != nullptr)
+		else
 			tail->next = temp;
 		tail = temp;
 		++sz;
@@ -311,7 +309,8 @@ class list {
 		tail = tail->prev;
 		if(tail != nullptr)
 			tail->next = nullptr;
-		--sz;
+		if(--sz == 0) //the list is empty again, forget the old head
+			head = tail = nullptr;
 		delete tmp;
     }
     /// @brief Insert element before specified position
@@ -0,0 +1,236 @@
+#ifndef _PAIRING_HEAP_H_
+#define _PAIRING_HEAP_H_
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "vector.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Indexed pairing heap
+/// @ingroup MySTL
+/// @tparam Priority Priority type
+/// @tparam Compare Comparator, top() is the least element by \c Compare
+///
+/// Same interface as indexed_priority_queue. Keys are dense indices in
+/// [0, n) and key \c k always occupies node \c k, so no allocation happens
+/// after construction. decrease_key() is amortized O(1) (it cuts the node and
+/// melds it with the root), pop() and erase() are amortized O(log n) using the
+/// two-pass pairing of the children.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Priority, class Compare = std::less<Priority>>
+class pairing_heap {
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Heap node, links are keys of other nodes or npos
+  //////////////////////////////////////////////////////////////////////////////
+  struct node {
+    Priority priority; ///< Priority of key
+    size_t child;      ///< First child
+    size_t next;       ///< Right sibling
+    size_t prev;       ///< Left sibling, or parent for the first child
+    bool in;           ///< Is the key in the heap?
+  };
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef size_t key_type;        ///< Dense key type
+    typedef Priority priority_type; ///< Priority type
+
+    static const size_t npos;       ///< Null link
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    /// @param n Expected number of keys, keys are in [0, n)
+    /// @param cmp Comparator
+    explicit pairing_heap(size_t n = 0, const Compare& cmp = Compare()) :
+      nodes(n, empty_node()), root(npos), sz(0), comp(cmp) {}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of heap
+    size_t size() const {return sz;}
+    /// @return Does the heap contain anything?
+    bool empty() const {return sz == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @return Key with the least priority
+    key_type top() const {return root;}
+    /// @return Least priority
+    const Priority& top_priority() const {return nodes[root].priority;}
+    /// @param k Key, must be contained
+    /// @return Priority of \c k
+    const Priority& priority(key_type k) const {return nodes[k].priority;}
+    /// @param k Key
+    /// @return Is \c k in the heap?
+    bool contains(key_type k) const {return k < nodes.size() && nodes[k].in;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Add key to heap
+    /// @param k Key, must not be contained
+    /// @param p Priority
+    void push(key_type k, const Priority& p) {
+      if(k >= nodes.size())
+        nodes.resize(k + 1, empty_node());
+      nodes[k] = empty_node();
+      nodes[k].priority = p;
+      nodes[k].in = true;
+      root = root == npos ? k : meld(root, k);
+      ++sz;
+    }
+    /// @brief Remove key with the least priority
+    void pop() {
+      size_t r = root;
+      root = merge_pairs(nodes[r].child);
+      nodes[r].child = npos;
+      nodes[r].in = false;
+      --sz;
+    }
+    /// @brief Lower the priority of a key
+    /// @param k Key, must be contained
+    /// @param p New priority, must not be greater than the current one
+    void decrease_key(key_type k, const Priority& p) {
+      nodes[k].priority = p;
+      if(k != root) {
+        cut(k);
+        root = meld(root, k);
+      }
+    }
+    /// @brief Remove key from heap
+    /// @param k Key, must be contained
+    void erase(key_type k) {
+      if(k == root) {
+        pop();
+        return;
+      }
+      cut(k);
+      size_t sub = merge_pairs(nodes[k].child);
+      nodes[k].child = npos;
+      nodes[k].in = false;
+      --sz;
+      if(sub != npos)
+        root = meld(root, sub);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @return Node which is not in the heap and has no links
+    static node empty_node() {
+      node n = {Priority(), npos, npos, npos, false};
+      return n;
+    }
+
+    /// @brief Link two detached trees
+    /// @param a Root of first tree
+    /// @param b Root of second tree
+    /// @return Root of the linked tree
+    size_t meld(size_t a, size_t b) {
+      if(comp(nodes[b].priority, nodes[a].priority))
+        std::swap(a, b);
+      nodes[b].next = nodes[a].child;
+      if(nodes[a].child != npos)
+        nodes[nodes[a].child].prev = b;
+      nodes[b].prev = a;
+      nodes[a].child = b;
+      return a;
+    }
+
+    /// @brief Detach the subtree rooted at \c k from its parent
+    /// @param k Key of a non-root node
+    void cut(size_t k) {
+      size_t p = nodes[k].prev, n = nodes[k].next;
+      if(nodes[p].child == k)
+        nodes[p].child = n;
+      else
+        nodes[p].next = n;
+      if(n != npos)
+        nodes[n].prev = p;
+      nodes[k].prev = nodes[k].next = npos;
+    }
+
+    /// @brief Two-pass pairing of a sibling list
+    /// @param first First sibling or npos
+    /// @return Root of the combined tree or npos
+    size_t merge_pairs(size_t first) {
+      if(first == npos)
+        return npos;
+      // left to right, meld siblings pairwise
+      pairs.clear();
+      while(first != npos) {
+        size_t a = first, b = nodes[a].next;
+        if(b == npos) {
+          nodes[a].prev = npos;
+          pairs.push_back(a);
+          break;
+        }
+        first = nodes[b].next;
+        nodes[a].prev = nodes[a].next = nodes[b].prev = nodes[b].next = npos;
+        pairs.push_back(meld(a, b));
+      }
+      // right to left, meld the pairs into one tree
+      size_t r = pairs.back();
+      for(size_t i = pairs.size() - 1; i-- > 0; )
+        r = meld(pairs[i], r);
+      return r;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    vector<node> nodes;   ///< Node of each key
+    vector<size_t> pairs; ///< Scratch space for merge_pairs
+    size_t root;          ///< Key of root or npos
+    size_t sz;            ///< Number of keys in heap
+    Compare comp;         ///< Comparator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+template<typename Priority, class Compare>
+  const size_t pairing_heap<Priority, Compare>::npos = size_t(-1);
+
+}
+
+#endif
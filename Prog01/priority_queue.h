@@ -0,0 +1,189 @@
+#ifndef _PRIORITY_QUEUE_H_
+#define _PRIORITY_QUEUE_H_
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "vector.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Priority queue container adapter implemented as a d-ary heap
+/// @ingroup MySTL
+/// @tparam T Value type
+/// @tparam Container Underlying random access container of the heap
+/// @tparam Compare Comparator, top() is the greatest element by \c Compare
+/// @tparam Arity Number of children of each heap node (2, 4, 8, ...)
+///
+/// The heap is stored implicitly in \c Container. The root lives at index
+/// <tt>Arity - 1</tt> (the slots before it are padding), so the children of
+/// every node start at an index which is a multiple of \c Arity. When
+/// <tt>Arity * sizeof(T)</tt> divides the cache line size and the buffer is
+/// aligned to it, all siblings compared during a sift down share one line.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T, class Container = vector<T>,
+  class Compare = std::less<T>, size_t Arity = 4>
+class priority_queue {
+
+  static_assert(Arity >= 2, "priority_queue requires an arity of at least 2");
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    /// @param cmp Comparator
+    explicit priority_queue(const Compare& cmp = Compare()) : comp(cmp) {
+      pad();
+    }
+    /// @brief Construct from range [first, last) with an O(n) heapify
+    /// @tparam InputIterator Input iterator
+    /// @param first Initial position of sequence
+    /// @param last Final position of sequence
+    /// @param cmp Comparator
+    template<class InputIterator>
+      priority_queue(InputIterator first, InputIterator last,
+          const Compare& cmp = Compare()) : comp(cmp) {
+        pad();
+        for(; first != last; ++first)
+          c.push_back(*first);
+        heapify();
+      }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of priority queue
+    size_t size() const {return c.size() - root;}
+    /// @return Does the priority queue contain anything?
+    bool empty() const {return c.size() == root;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @return Greatest element of priority queue
+    const T& top() const {return c[root];}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Add element to priority queue
+    /// @param val Element
+    void push(const T& val) {
+      c.push_back(val);
+      sift_up(c.size() - 1);
+    }
+    /// @brief Construct element in place and add it to priority queue
+    /// @tparam Args Constructor argument types
+    /// @param args Arguments forwarded to the constructor of \c T
+    template<typename... Args>
+      void emplace(Args&&... args) {
+        c.push_back(T(std::forward<Args>(args)...));
+        sift_up(c.size() - 1);
+      }
+    /// @brief Remove greatest element from priority queue
+    void pop() {
+      if(c.size() - 1 != root)
+        c[root] = std::move(c[c.size() - 1]);
+      c.pop_back();
+      if(!empty())
+        sift_down(root);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @param p Index of node
+    /// @return Index of first child of \c p
+    static size_t first_child(size_t p) {return Arity*(p + 2 - Arity);}
+    /// @param p Index of node, must not be the root
+    /// @return Index of parent of \c p
+    static size_t parent(size_t p) {return p/Arity + Arity - 2;}
+
+    /// @brief Fill the padding slots in front of the root
+    void pad() {
+      for(size_t i = 0; i < root; ++i)
+        c.push_back(T());
+    }
+
+    /// @brief Restore heap order of the entire container bottom up in O(n)
+    void heapify() {
+      if(size() < 2)
+        return;
+      for(size_t p = parent(c.size() - 1) + 1; p-- > root; )
+        sift_down(p);
+    }
+
+    /// @brief Move element at \c p towards the root until heap order holds
+    /// @param p Index of element
+    void sift_up(size_t p) {
+      T val = std::move(c[p]);
+      while(p != root) {
+        size_t q = parent(p);
+        if(!comp(c[q], val))
+          break;
+        c[p] = std::move(c[q]);
+        p = q;
+      }
+      c[p] = std::move(val);
+    }
+
+    /// @brief Move element at \c p towards the leaves until heap order holds
+    /// @param p Index of element
+    void sift_down(size_t p) {
+      const size_t n = c.size();
+      T val = std::move(c[p]);
+      for(size_t f = first_child(p); f < n; f = first_child(p)) {
+        size_t l = f + Arity < n ? f + Arity : n;
+        size_t best = f;
+        for(size_t j = f + 1; j < l; ++j)
+          if(comp(c[best], c[j]))
+            best = j;
+        if(!comp(val, c[best]))
+          break;
+        c[p] = std::move(c[best]);
+        p = best;
+      }
+      c[p] = std::move(val);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    static const size_t root = Arity - 1; ///< Index of root of heap
+    Container c;  ///< Container for heap, preceded by \c root padding slots
+    Compare comp; ///< Comparator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
@@ -58,11 +58,11 @@ class queue {
     /// @brief Add element to back of queue
     /// @param val Element
     void push(const T& val) {
-      /// @bonus Implement queue push
+      c.push_back(val);
     }
     /// @brief Remove front element from queue
     void pop() {
-      /// @bonus Implement queue pop
+      c.pop_front();
     }
 
     /// @}
@@ -0,0 +1,188 @@
+#ifndef _RADIX_HEAP_H_
+#define _RADIX_HEAP_H_
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Monotone radix heap, a min priority queue for unsigned integer keys
+/// @ingroup MySTL
+/// @tparam Key Unsigned integral key type
+/// @tparam Value Value type
+///
+/// The heap is monotone: a pushed key may never be less than the last key
+/// removed by pop(), which is exactly the access pattern of Dijkstra's
+/// algorithm. Entries are kept in buckets by the highest bit in which their key
+/// differs from the last removed key, so each entry moves between buckets at
+/// most once per bit and push/pop are O(log C) amortized, where C is the
+/// largest key difference. Duplicate keys are allowed.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value>
+class radix_heap {
+
+  static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value,
+      "radix_heap requires an unsigned integral key");
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;                         ///< Key type
+    typedef Value mapped_type;                    ///< Value type
+    typedef std::pair<key_type, mapped_type>
+      value_type;                                 ///< Entry type
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    radix_heap() : last(0), sz(0), least_bucket(0), least_index(0) {}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of heap
+    size_t size() const {return sz;}
+    /// @return Does the heap contain anything?
+    bool empty() const {return sz == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @return Entry with the least key
+    ///
+    /// Does not move the heap past the last removed key, so any key allowed
+    /// before the call may still be pushed after it. Not const, as it
+    /// remembers where the least key is, so that repeated calls and the next
+    /// pop() do not scan its bucket again.
+    const value_type& top() {
+      if(!buckets[0].empty())
+        return buckets[0].back();
+      find_least();
+      return buckets[least_bucket][least_index];
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Add entry to heap
+    /// @param k Key, must not be less than the last removed key
+    /// @param v Value
+    ///
+    /// Throws an \c invalid_argument exception if \c k breaks the monotone
+    /// contract.
+    void push(const Key& k, const Value& v) {
+      if(k < last)
+        throw std::invalid_argument("radix_heap key below last popped key");
+      if(least_bucket != 0 && k < buckets[least_bucket][least_index].first)
+        least_bucket = 0;
+      buckets[bucket(k)].push_back(value_type(k, v));
+      ++sz;
+    }
+    /// @brief Remove entry with the least key
+    void pop() {
+      pull();
+      buckets[0].pop_back();
+      --sz;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @param k Key
+    /// @return Bucket of \c k, i.e., one plus the index of the highest bit in
+    ///         which \c k differs from the last removed key
+    size_t bucket(Key k) const {
+      unsigned long long x = k ^ last;
+      return x == 0 ? 0 :
+        std::numeric_limits<unsigned long long>::digits - __builtin_clzll(x);
+    }
+
+    /// @brief Locate the least key in the first nonempty bucket, unless
+    ///        already known. Bucket 0 must be empty.
+    void find_least() {
+      if(least_bucket != 0)
+        return;
+      size_t i = 1;
+      while(buckets[i].empty())
+        ++i;
+      const vector<value_type>& b = buckets[i];
+      size_t least = 0;
+      for(size_t j = 1; j < b.size(); ++j)
+        if(b[j].first < b[least].first)
+          least = j;
+      least_bucket = i;
+      least_index = least;
+    }
+
+    /// @brief Ensure the least key is in bucket 0 by redistributing the first
+    ///        nonempty bucket around its least key, which becomes the last
+    ///        removed key
+    void pull() {
+      if(!buckets[0].empty())
+        return;
+      find_least();
+      vector<value_type>& b = buckets[least_bucket];
+      last = b[least_index].first;
+      least_bucket = 0;
+      for(size_t j = 0; j < b.size(); ++j)
+        buckets[bucket(b[j].first)].push_back(b[j]);
+      b.clear();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    static const size_t num_buckets =
+      std::numeric_limits<Key>::digits + 1; ///< One bucket per bit plus one
+
+    vector<value_type> buckets[num_buckets]; ///< Entries by bucket
+    Key last;                                ///< Last removed key
+    size_t sz;                               ///< Number of entries
+    size_t least_bucket;                     ///< Bucket of the least key
+                                             ///< found by top(), 0 if unknown
+    size_t least_index;                      ///< Index of that key in its
+                                             ///< bucket
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
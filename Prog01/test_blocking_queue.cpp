@@ -0,0 +1,156 @@
+#include <chrono>
+#include <thread>
+
+#include "blocking_queue.h"
+#include "vector.h"
+
+#include "unit_test.h"
+
+using mystl::blocking_queue;
+using mystl::vector;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of blocking queue
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class blocking_queue_test : public test_class {
+
+  protected:
+
+    void test() {
+
+      test_push();
+
+      test_pop();
+
+      test_pop_timeout();
+
+      test_push_timeout();
+
+      test_drain();
+
+      test_close();
+
+      test_producer_consumer();
+
+    }
+
+  private:
+
+    /// @brief Test push
+    void test_push() {
+      blocking_queue<int> q;
+
+      bool pushed = q.push(2);
+
+      assert_msg(pushed && q.size() == 1 && !q.empty(), "Push failed.");
+    }
+
+    /// @brief Test pop
+    void test_pop() {
+      blocking_queue<int> q;
+      q.push(10);
+      q.push(9);
+
+      int val = 0;
+      bool popped = q.pop(val);
+
+      assert_msg(popped && val == 10 && q.size() == 1, "Pop failed.");
+    }
+
+    /// @brief Test pop on an empty queue times out
+    void test_pop_timeout() {
+      blocking_queue<int> q;
+
+      int val = 0;
+      bool popped = q.pop(val, std::chrono::milliseconds(10));
+
+      assert_msg(!popped && q.empty(), "Pop timeout failed.");
+    }
+
+    /// @brief Test push on a full queue times out
+    void test_push_timeout() {
+      blocking_queue<int> q(1);
+      q.push(1);
+
+      bool pushed = q.push(2, std::chrono::milliseconds(10));
+
+      assert_msg(!pushed && q.size() == 1, "Push timeout failed.");
+    }
+
+    /// @brief Test drain removes a batch in order
+    void test_drain() {
+      blocking_queue<int> q;
+      for(int i = 0; i < 5; ++i)
+        q.push(i);
+
+      int out[3];
+      size_t n = q.drain(out, 3);
+
+      assert_msg(n == 3 && out[0] == 0 && out[1] == 1 && out[2] == 2 &&
+          q.size() == 2, "Drain failed.");
+    }
+
+    /// @brief Test close rejects pushes, drains remaining elements, and wakes
+    ///        a blocked consumer
+    void test_close() {
+      blocking_queue<int> q;
+      q.push(1);
+      q.close();
+
+      int val = 0;
+      bool pushed = q.push(2);
+      bool popped = q.pop(val);
+      bool popped_empty = q.pop(val);
+
+      blocking_queue<int> r;
+      bool woken_result = true;
+      std::thread consumer([&]() {int v; woken_result = r.pop(v);});
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      r.close();
+      consumer.join();
+
+      assert_msg(!pushed && popped && val == 1 && !popped_empty &&
+          !woken_result && q.closed(), "Close failed.");
+    }
+
+    /// @brief Test producers and consumers on a small bounded queue
+    void test_producer_consumer() {
+      blocking_queue<int> q(16);
+      const int per_producer = 10000;
+      long sums[2] = {0, 0};
+
+      std::thread producers[2], consumers[2];
+      for(int t = 0; t < 2; ++t)
+        producers[t] = std::thread([&]() {
+            for(int i = 1; i <= per_producer; ++i)
+              q.push(i);
+            });
+      for(int t = 0; t < 2; ++t)
+        consumers[t] = std::thread([&, t]() {
+            vector<int> batch(8);
+            size_t n;
+            while((n = q.drain(batch.begin(), 8)) > 0)
+              for(size_t i = 0; i < n; ++i)
+                sums[t] += batch[i];
+            });
+      for(int t = 0; t < 2; ++t)
+        producers[t].join();
+      q.close();
+      for(int t = 0; t < 2; ++t)
+        consumers[t].join();
+
+      long expected = 2L * per_producer * (per_producer + 1) / 2;
+      assert_msg(sums[0] + sums[1] == expected, "Producer consumer failed.");
+    }
+
+};
+
+int main() {
+  blocking_queue_test bqt;
+
+  if(bqt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include <cstdlib>
+
+#include "pairing_heap.h"
+
+#include "unit_test.h"
+
+using mystl::pairing_heap;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of pairing heap
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class pairing_heap_test : public test_class {
+
+  protected:
+
+    void test() {
+
+      test_push();
+
+      test_pop();
+
+      test_contains();
+
+      test_decrease_key();
+
+      test_erase();
+
+      test_random_operations();
+
+    }
+
+  private:
+
+    /// @brief Test push
+    void test_push() {
+      pairing_heap<double> pq(4);
+
+      pq.push(2, 0.5);
+      pq.push(0, 0.25);
+      pq.push(3, 0.75);
+
+      assert_msg(pq.size() == 3 && !pq.empty() && pq.top() == 0 &&
+          pq.top_priority() == 0.25, "Push failed.");
+    }
+
+    /// @brief Test pop
+    void test_pop() {
+      pairing_heap<int> pq;
+      pq.push(7, 3);
+      pq.push(1, 2);
+
+      pq.pop();
+
+      assert_msg(pq.size() == 1 && pq.top() == 7 && !pq.contains(1),
+          "Pop failed.");
+    }
+
+    /// @brief Test contains
+    void test_contains() {
+      pairing_heap<int> pq(10);
+      pq.push(4, 1);
+
+      assert_msg(pq.contains(4) && !pq.contains(5) && !pq.contains(100),
+          "Contains failed.");
+    }
+
+    /// @brief Test decrease key
+    void test_decrease_key() {
+      pairing_heap<int> pq(5);
+      for(size_t i = 0; i < 5; ++i)
+        pq.push(i, 10 + i);
+
+      pq.decrease_key(4, 1);
+
+      assert_msg(pq.top() == 4 && pq.priority(4) == 1 && pq.size() == 5,
+          "Decrease key failed.");
+    }
+
+    /// @brief Test erase
+    void test_erase() {
+      pairing_heap<int> pq(5);
+      for(size_t i = 0; i < 5; ++i)
+        pq.push(i, i);
+
+      pq.erase(0);
+      pq.erase(3);
+
+      assert_msg(pq.size() == 3 && pq.top() == 1 && !pq.contains(3),
+          "Erase failed.");
+    }
+
+    /// @brief Test a random mix of operations against a brute force minimum
+    void test_random_operations() {
+      const size_t n = 200;
+      pairing_heap<int> pq(n);
+      int pri[n];
+      bool in[n] = {};
+      bool ok = true;
+      for(size_t t = 0; t < 5000 && ok; ++t) {
+        size_t k = rand() % n;
+        int op = rand() % 4;
+        if(!in[k]) {
+          pri[k] = rand() % 1000;
+          pq.push(k, pri[k]);
+          in[k] = true;
+        }
+        else if(op == 0) {
+          pri[k] -= rand() % 100;
+          pq.decrease_key(k, pri[k]);
+        }
+        else if(op == 1) {
+          pq.erase(k);
+          in[k] = false;
+        }
+        else if(op == 2) {
+          int least = 1 << 30;
+          for(size_t i = 0; i < n; ++i)
+            if(in[i] && pri[i] < least)
+              least = pri[i];
+          ok = pq.top_priority() == least && pri[pq.top()] == least;
+          in[pq.top()] = false;
+          pq.pop();
+        }
+      }
+
+      assert_msg(ok, "Random operations failed.");
+    }
+
+};
+
+int main() {
+  pairing_heap_test pqt;
+
+  if(pqt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <functional>
+#include <utility>
+
+#include "priority_queue.h"
+#include "vector.h"
+
+#include "unit_test.h"
+
+using mystl::priority_queue;
+using mystl::vector;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of priority queue
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class priority_queue_test : public test_class {
+
+  protected:
+
+    void test() {
+
+      test_push();
+
+      test_pop();
+
+      test_pop_order<2>();
+
+      test_pop_order<4>();
+
+      test_pop_order<8>();
+
+      test_heapify();
+
+      test_emplace();
+
+      test_compare();
+
+    }
+
+  private:
+
+    /// @brief Test push
+    void test_push() {
+      priority_queue<int> pq;
+
+      pq.push(2);
+      pq.push(7);
+      pq.push(5);
+
+      assert_msg(pq.size() == 3 && !pq.empty() && pq.top() == 7,
+          "Push failed.");
+    }
+
+    /// @brief Test pop
+    void test_pop() {
+      priority_queue<int> pq;
+      pq.push(10);
+      pq.push(9);
+
+      pq.pop();
+      bool one_left = pq.size() == 1 && pq.top() == 9;
+      pq.pop();
+
+      assert_msg(one_left && pq.empty(), "Pop failed.");
+    }
+
+    /// @brief Test popping returns elements in nonincreasing order
+    /// @tparam Arity Arity of heap
+    template<size_t Arity>
+      void test_pop_order() {
+        priority_queue<int, vector<int>, std::less<int>, Arity> pq;
+        for(int i = 0; i < 1000; ++i)
+          pq.push((i * 7919) % 1009);
+
+        bool ordered = pq.size() == 1000;
+        int last = pq.top();
+        while(!pq.empty()) {
+          ordered = ordered && pq.top() <= last;
+          last = pq.top();
+          pq.pop();
+        }
+
+        assert_msg(ordered, "Pop order failed.");
+      }
+
+    /// @brief Test construction from a range
+    void test_heapify() {
+      int a[] = {3, 2, 5, 6, 8, 4, 3, 1};
+      priority_queue<int, vector<int>, std::less<int>, 8> pq(a, a + 8);
+      int sorted[] = {8, 6, 5, 4, 3, 3, 2, 1};
+
+      bool ordered = pq.size() == 8;
+      for(size_t i = 0; i < 8; ++i, pq.pop())
+        ordered = ordered && pq.top() == sorted[i];
+
+      assert_msg(ordered, "Heapify failed.");
+    }
+
+    /// @brief Test emplace
+    void test_emplace() {
+      priority_queue<std::pair<int, int>> pq;
+      pq.emplace(1, 5);
+      pq.emplace(3, 2);
+
+      assert_msg(pq.size() == 2 && pq.top() == std::make_pair(3, 2),
+          "Emplace failed.");
+    }
+
+    /// @brief Test min heap through comparator
+    void test_compare() {
+      priority_queue<int, vector<int>, std::greater<int>, 2> pq;
+      pq.push(4);
+      pq.push(1);
+      pq.push(3);
+
+      assert_msg(pq.top() == 1, "Compare failed.");
+    }
+
+};
+
+int main() {
+  priority_queue_test pqt;
+
+  if(pqt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
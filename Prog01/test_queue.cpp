@@ -16,10 +16,9 @@ class queue_test : public test_class {
 
     void test() {
 
-      /// @bonus Uncomment these tests for bonus.
-      //test_push();
+      test_push();
 
-      //test_pop();
+      test_pop();
 
     }
 
@@ -0,0 +1,160 @@
+#include <cstdlib>
+#include <set>
+#include <stdexcept>
+
+#include "radix_heap.h"
+
+#include "unit_test.h"
+
+using mystl::radix_heap;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of radix heap
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class radix_heap_test : public test_class {
+
+  protected:
+
+    void test() {
+
+      test_push();
+
+      test_pop();
+
+      test_duplicates();
+
+      test_monotone_order();
+
+      test_monotone_violation();
+
+      test_top_then_push();
+
+      test_top_interleaved();
+
+    }
+
+  private:
+
+    /// @brief Test push
+    void test_push() {
+      radix_heap<unsigned, char> h;
+
+      h.push(9, 'a');
+      h.push(4, 'b');
+      h.push(6, 'c');
+
+      assert_msg(h.size() == 3 && !h.empty() && h.top().first == 4 &&
+          h.top().second == 'b', "Push failed.");
+    }
+
+    /// @brief Test pop
+    void test_pop() {
+      radix_heap<unsigned, char> h;
+      h.push(9, 'a');
+      h.push(4, 'b');
+
+      h.pop();
+
+      assert_msg(h.size() == 1 && h.top().first == 9, "Pop failed.");
+    }
+
+    /// @brief Test duplicate keys are all kept
+    void test_duplicates() {
+      radix_heap<unsigned long, int> h;
+      h.push(3, 1);
+      h.push(3, 2);
+      h.push(3, 3);
+
+      h.pop();
+      h.pop();
+
+      assert_msg(h.size() == 1 && h.top().first == 3, "Duplicates failed.");
+    }
+
+    /// @brief Test interleaved monotone pushes and pops come out sorted
+    void test_monotone_order() {
+      radix_heap<unsigned, unsigned> h;
+      h.push(0, 0);
+      unsigned last = 0;
+      bool ordered = true;
+      for(size_t i = 0; i < 10000; ++i) {
+        unsigned k = h.top().first;
+        ordered = ordered && k >= last;
+        last = k;
+        h.pop();
+        h.push(k + rand() % 100, 0);
+        h.push(k + rand() % 10000, 0);
+      }
+
+      assert_msg(ordered && h.size() == 10001, "Monotone order failed.");
+    }
+
+    /// @brief Test pushing a key below the last popped key throws
+    void test_monotone_violation() {
+      radix_heap<unsigned, char> h;
+      h.push(5, 'a');
+      h.pop();
+
+      try {
+        h.push(4, 'b');
+        assert_msg(false, "Monotone violation failed.");
+      }
+      catch(const std::invalid_argument&) {
+        //test success!
+      }
+    }
+
+    /// @brief Test top does not raise the floor for pushed keys, only pop
+    ///        does
+    void test_top_then_push() {
+      radix_heap<unsigned, char> h;
+      h.push(10, 'a');
+      h.top();
+
+      h.push(3, 'b');
+
+      assert_msg(h.size() == 2 && h.top().first == 3 &&
+          h.top().second == 'b', "Top then push failed.");
+    }
+
+    /// @brief Test random pushes at or above the last popped key mixed with
+    ///        tops and pops come out in order
+    void test_top_interleaved() {
+      radix_heap<unsigned, unsigned> h;
+      std::multiset<unsigned> model;
+      unsigned last = 0;
+      bool ok = true;
+      srand(29);
+      for(size_t i = 0; ok && i < 20000; ++i) {
+        int op = rand() % 3;
+        if(op == 0 || model.empty()) {
+          unsigned k = last + rand() % 1000;
+          h.push(k, k);
+          model.insert(k);
+        }
+        else if(op == 1)
+          ok = h.top().first == *model.begin() &&
+            h.top().second == *model.begin();
+        else {
+          ok = h.top().first == *model.begin();
+          last = *model.begin();
+          model.erase(model.begin());
+          h.pop();
+        }
+        ok = ok && h.size() == model.size();
+      }
+
+      assert_msg(ok, "Top interleaved failed.");
+    }
+
+};
+
+int main() {
+  radix_heap_test rht;
+
+  if(rht.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
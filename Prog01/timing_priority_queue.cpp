@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of priority queue for different heap arities
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "priority_queue.h"
+#include "vector.h"
+
+using namespace std;
+using namespace chrono;
+using mystl::priority_queue;
+using mystl::vector;
+
+/// @brief Sink for popped values, keeps the optimizer from dropping the pops
+volatile int sink;
+
+/// @brief Function to time k pushes followed by k pops
+/// @tparam Arity Arity of heap
+/// @param k Input size
+template<size_t Arity>
+void push_pop_k_times(size_t k) {
+  priority_queue<int, vector<int>, less<int>, Arity> pq;
+  for(size_t i = 0; i < k; ++i)
+    pq.push(rand());
+  for(size_t i = 0; i < k; ++i) {
+    sink = pq.top();
+    pq.pop();
+  }
+}
+
+/// @brief Function to time heapify of k elements followed by k pops
+/// @tparam Arity Arity of heap
+/// @param k Input size
+template<size_t Arity>
+void heapify_pop_k_times(size_t k) {
+  vector<int> v;
+  for(size_t i = 0; i < k; ++i)
+    v.push_back(rand());
+  priority_queue<int, vector<int>, less<int>, Arity> pq(v.begin(), v.end());
+  for(size_t i = 0; i < k; ++i) {
+    sink = pq.top();
+    pq.pop();
+  }
+}
+
+/// @brief Control timing of a single function
+/// @tparam Func Function type
+/// @param f Function taking a single size_t parameter
+/// @param max_size Maximum size of test. For linear - 2^23 is good, for
+///                 quadrati - 2^18 is probably good enough, but its up to you.
+/// @param name Name of function for nice output
+///
+/// Essentially this function outputs timings for powers of 2 from 2 to
+/// max_size. For each timing it repeats the test at least 10 times to ensure
+/// a good average time.
+template<typename Func>
+void time_function(Func f, size_t max_size, string name) {
+  cout << "Function: " << name << endl;
+  cout << setw(15) << "Size" << setw(15) << "Time(sec)" << endl;
+
+  // Loop to control input size
+  for(size_t i = 2; i < max_size; i*=2) {
+    cout << setw(15) << i;
+
+    // create a clock
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+
+    // loop a specific number of times to make the clock tick
+    size_t num_itr = max(size_t(10), max_size / i);
+    for(size_t j = 0; j < num_itr; ++j)
+      f(i);
+
+    // calculate time
+    high_resolution_clock::time_point stop = high_resolution_clock::now();
+    duration<double> diff = duration_cast<duration<double>>(stop - start);
+
+    cout << setw(15) << diff.count() / num_itr << endl;
+  }
+}
+
+/// @brief Main function to time all your functions
+///
+/// The largest size performs 2^22 pushes and 2^22 pops, i.e., ~8.4M heap
+/// operations per run.
+int main() {
+  time_function(push_pop_k_times<2>, pow(2, 23), "Push/pop binary heap");
+  time_function(push_pop_k_times<4>, pow(2, 23), "Push/pop 4-ary heap");
+  time_function(push_pop_k_times<8>, pow(2, 23), "Push/pop 8-ary heap");
+  time_function(heapify_pop_k_times<2>, pow(2, 23), "Heapify/pop binary heap");
+  time_function(heapify_pop_k_times<4>, pow(2, 23), "Heapify/pop 4-ary heap");
+  time_function(heapify_pop_k_times<8>, pow(2, 23), "Heapify/pop 8-ary heap");
+}
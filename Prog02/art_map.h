@@ -0,0 +1,1187 @@
+#ifndef _ART_MAP_H_
+#define _ART_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "node_pool.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Byte encoding of art_map keys
+/// @ingroup MySTL
+/// @tparam Key Key type
+///
+/// byte(k, i) is byte \c i of the encoding of \c k, 0 past its end. Encodings
+/// compare bytewise in the order of Key's operator< and none is a prefix of
+/// another. Specialized for integral types and std::string.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename = void>
+struct art_key;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Integers are encoded big-endian, signed ones with the sign bit
+///        flipped
+/// @ingroup MySTL
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key>
+struct art_key<Key,
+  typename std::enable_if<std::is_integral<Key>::value>::type> {
+    /// @return Byte \c i of the encoding of \c k
+    static unsigned char byte(Key k, size_t i) {
+      typedef typename std::make_unsigned<Key>::type U;
+      U u = U(k);
+      if(std::is_signed<Key>::value)
+        u ^= U(U(1) << (8*sizeof(Key) - 1));
+      return i < sizeof(Key) ? (u >> 8*(sizeof(Key) - 1 - i)) & 0xFF : 0;
+    }
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Strings are encoded as their characters followed by a 0 byte, so
+///        they must not contain '\0'
+/// @ingroup MySTL
+////////////////////////////////////////////////////////////////////////////////
+template<>
+struct art_key<std::string> {
+  /// @return Byte \c i of the encoding of \c k
+  static unsigned char byte(const std::string& k, size_t i) {
+    return i < k.size() ? static_cast<unsigned char>(k[i]) : 0;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Map ADT based on C++ map implemented with an adaptive radix tree
+/// @ingroup MySTL
+/// @tparam Key Key type, encoded by art_key<Key>
+/// @tparam Value Value type
+///
+/// Same interface as map (Leis et al., The Adaptive Radix Tree, ICDE 2013).
+/// An inner node branches on one byte of the key encoding and comes in four
+/// sizes: Node4 and Node16 keep sorted key bytes, searched all at once with an
+/// SSE2 compare in Node16, Node48 indexes 48 children through a 256 byte
+/// table and Node256 holds a child for every byte. Nodes grow and shrink
+/// between the sizes as children come and go. A node stores the bytes all its
+/// keys share (path compression) and a key is kept in a leaf right below the
+/// first node where it differs from all others (lazy expansion), so a lookup
+/// visits at most one node per distinguishing byte and compares the whole key
+/// once, at the leaf. Only the first max_prefix bytes of a prefix are stored,
+/// lookups skip the rest and the leaf comparison catches a mismatch there.
+///
+/// Leaves are also kept in a doubly linked list in key order, so iteration
+/// is a list walk. An erasure only invalidates iterators to the erased
+/// element.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value>
+class art_map {
+
+  struct header;        ///< Forward declare node header class
+  struct link;          ///< Forward declare leaf list link class
+  struct leaf;          ///< Forward declare leaf class
+  struct node;          ///< Forward declare inner node class
+  struct node4;         ///< Forward declare Node4 class
+  struct node16;        ///< Forward declare Node16 class
+  struct node48;        ///< Forward declare Node48 class
+  struct node256;       ///< Forward declare Node256 class
+  template<typename>
+    class art_iterator; ///< Forward declare iterator class
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+    typedef std::pair<const key_type, mapped_type>
+      value_type;              ///< Entry type
+    typedef art_iterator<value_type>
+      iterator;                ///< Bidirectional iterator
+    typedef art_iterator<const value_type>
+      const_iterator;          ///< Const bidirectional iterator
+    typedef std::reverse_iterator<iterator>
+      reverse_iterator;        ///< Reverse bidirectional iterator
+    typedef std::reverse_iterator<const_iterator>
+      const_reverse_iterator;  ///< Const reverse bidirectional iterator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    art_map() : root(nullptr), sz(0) {
+      head.prev = head.next = &head;
+    }
+    /// @brief Copy constructor
+    /// @param m Other map
+    art_map(const art_map& m) : root(nullptr), sz(0) {
+      head.prev = head.next = &head;
+      copy_from(m);
+    }
+    /// @brief Destructor
+    ~art_map() {
+      destroy_leaves();
+    }
+
+    /// @brief Copy assignment
+    /// @param m Other map
+    /// @return Reference to self
+    art_map& operator=(const art_map& m) {
+      if(this != &m) {
+        clear();
+        copy_from(m);
+      }
+      return *this;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Iterators
+    /// @{
+
+    /// @return Iterator to beginning
+    iterator begin() {return iterator(head.next);}
+    /// @return Iterator to end
+    iterator end() {return iterator(&head);}
+    /// @return Iterator to reverse beginning
+    reverse_iterator rbegin() {return reverse_iterator(end());}
+    /// @return Iterator to reverse end
+    reverse_iterator rend() {return reverse_iterator(begin());}
+    /// @return Iterator to beginning
+    const_iterator cbegin() const {return const_iterator(head.next);}
+    /// @return Iterator to end
+    const_iterator cend() const {
+      return const_iterator(const_cast<link*>(&head));
+    }
+    /// @return Iterator to reverse beginning
+    const_reverse_iterator crbegin() const {return const_reverse_iterator(cend());}
+    /// @return Iterator to reverse end
+    const_reverse_iterator crend() const {return const_reverse_iterator(cbegin());}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of map
+    size_t size() const {return sz;}
+    /// @return Does the map contain anything?
+    bool empty() const {return sz == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @param k Input key
+    /// @return Value at given key, inserting a default constructed value if
+    ///         \c k is not found
+    Value& operator[](const Key& k) {
+      return try_emplace(k).first->second;
+    }
+    /// @param k Input key, moved from only if it is inserted
+    /// @return Value at given key
+    Value& operator[](Key&& k) {
+      return try_emplace(std::move(k)).first->second;
+    }
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    Value& at(const Key& k) {
+      leaf* l = finder(k);
+      if(!l)
+        throw std::out_of_range("out of range");
+      return l->value.second;
+    }
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    const Value& at(const Key& k) const {
+      leaf* l = finder(k);
+      if(!l)
+        throw std::out_of_range("out of range");
+      return l->value.second;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Insert element into map
+    /// @param v Key, Value pair
+    /// @return pair of iterator and bool. Iterator pointing to found element or
+    ///         already existing element. bool is true if a new element was
+    ///         inserted and false if it existed.
+    std::pair<iterator, bool> insert(const value_type& v) {
+      return inserter(v.first, v);
+    }
+    /// @brief Insert element constructed from \c args if its key is absent
+    /// @tparam Args Argument types of a value_type constructor
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    template<typename... Args>
+      std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type v(std::forward<Args>(args)...);
+        return inserter(v.first, std::move(v));
+      }
+    /// @brief Insert element with key \c k and value constructed from \c args
+    ///        if \c k is absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam Args Argument types of a Value constructor
+    /// @param k Key
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    template<typename K, typename... Args>
+      std::pair<iterator, bool> try_emplace(K&& k, Args&&... args) {
+        return inserter(k, std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(k)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+      }
+    /// @brief Assign \c obj to the value at \c k, inserting \c k if absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam M Value argument type
+    /// @param k Key
+    /// @param obj Value
+    /// @return pair of iterator and bool. bool is true if a new element was
+    ///         inserted and false if an existing one was assigned.
+    template<typename K, typename M>
+      std::pair<iterator, bool> insert_or_assign(K&& k, M&& obj) {
+        if(leaf* l = finder(k)) {
+          l->value.second = std::forward<M>(obj);
+          return std::make_pair(iterator(l), false);
+        }
+        return try_emplace(std::forward<K>(k), std::forward<M>(obj));
+      }
+    /// @brief Remove element at specified position
+    /// @param position Position
+    /// @return Position of new location of element which was after eliminated
+    ///         one
+    iterator erase(const_iterator position) {
+      link* next = position.l->next;
+      eraser(position->first);
+      return iterator(next);
+    }
+    /// @brief Remove element at specified position
+    /// @param k Key
+    /// @return Number of elements removed (in this case it is at most 1)
+    size_t erase(const Key& k) {
+      return eraser(k);
+    }
+    /// @brief Remove all elements
+    void clear() {
+      destroy_leaves();
+      leaves.release();
+      nodes4.release();
+      nodes16.release();
+      nodes48.release();
+      nodes256.release();
+      head.prev = head.next = &head;
+      root = nullptr;
+      sz = 0;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, end() otherwise
+    iterator find(const Key& k) {
+      leaf* l = finder(k);
+      return l ? iterator(l) : end();
+    }
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, cend() otherwise
+    const_iterator find(const Key& k) const {
+      leaf* l = finder(k);
+      return l ? const_iterator(l) : cend();
+    }
+
+    /// @brief Count elements with specific keys
+    /// @param k Key
+    /// @return Count of elements with key \c k, 0 or 1
+    size_t count(const Key& k) const {
+      return finder(k) ? 1 : 0;
+    }
+
+    /// @param k Key
+    /// @return Iterator to the first element whose key is not less than \c k,
+    ///         end() if there is none
+    iterator lower_bound(const Key& k) {
+      leaf* l = root ? lower(root, 0, k) : nullptr;
+      return l ? iterator(l) : end();
+    }
+
+    /// @param k Key
+    /// @return Iterator to the first element whose key is not less than \c k,
+    ///         cend() if there is none
+    const_iterator lower_bound(const Key& k) const {
+      leaf* l = root ? lower(root, 0, k) : nullptr;
+      return l ? const_iterator(l) : cend();
+    }
+
+    /// @param k Key
+    /// @return Iterator to the first element whose key is greater than \c k,
+    ///         end() if there is none
+    iterator upper_bound(const Key& k) {
+      iterator i = lower_bound(k);
+      if(i != end() && !(k < i->first))
+        ++i;
+      return i;
+    }
+
+    /// @param k Key
+    /// @return Iterator to the first element whose key is greater than \c k,
+    ///         cend() if there is none
+    const_iterator upper_bound(const Key& k) const {
+      const_iterator i = lower_bound(k);
+      if(i != cend() && !(k < i->first))
+        ++i;
+      return i;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    static const size_t max_prefix = 8; ///< Prefix bytes stored in a node
+
+    static const uint8_t leaf_type = 0;    ///< Type of a leaf
+    static const uint8_t node4_type = 1;   ///< Type of a Node4
+    static const uint8_t node16_type = 2;  ///< Type of a Node16
+    static const uint8_t node48_type = 3;  ///< Type of a Node48
+    static const uint8_t node256_type = 4; ///< Type of a Node256
+
+    /// @return Byte \c i of the encoding of \c k
+    static unsigned char byte(const Key& k, size_t i) {
+      return art_key<Key>::byte(k, i);
+    }
+
+    /// @return Is \c n a leaf?
+    static bool is_leaf(const header* n) {return n->type == leaf_type;}
+    /// @return \c n as a leaf
+    static leaf* as_leaf(header* n) {return static_cast<leaf*>(n);}
+    /// @return \c n as an inner node
+    static node* as_node(header* n) {return static_cast<node*>(n);}
+
+    /// @brief Utility for finding a leaf with Key \c k
+    /// @param k Key
+    /// @return Leaf or nullptr if it does not exist
+    ///
+    /// Skips the prefix bytes nodes do not store, the key comparison at the
+    /// leaf covers them.
+    leaf* finder(const Key& k) const {
+      header* n = root;
+      size_t depth = 0;
+      while(n) {
+        if(is_leaf(n))
+          return as_leaf(n)->value.first == k ? as_leaf(n) : nullptr;
+        node* p = as_node(n);
+        size_t stored = std::min(size_t(p->prefix_len), size_t(max_prefix));
+        for(size_t i = 0; i < stored; ++i)
+          if(p->prefix[i] != byte(k, depth + i))
+            return nullptr;
+        depth += p->prefix_len;
+        header** c = find_child(p, byte(k, depth));
+        if(!c)
+          return nullptr;
+        n = *c;
+        ++depth;
+      }
+      return nullptr;
+    }
+
+    /// @brief Insert a leaf with key \c k constructed from \c args unless
+    ///        \c k exists
+    /// @param k Key of the new entry, not used once the leaf is constructed
+    ///        since \c args may move from it
+    /// @param args Arguments of a value_type constructor
+    /// @return pair of iterator and bool as in insert
+    template<typename... Args>
+      std::pair<iterator, bool> inserter(const Key& k, Args&&... args) {
+        header** ref = &root;
+        size_t depth = 0;
+        while(true) {
+          header* n = *ref;
+          if(!n) {
+            leaf* l = new_leaf(std::forward<Args>(args)...);
+            link_before(l, &head);
+            *ref = l;
+            ++sz;
+            return std::make_pair(iterator(l), true);
+          }
+
+          if(is_leaf(n)) {
+            leaf* o = as_leaf(n);
+            if(o->value.first == k)
+              return std::make_pair(iterator(o), false);
+            //lazy expansion ends here, both keys go below a new node
+            //branching on their first differing byte
+            size_t i = depth;
+            while(byte(o->value.first, i) == byte(k, i))
+              ++i;
+            unsigned char c = byte(k, i);
+            unsigned char oc = byte(o->value.first, i);
+            node4* p = new_node4(k, depth, i - depth);
+            leaf* l = new_leaf(std::forward<Args>(args)...);
+            sorted_insert(p, oc, o);
+            sorted_insert(p, c, l);
+            link_before(l, c < oc ? o : o->next);
+            *ref = p;
+            ++sz;
+            return std::make_pair(iterator(l), true);
+          }
+
+          node* p = as_node(n);
+          if(p->prefix_len > 0) {
+            size_t m = prefix_mismatch(p, k, depth);
+            if(m < p->prefix_len) {
+              //split the prefix at the mismatch
+              unsigned char c = byte(k, depth + m);
+              unsigned char pc = prefix_byte(p, depth, m);
+              node4* q = new_node4(k, depth, m);
+              link* succ = c < pc ? min_leaf(p) : max_leaf(p)->next;
+              cut_prefix(p, depth, m + 1);
+              leaf* l = new_leaf(std::forward<Args>(args)...);
+              sorted_insert(q, pc, p);
+              sorted_insert(q, c, l);
+              link_before(l, succ);
+              *ref = q;
+              ++sz;
+              return std::make_pair(iterator(l), true);
+            }
+            depth += p->prefix_len;
+          }
+
+          unsigned char c = byte(k, depth);
+          if(header** child = find_child(p, c)) {
+            ref = child;
+            ++depth;
+            continue;
+          }
+          header* s = next_child(p, c + 1u);
+          link* succ = s ? min_leaf(s) : max_leaf(p)->next;
+          leaf* l = new_leaf(std::forward<Args>(args)...);
+          add_child(ref, p, c, l);
+          link_before(l, succ);
+          ++sz;
+          return std::make_pair(iterator(l), true);
+        }
+      }
+
+    /// @brief Remove the leaf with key \c k
+    /// @param k Key, not used once the leaf is destroyed
+    /// @return Number of elements removed
+    size_t eraser(const Key& k) {
+      header** ref = &root;
+      header** parent_ref = nullptr;
+      node* parent = nullptr;
+      unsigned char pc = 0;
+      size_t depth = 0;
+      while(header* n = *ref) {
+        if(is_leaf(n)) {
+          leaf* l = as_leaf(n);
+          if(!(l->value.first == k))
+            return 0;
+          if(parent)
+            remove_child(parent_ref, parent, pc);
+          else
+            root = nullptr;
+          l->prev->next = l->next;
+          l->next->prev = l->prev;
+          leaves.destroy(l);
+          --sz;
+          return 1;
+        }
+        node* p = as_node(n);
+        size_t stored = std::min(size_t(p->prefix_len), size_t(max_prefix));
+        for(size_t i = 0; i < stored; ++i)
+          if(p->prefix[i] != byte(k, depth + i))
+            return 0;
+        depth += p->prefix_len;
+        pc = byte(k, depth);
+        header** child = find_child(p, pc);
+        if(!child)
+          return 0;
+        parent_ref = ref;
+        parent = p;
+        ref = child;
+        ++depth;
+      }
+      return 0;
+    }
+
+    /// @brief First leaf not less than \c k in the subtree \c n
+    /// @param n Subtree
+    /// @param depth Index of the first byte of the prefix of \c n
+    /// @param k Key
+    /// @return Leaf or nullptr if all keys of the subtree are less than \c k
+    static leaf* lower(header* n, size_t depth, const Key& k) {
+      if(is_leaf(n))
+        return as_leaf(n)->value.first < k ? nullptr : as_leaf(n);
+      node* p = as_node(n);
+      size_t m = prefix_mismatch(p, k, depth);
+      if(m < p->prefix_len)
+        return byte(k, depth + m) < prefix_byte(p, depth, m) ?
+          min_leaf(p) : nullptr;
+      depth += p->prefix_len;
+      unsigned char c = byte(k, depth);
+      if(header** child = find_child(p, c))
+        if(leaf* l = lower(*child, depth + 1, k))
+          return l;
+      header* s = next_child(p, c + 1u);
+      return s ? min_leaf(s) : nullptr;
+    }
+
+    /// @return Number of leading bytes of the prefix of \c p, which starts at
+    ///         byte \c depth, that match \c k
+    static size_t prefix_mismatch(node* p, const Key& k, size_t depth) {
+      size_t stored = std::min(size_t(p->prefix_len), size_t(max_prefix));
+      size_t i = 0;
+      for(; i < stored; ++i)
+        if(p->prefix[i] != byte(k, depth + i))
+          return i;
+      if(p->prefix_len > max_prefix) {
+        const Key& m = min_leaf(p)->value.first;
+        for(; i < p->prefix_len; ++i)
+          if(byte(m, depth + i) != byte(k, depth + i))
+            return i;
+      }
+      return i;
+    }
+
+    /// @return Byte \c i of the prefix of \c p, which starts at byte \c depth,
+    ///         read from a leaf if \c p does not store it
+    static unsigned char prefix_byte(node* p, size_t depth, size_t i) {
+      return i < max_prefix ? p->prefix[i] :
+        byte(min_leaf(p)->value.first, depth + i);
+    }
+
+    /// @brief Drop the first \c n bytes of the prefix of \c p, which starts at
+    ///        byte \c depth
+    static void cut_prefix(node* p, size_t depth, size_t n) {
+      size_t len = p->prefix_len - n;
+      if(p->prefix_len <= max_prefix)
+        std::memmove(p->prefix, p->prefix + n, len);
+      else {
+        const Key& m = min_leaf(p)->value.first;
+        for(size_t i = 0; i < std::min(len, size_t(max_prefix)); ++i)
+          p->prefix[i] = byte(m, depth + n + i);
+      }
+      p->prefix_len = len;
+    }
+
+    /// @return Slot of the child of \c p for byte \c c, nullptr if there is
+    ///         none
+    static header** find_child(node* p, unsigned char c) {
+      switch(p->type) {
+        case node4_type: {
+          node4* n = static_cast<node4*>(p);
+          for(size_t i = 0; i < n->count; ++i)
+            if(n->keys[i] == c)
+              return &n->children[i];
+          return nullptr;
+        }
+        case node16_type: {
+          node16* n = static_cast<node16*>(p);
+#ifdef __SSE2__
+          __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys));
+          unsigned m = _mm_movemask_epi8(
+              _mm_cmpeq_epi8(keys, _mm_set1_epi8(char(c))));
+          m &= (1u << n->count) - 1;
+          return m ? &n->children[__builtin_ctz(m)] : nullptr;
+#else
+          for(size_t i = 0; i < n->count; ++i)
+            if(n->keys[i] == c)
+              return &n->children[i];
+          return nullptr;
+#endif
+        }
+        case node48_type: {
+          node48* n = static_cast<node48*>(p);
+          return n->index[c] ? &n->children[n->index[c] - 1] : nullptr;
+        }
+        default: {
+          node256* n = static_cast<node256*>(p);
+          return n->children[c] ? &n->children[c] : nullptr;
+        }
+      }
+    }
+
+    /// @return Child of \c p for the least byte not less than \c c, nullptr
+    ///         if there is none
+    static header* next_child(node* p, unsigned c) {
+      switch(p->type) {
+        case node4_type:
+          return sorted_next(static_cast<node4*>(p), c);
+        case node16_type:
+          return sorted_next(static_cast<node16*>(p), c);
+        case node48_type: {
+          node48* n = static_cast<node48*>(p);
+          for(; c < 256; ++c)
+            if(n->index[c])
+              return n->children[n->index[c] - 1];
+          return nullptr;
+        }
+        default: {
+          node256* n = static_cast<node256*>(p);
+          for(; c < 256; ++c)
+            if(n->children[c])
+              return n->children[c];
+          return nullptr;
+        }
+      }
+    }
+
+    /// @return Child of \c p for the greatest byte
+    static header* last_child(node* p) {
+      switch(p->type) {
+        case node4_type: {
+          node4* n = static_cast<node4*>(p);
+          return n->children[n->count - 1];
+        }
+        case node16_type: {
+          node16* n = static_cast<node16*>(p);
+          return n->children[n->count - 1];
+        }
+        case node48_type: {
+          node48* n = static_cast<node48*>(p);
+          size_t c = 255;
+          while(!n->index[c])
+            --c;
+          return n->children[n->index[c] - 1];
+        }
+        default: {
+          node256* n = static_cast<node256*>(p);
+          size_t c = 255;
+          while(!n->children[c])
+            --c;
+          return n->children[c];
+        }
+      }
+    }
+
+    /// @return Leaf of the least key in subtree \c n
+    static leaf* min_leaf(header* n) {
+      while(!is_leaf(n))
+        n = next_child(as_node(n), 0);
+      return as_leaf(n);
+    }
+
+    /// @return Leaf of the greatest key in subtree \c n
+    static leaf* max_leaf(header* n) {
+      while(!is_leaf(n))
+        n = last_child(as_node(n));
+      return as_leaf(n);
+    }
+
+    /// @brief Add \c child for byte \c c to \c p, growing \c p into the next
+    ///        larger node type if it is full
+    /// @param ref Slot holding \c p, updated when \c p is replaced
+    /// @param p Node
+    /// @param c Byte
+    /// @param child Child
+    void add_child(header** ref, node* p, unsigned char c, header* child) {
+      switch(p->type) {
+        case node4_type: {
+          node4* n = static_cast<node4*>(p);
+          if(n->count < 4) {
+            sorted_insert(n, c, child);
+            return;
+          }
+          node16* g = make(nodes16, node16_type, n);
+          std::memcpy(g->keys, n->keys, sizeof(n->keys));
+          std::memcpy(g->children, n->children, sizeof(n->children));
+          nodes4.destroy(n);
+          sorted_insert(g, c, child);
+          *ref = g;
+          return;
+        }
+        case node16_type: {
+          node16* n = static_cast<node16*>(p);
+          if(n->count < 16) {
+            sorted_insert(n, c, child);
+            return;
+          }
+          node48* g = make(nodes48, node48_type, n);
+          for(size_t i = 0; i < 16; ++i) {
+            g->index[n->keys[i]] = i + 1;
+            g->children[i] = n->children[i];
+          }
+          nodes16.destroy(n);
+          g->index[c] = 17;
+          g->children[16] = child;
+          ++g->count;
+          *ref = g;
+          return;
+        }
+        case node48_type: {
+          node48* n = static_cast<node48*>(p);
+          if(n->count < 48) {
+            size_t i = 0;
+            while(n->children[i])
+              ++i;
+            n->index[c] = i + 1;
+            n->children[i] = child;
+            ++n->count;
+            return;
+          }
+          node256* g = make(nodes256, node256_type, n);
+          for(size_t b = 0; b < 256; ++b)
+            if(n->index[b])
+              g->children[b] = n->children[n->index[b] - 1];
+          nodes48.destroy(n);
+          g->children[c] = child;
+          ++g->count;
+          *ref = g;
+          return;
+        }
+        default: {
+          node256* n = static_cast<node256*>(p);
+          n->children[c] = child;
+          ++n->count;
+        }
+      }
+    }
+
+    /// @brief Remove the child for byte \c c from \c p, shrinking \c p into
+    ///        the next smaller node type when it gets sparse, or replacing a
+    ///        Node4 with its last child
+    /// @param ref Slot holding \c p, updated when \c p is replaced
+    /// @param p Node
+    /// @param c Byte
+    void remove_child(header** ref, node* p, unsigned char c) {
+      switch(p->type) {
+        case node4_type: {
+          node4* n = static_cast<node4*>(p);
+          sorted_remove(n, c);
+          if(n->count == 1)
+            collapse(ref, n);
+          return;
+        }
+        case node16_type: {
+          node16* n = static_cast<node16*>(p);
+          sorted_remove(n, c);
+          if(n->count == 3) {
+            node4* s = make(nodes4, node4_type, n);
+            std::memcpy(s->keys, n->keys, 3);
+            std::memcpy(s->children, n->children, 3*sizeof(header*));
+            nodes16.destroy(n);
+            *ref = s;
+          }
+          return;
+        }
+        case node48_type: {
+          node48* n = static_cast<node48*>(p);
+          n->children[n->index[c] - 1] = nullptr;
+          n->index[c] = 0;
+          if(--n->count == 12) {
+            node16* s = make(nodes16, node16_type, n);
+            s->count = 0;
+            for(size_t b = 0; b < 256; ++b)
+              if(n->index[b]) {
+                s->keys[s->count] = b;
+                s->children[s->count++] = n->children[n->index[b] - 1];
+              }
+            nodes48.destroy(n);
+            *ref = s;
+          }
+          return;
+        }
+        default: {
+          node256* n = static_cast<node256*>(p);
+          n->children[c] = nullptr;
+          if(--n->count == 37) {
+            node48* s = make(nodes48, node48_type, n);
+            s->count = 0;
+            for(size_t b = 0; b < 256; ++b)
+              if(n->children[b]) {
+                s->children[s->count] = n->children[b];
+                s->index[b] = ++s->count;
+              }
+            nodes256.destroy(n);
+            *ref = s;
+          }
+        }
+      }
+    }
+
+    /// @brief Replace the Node4 \c n, which has one child left, with that
+    ///        child, prepending the prefix of \c n and the child's byte to the
+    ///        child's prefix
+    /// @param ref Slot holding \c n
+    /// @param n Node
+    void collapse(header** ref, node4* n) {
+      header* child = n->children[0];
+      if(!is_leaf(child)) {
+        node* c = as_node(child);
+        unsigned char buf[max_prefix];
+        size_t len = std::min(size_t(n->prefix_len), size_t(max_prefix));
+        std::memcpy(buf, n->prefix, len);
+        if(len < max_prefix)
+          buf[len++] = n->keys[0];
+        size_t more = std::min(size_t(c->prefix_len), max_prefix - len);
+        std::memcpy(buf + len, c->prefix, more);
+        std::memcpy(c->prefix, buf, len + more);
+        c->prefix_len += n->prefix_len + 1;
+      }
+      nodes4.destroy(n);
+      *ref = child;
+    }
+
+    /// @brief Insert \c child for byte \c c into the sorted Node4 or Node16
+    ///        \c n, which has room
+    template<typename N>
+      static void sorted_insert(N* n, unsigned char c, header* child) {
+        size_t i = n->count;
+        for(; i > 0 && n->keys[i - 1] > c; --i) {
+          n->keys[i] = n->keys[i - 1];
+          n->children[i] = n->children[i - 1];
+        }
+        n->keys[i] = c;
+        n->children[i] = child;
+        ++n->count;
+      }
+
+    /// @brief Remove the child for byte \c c from the sorted Node4 or Node16
+    ///        \c n
+    template<typename N>
+      static void sorted_remove(N* n, unsigned char c) {
+        size_t i = 0;
+        while(n->keys[i] != c)
+          ++i;
+        for(--n->count; i < n->count; ++i) {
+          n->keys[i] = n->keys[i + 1];
+          n->children[i] = n->children[i + 1];
+        }
+      }
+
+    /// @return Child of the sorted Node4 or Node16 \c n for the least byte not
+    ///         less than \c c, nullptr if there is none
+    template<typename N>
+      static header* sorted_next(N* n, unsigned c) {
+        for(size_t i = 0; i < n->count; ++i)
+          if(n->keys[i] >= c)
+            return n->children[i];
+        return nullptr;
+      }
+
+    /// @brief Link leaf \c l into the leaf list in front of \c next
+    static void link_before(link* l, link* next) {
+      l->next = next;
+      l->prev = next->prev;
+      next->prev->next = l;
+      next->prev = l;
+    }
+
+    /// @return New leaf holding an entry constructed from \c args
+    template<typename... Args>
+      leaf* new_leaf(Args&&... args) {
+        leaf* l = leaves.create(std::forward<Args>(args)...);
+        l->type = leaf_type;
+        return l;
+      }
+
+    /// @return New empty Node4 whose prefix is the \c len bytes of \c k from
+    ///         byte \c depth on
+    node4* new_node4(const Key& k, size_t depth, size_t len) {
+      node4* n = nodes4.create();
+      n->type = node4_type;
+      n->prefix_len = len;
+      for(size_t i = 0; i < std::min(len, size_t(max_prefix)); ++i)
+        n->prefix[i] = byte(k, depth + i);
+      return n;
+    }
+
+    /// @return New zeroed node of type \c type with the count and prefix of
+    ///         \c from
+    template<typename N>
+      static N* make(node_pool<N>& pool, uint8_t type, const node* from) {
+        N* n = pool.create();
+        n->type = type;
+        n->count = from->count;
+        n->prefix_len = from->prefix_len;
+        std::memcpy(n->prefix, from->prefix, max_prefix);
+        return n;
+      }
+
+    /// @brief Copy the tree of \c m into this empty map
+    void copy_from(const art_map& m) {
+      link* tail = &head;
+      if(m.root)
+        root = copy(m.root, tail);
+      tail->next = &head;
+      head.prev = tail;
+      sz = m.sz;
+    }
+
+    /// @brief Copy the subtree \c n, appending its leaves to the leaf list
+    ///        after \c tail in key order
+    /// @param n Root of subtree
+    /// @param tail Last leaf copied so far, updated
+    /// @return Root of the copy
+    ///
+    /// Recursion depth is the height of the tree, at most one level per key
+    /// byte.
+    header* copy(header* n, link*& tail) {
+      switch(n->type) {
+        case leaf_type: {
+          leaf* l = new_leaf(as_leaf(n)->value);
+          l->prev = tail;
+          tail->next = l;
+          tail = l;
+          return l;
+        }
+        case node4_type: {
+          node4* c = nodes4.create(*static_cast<node4*>(n));
+          for(size_t i = 0; i < c->count; ++i)
+            c->children[i] = copy(c->children[i], tail);
+          return c;
+        }
+        case node16_type: {
+          node16* c = nodes16.create(*static_cast<node16*>(n));
+          for(size_t i = 0; i < c->count; ++i)
+            c->children[i] = copy(c->children[i], tail);
+          return c;
+        }
+        case node48_type: {
+          node48* c = nodes48.create(*static_cast<node48*>(n));
+          for(size_t b = 0; b < 256; ++b)
+            if(c->index[b])
+              c->children[c->index[b] - 1] =
+                copy(c->children[c->index[b] - 1], tail);
+          return c;
+        }
+        default: {
+          node256* c = nodes256.create(*static_cast<node256*>(n));
+          for(size_t b = 0; b < 256; ++b)
+            if(c->children[b])
+              c->children[b] = copy(c->children[b], tail);
+          return c;
+        }
+      }
+    }
+
+    /// @brief Run the destructor of every entry, leaving node storage to the
+    ///        pools
+    void destroy_leaves() {
+      if(std::is_trivially_destructible<value_type>::value)
+        return;
+      for(link* l = head.next; l != &head; l = l->next)
+        static_cast<leaf*>(l)->value.~value_type();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    node_pool<leaf> leaves;      ///< Storage of leaves, must outlive root
+    node_pool<node4> nodes4;     ///< Storage of Node4s
+    node_pool<node16> nodes16;   ///< Storage of Node16s
+    node_pool<node48> nodes48;   ///< Storage of Node48s
+    node_pool<node256> nodes256; ///< Storage of Node256s
+    header* root;                ///< Root, nullptr for an empty map
+    size_t sz;                   ///< Number of entries
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Link of the leaf list, also its sentinel, which is end()
+    ////////////////////////////////////////////////////////////////////////////
+    struct link {
+      link* prev; ///< Previous leaf, or the sentinel
+      link* next; ///< Next leaf, or the sentinel
+    };
+
+    link head;                   ///< Sentinel of the leaf list
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Start of leaves and inner nodes
+    ////////////////////////////////////////////////////////////////////////////
+    struct header {
+      uint8_t type; ///< Node type
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Leaf holding one entry
+    ////////////////////////////////////////////////////////////////////////////
+    struct leaf : public header, public link {
+      /// @brief Constructor
+      /// @param args Arguments of a value_type constructor
+      template<typename... Args>
+        leaf(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+      value_type value; ///< Map entry (Key, Value) pair
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Start of inner nodes, the bytes shared by all keys below
+    ////////////////////////////////////////////////////////////////////////////
+    struct node : public header {
+      uint16_t count;                   ///< Number of children
+      uint32_t prefix_len;              ///< Length of the prefix
+      unsigned char prefix[max_prefix]; ///< First bytes of the prefix
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Node of up to 4 children, key bytes sorted
+    ////////////////////////////////////////////////////////////////////////////
+    struct node4 : public node {
+      unsigned char keys[4]; ///< Key bytes
+      header* children[4];   ///< Children
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Node of up to 16 children, key bytes sorted
+    ////////////////////////////////////////////////////////////////////////////
+    struct node16 : public node {
+      unsigned char keys[16]; ///< Key bytes
+      header* children[16];   ///< Children
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Node of up to 48 children, indexed by key byte
+    ////////////////////////////////////////////////////////////////////////////
+    struct node48 : public node {
+      unsigned char index[256]; ///< 1 + slot of each byte's child, 0 if none
+      header* children[48];     ///< Children, nullptr for a free slot
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Node with a child slot for every key byte
+    ////////////////////////////////////////////////////////////////////////////
+    struct node256 : public node {
+      header* children[256]; ///< Children, nullptr if none
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Bidirectional iterator for an adaptive radix tree, walks the
+    ///        leaf list
+    /// @tparam U value_type of map
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename U>
+      class art_iterator : public std::iterator<std::bidirectional_iterator_tag, U> {
+        public:
+          //////////////////////////////////////////////////////////////////////
+          /// @name Constructors
+          /// @{
+
+          /// @brief Construction
+          /// @param v Leaf link, or the sentinel for end()
+          art_iterator(link* v = nullptr) : l(v) {}
+
+          /// @brief Copy construction
+          /// @param o Other iterator
+          art_iterator(const art_iterator<typename std::remove_const<U>::type>& o) :
+            l(o.l) {}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Comparison
+          /// @{
+
+          /// @brief Equality comparison
+          /// @param o Iterator
+          bool operator==(const art_iterator& o) const {return l == o.l;}
+          /// @brief Inequality comparison
+          /// @param o Iterator
+          bool operator!=(const art_iterator& o) const {return l != o.l;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Dereference
+          /// @{
+
+          /// @brief Dereference operator
+          U& operator*() const {return static_cast<leaf*>(l)->value;}
+          /// @brief Dereference operator
+          U* operator->() const {return &static_cast<leaf*>(l)->value;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Advancement
+          /// @{
+
+          /// @brief Pre-increment
+          art_iterator& operator++() {l = l->next; return *this;}
+          /// @brief Post-increment
+          art_iterator operator++(int) {art_iterator tmp(*this); ++(*this); return tmp;}
+          /// @brief Pre-decrement
+          art_iterator& operator--() {l = l->prev; return *this;}
+          /// @brief Post-decrement
+          art_iterator operator--(int) {art_iterator tmp(*this); --(*this); return tmp;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+        private:
+          link* l; ///< Leaf link
+
+          friend class art_map;
+      };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+};
+
+}
+
+#endif
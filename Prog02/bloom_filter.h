@@ -0,0 +1,233 @@
+#ifndef _BLOOM_FILTER_H_
+#define _BLOOM_FILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Blocked Bloom filter, a set that may answer false positives but
+///        never false negatives
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Hash Hash function object type
+///
+/// The bits are split into cache line sized blocks of 16 32-bit words. A key
+/// picks one block with its hash and sets 8 bits in it, one in word i or
+/// i + 8 for each i < 8, each chosen by multiplying the hash by a different
+/// odd constant. A lookup touches a single cache line, its 8 bits are
+/// gathered into a mask and tested against the block a whole vector at a
+/// time (SSE2 when available). Under 1% false positives at the sizing of 12
+/// bits per key. Keys cannot be removed, the filter is cleared and refilled
+/// instead.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, class Hash = std::hash<Key>>
+class bloom_filter {
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor, sized for \c n keys
+    /// @param n Expected number of keys
+    /// @param h Hash function
+    bloom_filter(size_t n = 0, const Hash& h = Hash()) :
+      mem(nullptr), blocks(nullptr), nblocks(0), sz(0), hash(h) {
+      reset(n);
+    }
+    /// @brief Copy constructor
+    /// @param f Other filter
+    bloom_filter(const bloom_filter& f) :
+      mem(nullptr), blocks(nullptr), nblocks(0), sz(0), hash(f.hash) {
+      copy(f);
+    }
+    /// @brief Destructor
+    ~bloom_filter() {
+      ::operator delete(mem);
+    }
+
+    /// @brief Copy assignment
+    /// @param f Other filter
+    /// @return Reference to self
+    bloom_filter& operator=(const bloom_filter& f) {
+      if(this != &f) {
+        hash = f.hash;
+        copy(f);
+      }
+      return *this;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Number of keys inserted since the last reset or clear
+    size_t size() const {return sz;}
+    /// @return Number of keys the filter is sized for
+    size_t capacity() const {return nblocks*block_bits/bits_per_key;}
+    /// @return Have more keys been inserted than the filter is sized for?
+    bool full() const {return sz > capacity();}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Add key \c k
+    /// @param k Key
+    void insert(const Key& k) {
+      size_t h = mix(k);
+      uint32_t* b = blocks[block_of(h)].words;
+      for(size_t i = 0; i < probes; ++i) {
+        uint32_t p = uint32_t(h)*salt(i);
+        b[i + (p >> 26 & 1)*probes] |= uint32_t(1) << (p >> 27);
+      }
+      ++sz;
+    }
+    /// @brief Remove all keys, keeping the size
+    void clear() {
+      std::memset(blocks, 0, nblocks*sizeof(block));
+      sz = 0;
+    }
+    /// @brief Remove all keys and resize for \c n keys
+    /// @param n Expected number of keys
+    void reset(size_t n) {
+      size_t c = 1;
+      while(c*block_bits < n*bits_per_key)
+        c *= 2;
+      if(c != nblocks)
+        allocate(c);
+      clear();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @param k Key
+    /// @return Might \c k have been inserted? Always true if it was
+    bool may_contain(const Key& k) const {
+      size_t h = mix(k);
+      const block& b = blocks[block_of(h)];
+      block mask = {};
+      for(size_t i = 0; i < probes; ++i) {
+        uint32_t p = uint32_t(h)*salt(i);
+        mask.words[i + (p >> 26 & 1)*probes] |= uint32_t(1) << (p >> 27);
+      }
+#ifdef __SSE2__
+      __m128i missing = _mm_setzero_si128();
+      for(size_t i = 0; i < block_words; i += 4) {
+        __m128i m = _mm_load_si128(
+            reinterpret_cast<const __m128i*>(mask.words + i));
+        __m128i w = _mm_load_si128(
+            reinterpret_cast<const __m128i*>(b.words + i));
+        missing = _mm_or_si128(missing, _mm_andnot_si128(w, m));
+      }
+      return _mm_movemask_epi8(
+          _mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+#else
+      uint32_t missing = 0;
+      for(size_t i = 0; i < block_words; ++i)
+        missing |= mask.words[i] & ~b.words[i];
+      return missing == 0;
+#endif
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    static const size_t block_words = 16;   ///< 32-bit words of a block
+    static const size_t block_bits = 512;   ///< Bits of a block
+    static const size_t probes = 8;         ///< Bits set per key
+    static const size_t bits_per_key = 12;  ///< Bits per key at capacity
+
+    /// @return Odd constant of probe \c i
+    static uint32_t salt(size_t i) {
+      static const uint32_t salts[probes] = {0x47b6137bU, 0x44974d91U,
+        0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U,
+        0x5c6bfb31U};
+      return salts[i];
+    }
+
+    /// @brief Mix the user hash so that the block index and the bits depend
+    ///        on every bit of it
+    size_t mix(const Key& k) const {
+      const unsigned long long golden = 0x9E3779B97F4A7C15ull;
+      size_t h = hash(k)*static_cast<size_t>(golden);
+      return h ^ (h >> (sizeof(size_t)*4));
+    }
+    /// @return Block of mixed hash \c h, from the bits the probes do not use
+    size_t block_of(size_t h) const {
+      return (h >> (sizeof(size_t)*4)) & (nblocks - 1);
+    }
+
+    /// @brief Replace the blocks with \c c uninitialized ones, aligned to
+    ///        their size
+    void allocate(size_t c) {
+      ::operator delete(mem);
+      mem = ::operator new((c + 1)*sizeof(block));
+      uintptr_t a = reinterpret_cast<uintptr_t>(mem);
+      blocks = reinterpret_cast<block*>(
+          (a + sizeof(block) - 1) & ~uintptr_t(sizeof(block) - 1));
+      nblocks = c;
+    }
+
+    /// @brief Copy the blocks and count of \c f
+    void copy(const bloom_filter& f) {
+      if(nblocks != f.nblocks)
+        allocate(f.nblocks);
+      std::memcpy(blocks, f.blocks, nblocks*sizeof(block));
+      sz = f.sz;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Cache line of filter bits
+    ////////////////////////////////////////////////////////////////////////////
+    struct alignas(64) block {
+      uint32_t words[block_words]; ///< Bits
+    };
+
+    void* mem;      ///< Allocation holding the blocks
+    block* blocks;  ///< Blocks, a power of two of them
+    size_t nblocks; ///< Number of blocks
+    size_t sz;      ///< Number of keys inserted
+    Hash hash;      ///< Hash function
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
@@ -0,0 +1,894 @@
+#ifndef _BTREE_MAP_H_
+#define _BTREE_MAP_H_
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "node_pool.h"
+
+namespace mystl {
+
+/// @param entry_size Size of a map entry
+/// @return Default B-tree order: the even number of children whose entries
+///         fill about four cache lines, at least 4
+constexpr size_t btree_default_order(size_t entry_size) {
+  return 256/entry_size < 4 ? 4 : (256/entry_size) & ~size_t(1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Map ADT based on C++ map implemented with a B-tree
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Value Value type
+/// @tparam Order Maximum number of children of a node, must be even and at
+///         least 4. A node holds between Order/2 - 1 and Order - 1 entries,
+///         except for the root.
+///
+/// Same interface as map. The entries of a node are stored contiguously and
+/// searched with a branchless binary search, so a lookup touches one node,
+/// i.e., a few adjacent cache lines, per level instead of one node per key
+/// comparison. Leaves carry no child pointers. Insertion splits full nodes
+/// and erasure refills minimal nodes on the way down (Cormen et al., Ch. 18),
+/// so neither ever has to walk back up. Any insertion or erasure invalidates
+/// all iterators.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value,
+  size_t Order = btree_default_order(sizeof(std::pair<const Key, Value>))>
+class btree_map {
+
+  static_assert(Order >= 4 && Order % 2 == 0,
+      "btree_map requires an even order of at least 4");
+
+  struct node;          ///< Forward declare node class
+  struct inner_node;    ///< Forward declare inner node class
+  template<typename>
+    class btree_iterator; ///< Forward declare iterator class
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+    typedef std::pair<const key_type, mapped_type>
+      value_type;              ///< Entry type
+    typedef btree_iterator<value_type>
+      iterator;                ///< Bidirectional iterator
+    typedef btree_iterator<const value_type>
+      const_iterator;          ///< Const bidirectional iterator
+    typedef std::reverse_iterator<iterator>
+      reverse_iterator;        ///< Reverse bidirectional iterator
+    typedef std::reverse_iterator<const_iterator>
+      const_reverse_iterator;  ///< Const reverse bidirectional iterator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    btree_map() : root(new_leaf()), sz(0) {}
+    /// @brief Copy constructor
+    /// @param m Other map
+    btree_map(const btree_map& m) : root(copy(m.root, nullptr)), sz(m.sz) {}
+    /// @brief Destructor
+    ~btree_map() {
+      destroy_values(root);
+    }
+
+    /// @brief Copy assignment
+    /// @param m Other map
+    /// @return Reference to self
+    btree_map& operator=(const btree_map& m) {
+      if(this != &m) {
+        clear();
+        destroy_node(root);
+        root = copy(m.root, nullptr);
+        sz = m.sz;
+      }
+      return *this;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Iterators
+    /// @{
+
+    /// @return Iterator to beginning
+    iterator begin() {return iterator(leftmost(), 0);}
+    /// @return Iterator to end
+    iterator end() {node* n = rightmost(); return iterator(n, n->count);}
+    /// @return Iterator to reverse beginning
+    reverse_iterator rbegin() {return reverse_iterator(end());}
+    /// @return Iterator to reverse end
+    reverse_iterator rend() {return reverse_iterator(begin());}
+    /// @return Iterator to beginning
+    const_iterator cbegin() const {return const_iterator(leftmost(), 0);}
+    /// @return Iterator to end
+    const_iterator cend() const {
+      node* n = rightmost();
+      return const_iterator(n, n->count);
+    }
+    /// @return Iterator to reverse beginning
+    const_reverse_iterator crbegin() const {return const_reverse_iterator(cend());}
+    /// @return Iterator to reverse end
+    const_reverse_iterator crend() const {return const_reverse_iterator(cbegin());}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of map
+    size_t size() const {return sz;}
+    /// @return Does the map contain anything?
+    bool empty() const {return sz == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @param k Input key
+    /// @return Value at given key, inserting a default constructed value if
+    ///         \c k is not found
+    Value& operator[](const Key& k) {
+      return try_emplace(k).first->second;
+    }
+    /// @param k Input key, moved from only if it is inserted
+    /// @return Value at given key
+    Value& operator[](Key&& k) {
+      return try_emplace(std::move(k)).first->second;
+    }
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    Value& at(const Key& k) {
+      iterator it = find(k);
+      if(it == end())
+        throw std::out_of_range("out of range");
+      return it->second;
+    }
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    const Value& at(const Key& k) const {
+      const_iterator it = find(k);
+      if(it == cend())
+        throw std::out_of_range("out of range");
+      return it->second;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Insert element into map
+    /// @param v Key, Value pair
+    /// @return pair of iterator and bool. Iterator pointing to found element or
+    ///         already existing element. bool is true if a new element was
+    ///         inserted and false if it existed.
+    std::pair<iterator, bool> insert(const value_type& v) {
+      return inserter(v.first, v);
+    }
+    /// @brief Insert element constructed from \c args if its key is absent
+    /// @tparam Args Argument types of a value_type constructor
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    template<typename... Args>
+      std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type v(std::forward<Args>(args)...);
+        return inserter(v.first, std::move(v));
+      }
+    /// @brief Insert element with key \c k and value constructed from \c args
+    ///        if \c k is absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam Args Argument types of a Value constructor
+    /// @param k Key
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    template<typename K, typename... Args>
+      std::pair<iterator, bool> try_emplace(K&& k, Args&&... args) {
+        return inserter(k, std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(k)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+      }
+    /// @brief Assign \c obj to the value at \c k, inserting \c k if absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam M Value argument type
+    /// @param k Key
+    /// @param obj Value
+    /// @return pair of iterator and bool. bool is true if a new element was
+    ///         inserted and false if an existing one was assigned.
+    template<typename K, typename M>
+      std::pair<iterator, bool> insert_or_assign(K&& k, M&& obj) {
+        iterator i = find(k);
+        if(i != end()) {
+          i->second = std::forward<M>(obj);
+          return std::make_pair(i, false);
+        }
+        return try_emplace(std::forward<K>(k), std::forward<M>(obj));
+      }
+    /// @brief Remove element at specified position
+    /// @param position Position
+    /// @return Position of new location of element which was after eliminated
+    ///         one
+    iterator erase(const_iterator position) {
+      const_iterator next = position;
+      if(++next == cend()) {
+        erase(position->first);
+        return end();
+      }
+      Key k = next->first;
+      erase(position->first);
+      return find(k);
+    }
+    /// @brief Remove element at specified position
+    /// @param k Key
+    /// @return Number of elements removed (in this case it is at most 1)
+    size_t erase(const Key& k) {
+      if(!count(k))
+        return 0;
+      eraser(k);
+      return 1;
+    }
+    /// @brief Remove all elements
+    void clear() {
+      destroy_values(root);
+      leaves.release();
+      inners.release();
+      root = new_leaf();
+      sz = 0;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, end() otherwise
+    iterator find(const Key& k) {
+      std::pair<node*, size_t> p = finder(k);
+      return p.first ? iterator(p.first, p.second) : end();
+    }
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, cend() otherwise
+    const_iterator find(const Key& k) const {
+      std::pair<node*, size_t> p = finder(k);
+      return p.first ? const_iterator(p.first, p.second) : cend();
+    }
+
+    /// @brief Count elements with specific keys
+    /// @param k Key
+    /// @return Count of elements with key \c k, 0 or 1
+    size_t count(const Key& k) const {
+      return finder(k).first ? 1 : 0;
+    }
+
+    /// @brief Search the container for the keys of a range
+    /// @tparam ForwardIterator Forward iterator over keys
+    /// @tparam OutputIterator Output iterator taking iterators
+    /// @param first Start of keys
+    /// @param last End of keys
+    /// @param out Receives for each key an iterator to its element, or end()
+    /// @return \c out past the last written iterator
+    ///
+    /// Lookups proceed in groups of batch_width, a level of every lookup of
+    /// the group per round, each prefetching the cache lines of the node it
+    /// moves to, so the misses of a group overlap.
+    template<typename ForwardIterator, typename OutputIterator>
+      OutputIterator find_batch(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) {
+        return batch_finder<iterator>(first, last, out);
+      }
+    /// @brief Search the container for the keys of a range
+    /// @tparam ForwardIterator Forward iterator over keys
+    /// @tparam OutputIterator Output iterator taking const iterators
+    /// @param first Start of keys
+    /// @param last End of keys
+    /// @param out Receives for each key an iterator to its element, or cend()
+    /// @return \c out past the last written iterator
+    template<typename ForwardIterator, typename OutputIterator>
+      OutputIterator find_batch(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) const {
+        return batch_finder<const_iterator>(first, last, out);
+      }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    static const size_t max_entries = Order - 1;   ///< Entries of a full node
+    static const size_t min_entries = Order/2 - 1; ///< Entries of a minimal
+                                                   ///< non-root node
+
+    /// @return Child \c i of inner node \c n
+    static node*& child(node* n, size_t i) {
+      return static_cast<inner_node*>(n)->children[i];
+    }
+
+    /// @brief Index of the first entry of \c n whose key is not less than \c k
+    /// @param n Node
+    /// @param k Key
+    ///
+    /// Branchless binary search, the comparison selects the next base with a
+    /// conditional move instead of a jump.
+    static size_t lower(const node* n, const Key& k) {
+      size_t len = n->count;
+      if(len == 0)
+        return 0;
+      size_t base = 0;
+      while(len > 1) {
+        size_t half = len/2;
+        base = n->key(base + half) < k ? base + half : base;
+        len -= half;
+      }
+      return base + (n->key(base) < k);
+    }
+
+    /// @brief Utility for finding an entry with Key \c k
+    /// @param k Key
+    /// @return Node and index of the entry, or nullptr if it does not exist
+    std::pair<node*, size_t> finder(const Key& k) const {
+      node* n = root;
+      while(true) {
+        size_t i = lower(n, k);
+        if(i < n->count && !(k < n->key(i)))
+          return std::make_pair(n, i);
+        if(n->leaf)
+          return std::make_pair(nullptr, 0);
+        n = child(n, i);
+      }
+    }
+
+    static const size_t batch_width = 16; ///< Lookups in flight in find_batch
+
+    /// @brief Prefetch the header and entries of node \c n
+    static void prefetch(const node* n) {
+      const char* p = reinterpret_cast<const char*>(n);
+      for(size_t b = 0; b < sizeof(node); b += 64)
+        __builtin_prefetch(p + b);
+    }
+
+    /// @brief Utility for find_batch
+    /// @tparam It Iterator type to write
+    template<typename It, typename ForwardIterator, typename OutputIterator>
+      OutputIterator batch_finder(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) const {
+        ForwardIterator keys[batch_width];
+        node* cur[batch_width];   //next node of each lookup, null when done
+        node* found[batch_width]; //node of each result, null if missing
+        size_t index[batch_width];
+        node* end = rightmost();
+        while(first != last) {
+          size_t g = 0;
+          for(; g < batch_width && first != last; ++g, ++first) {
+            keys[g] = first;
+            cur[g] = root;
+            found[g] = nullptr;
+          }
+          for(bool active = true; active;) {
+            active = false;
+            for(size_t i = 0; i < g; ++i) {
+              node* n = cur[i];
+              if(!n)
+                continue;
+              size_t j = lower(n, *keys[i]);
+              if(j < n->count && !(*keys[i] < n->key(j))) {
+                found[i] = n;
+                index[i] = j;
+                n = nullptr;
+              }
+              else if(n->leaf)
+                n = nullptr;
+              else {
+                n = child(n, j);
+                prefetch(n);
+                active = true;
+              }
+              cur[i] = n;
+            }
+          }
+          for(size_t i = 0; i < g; ++i)
+            *out++ = found[i] ? It(found[i], index[i]) : It(end, end->count);
+        }
+        return out;
+      }
+
+    /// @brief Insert an entry with key \c k constructed from \c args unless
+    ///        \c k exists
+    /// @param k Key of the new entry
+    /// @param args Arguments of a value_type constructor
+    /// @return pair of iterator and bool as in insert
+    ///
+    /// Full nodes are split on the way down, so the leaf always has room and
+    /// splits never propagate upwards.
+    template<typename... Args>
+      std::pair<iterator, bool> inserter(const Key& k, Args&&... args) {
+        if(root->count == max_entries) {
+          node* r = new_inner();
+          child(r, 0) = root;
+          root->parent = r;
+          root->pos = 0;
+          root = r;
+          split_child(r, 0);
+        }
+        node* n = root;
+        while(true) {
+          size_t i = lower(n, k);
+          if(i < n->count && !(k < n->key(i)))
+            return std::make_pair(iterator(n, i), false);
+          if(n->leaf) {
+            shift_right(n, i);
+            ::new(n->slot(i)) value_type(std::forward<Args>(args)...);
+            ++n->count;
+            ++sz;
+            return std::make_pair(iterator(n, i), true);
+          }
+          if(child(n, i)->count == max_entries) {
+            split_child(n, i);
+            if(n->key(i) < k)
+              ++i;
+            else if(!(k < n->key(i)))
+              return std::make_pair(iterator(n, i), false);
+          }
+          n = child(n, i);
+        }
+      }
+
+    /// @brief Remove the entry with key \c k, which must exist
+    /// @param k Key
+    ///
+    /// Every node the search descends into is first given at least
+    /// min_entries + 1 entries by borrowing from a sibling or merging with
+    /// it, so the removal never underflows a node.
+    void eraser(const Key& k) {
+      node* n = root;
+      Key target = k;
+      while(true) {
+        size_t i = lower(n, target);
+        bool found = i < n->count && !(target < n->key(i));
+        if(found && n->leaf) {
+          n->entry(i).~value_type();
+          shift_left(n, i);
+          --n->count;
+          --sz;
+          break;
+        }
+        if(found) {
+          node* y = child(n, i);
+          node* z = child(n, i + 1);
+          if(y->count > min_entries) {
+            //replace with the predecessor, then remove it from y
+            node* p = y;
+            while(!p->leaf) p = child(p, p->count);
+            target = p->key(p->count - 1);
+            replace_entry(n, i, p->entry(p->count - 1));
+            n = y;
+          }
+          else if(z->count > min_entries) {
+            //replace with the successor, then remove it from z
+            node* s = z;
+            while(!s->leaf) s = child(s, 0);
+            target = s->key(0);
+            replace_entry(n, i, s->entry(0));
+            n = z;
+          }
+          else
+            n = merge_children(n, i);
+          continue;
+        }
+        node* c = child(n, i);
+        if(c->count == min_entries) {
+          if(i > 0 && child(n, i - 1)->count > min_entries)
+            rotate_right(n, i - 1);
+          else if(i < n->count && child(n, i + 1)->count > min_entries)
+            rotate_left(n, i);
+          else if(i < n->count)
+            c = merge_children(n, i);
+          else
+            c = merge_children(n, i - 1);
+        }
+        n = c;
+      }
+      if(root->count == 0 && !root->leaf) {
+        node* r = root;
+        root = child(r, 0);
+        root->parent = nullptr;
+        destroy_node(r);
+      }
+    }
+
+    /// @brief Split the full child \c i of \c p, moving its median entry into
+    ///        \c p
+    /// @param p Non-full inner node
+    /// @param i Index of full child
+    void split_child(node* p, size_t i) {
+      const size_t t = Order/2;
+      node* c = child(p, i);
+      node* s = c->leaf ? new_leaf() : new_inner();
+      for(size_t j = 0; j < t - 1; ++j)
+        move_entry(s, j, c, j + t);
+      if(!c->leaf)
+        for(size_t j = 0; j < t; ++j)
+          set_child(s, j, child(c, j + t));
+      s->count = t - 1;
+      shift_right(p, i);
+      move_entry(p, i, c, t - 1);
+      c->count = t - 1;
+      for(size_t j = p->count + 1; j > i + 1; --j)
+        set_child(p, j, child(p, j - 1));
+      set_child(p, i + 1, s);
+      ++p->count;
+    }
+
+    /// @brief Merge child \c i + 1 of \c p and entry \c i of \c p into child
+    ///        \c i
+    /// @param p Inner node
+    /// @param i Index of entry between the two children
+    /// @return Merged child
+    node* merge_children(node* p, size_t i) {
+      node* y = child(p, i);
+      node* z = child(p, i + 1);
+      move_entry(y, y->count, p, i);
+      for(size_t j = 0; j < z->count; ++j)
+        move_entry(y, y->count + 1 + j, z, j);
+      if(!y->leaf)
+        for(size_t j = 0; j <= z->count; ++j)
+          set_child(y, y->count + 1 + j, child(z, j));
+      y->count += z->count + 1;
+      shift_left(p, i);
+      for(size_t j = i + 1; j < p->count; ++j)
+        set_child(p, j, child(p, j + 1));
+      --p->count;
+      z->count = 0;
+      destroy_node(z);
+      return y;
+    }
+
+    /// @brief Move the last entry of child \c i of \c p up into \c p and entry
+    ///        \c i of \c p down to the front of child \c i + 1
+    void rotate_right(node* p, size_t i) {
+      node* l = child(p, i);
+      node* c = child(p, i + 1);
+      shift_right(c, 0);
+      move_entry(c, 0, p, i);
+      move_entry(p, i, l, l->count - 1);
+      if(!c->leaf) {
+        for(size_t j = c->count + 1; j > 0; --j)
+          set_child(c, j, child(c, j - 1));
+        set_child(c, 0, child(l, l->count));
+      }
+      ++c->count;
+      --l->count;
+    }
+
+    /// @brief Move the first entry of child \c i + 1 of \c p up into \c p and
+    ///        entry \c i of \c p down to the back of child \c i
+    void rotate_left(node* p, size_t i) {
+      node* c = child(p, i);
+      node* r = child(p, i + 1);
+      move_entry(c, c->count, p, i);
+      move_entry(p, i, r, 0);
+      shift_left(r, 0);
+      if(!c->leaf) {
+        set_child(c, c->count + 1, child(r, 0));
+        for(size_t j = 0; j < r->count; ++j)
+          set_child(r, j, child(r, j + 1));
+      }
+      ++c->count;
+      --r->count;
+    }
+
+    /// @brief Open a hole at entry \c i of \c n by moving entries i.. right
+    static void shift_right(node* n, size_t i) {
+      for(size_t j = n->count; j > i; --j)
+        move_entry(n, j, n, j - 1);
+    }
+
+    /// @brief Close the hole at entry \c i of \c n by moving entries i+1..
+    ///        left
+    static void shift_left(node* n, size_t i) {
+      for(size_t j = i; j + 1 < n->count; ++j)
+        move_entry(n, j, n, j + 1);
+    }
+
+    /// @brief Move construct entry \c j of \c to from entry \c i of \c from
+    ///        and destroy the source, leaving a hole
+    static void move_entry(node* to, size_t j, node* from, size_t i) {
+      ::new(to->slot(j)) value_type(std::move(from->entry(i)));
+      from->entry(i).~value_type();
+    }
+
+    /// @brief Replace entry \c i of \c n by moving from \c v, whose key
+    ///        stays intact for its later removal
+    static void replace_entry(node* n, size_t i, value_type& v) {
+      n->entry(i).~value_type();
+      ::new(n->slot(i)) value_type(std::move(v));
+    }
+
+    /// @brief Make \c c child \c i of \c p
+    static void set_child(node* p, size_t i, node* c) {
+      child(p, i) = c;
+      c->parent = p;
+      c->pos = i;
+    }
+
+    /// @return Leftmost leaf
+    node* leftmost() const {
+      node* n = root;
+      while(!n->leaf) n = child(n, 0);
+      return n;
+    }
+
+    /// @return Rightmost leaf
+    node* rightmost() const {
+      node* n = root;
+      while(!n->leaf) n = child(n, n->count);
+      return n;
+    }
+
+    /// @return New empty leaf
+    node* new_leaf() {
+      node* n = leaves.create();
+      n->parent = nullptr;
+      n->pos = n->count = 0;
+      n->leaf = true;
+      return n;
+    }
+
+    /// @return New empty inner node
+    node* new_inner() {
+      inner_node* n = inners.create();
+      n->parent = nullptr;
+      n->pos = n->count = 0;
+      n->leaf = false;
+      return n;
+    }
+
+    /// @brief Return an emptied node to its pool
+    void destroy_node(node* n) {
+      if(n->leaf)
+        leaves.destroy(n);
+      else
+        inners.destroy(static_cast<inner_node*>(n));
+    }
+
+    /// @brief Copy the subtree rooted at \c n
+    /// @param n Root of subtree
+    /// @param parent Parent of the copy
+    /// @return Root of the copy
+    ///
+    /// Recursion depth is the height of the tree, i.e., O(log n) with a
+    /// large base.
+    node* copy(const node* n, node* parent) {
+      node* c = n->leaf ? new_leaf() : new_inner();
+      c->parent = parent;
+      c->pos = n->pos;
+      for(size_t i = 0; i < n->count; ++i) {
+        ::new(c->slot(i)) value_type(n->entry(i));
+        ++c->count;
+      }
+      if(!n->leaf)
+        for(size_t i = 0; i <= n->count; ++i)
+          child(c, i) = copy(child(const_cast<node*>(n), i), c);
+      return c;
+    }
+
+    /// @brief Run the destructor of every entry of the subtree rooted at
+    ///        \c n, leaving node storage to the pools
+    void destroy_values(node* n) {
+      if(std::is_trivially_destructible<value_type>::value)
+        return;
+      for(size_t i = 0; i < n->count; ++i)
+        n->entry(i).~value_type();
+      if(!n->leaf)
+        for(size_t i = 0; i <= n->count; ++i)
+          destroy_values(child(n, i));
+      n->count = 0;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    node_pool<node> leaves;       ///< Storage of leaves, must outlive root
+    node_pool<inner_node> inners; ///< Storage of inner nodes
+    node* root;                   ///< Root node, an empty leaf for an empty map
+    size_t sz;                    ///< Number of entries
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief B-tree leaf, entries live in raw slots constructed on demand
+    ////////////////////////////////////////////////////////////////////////////
+    struct node {
+      /// @return Storage of entry \c i
+      void* slot(size_t i) {return &slots[i];}
+      /// @return Entry \c i
+      value_type& entry(size_t i) {
+        return *reinterpret_cast<value_type*>(&slots[i]);
+      }
+      /// @return Entry \c i
+      const value_type& entry(size_t i) const {
+        return *reinterpret_cast<const value_type*>(&slots[i]);
+      }
+      /// @return Key of entry \c i
+      const Key& key(size_t i) const {return entry(i).first;}
+
+      node* parent;  ///< Parent node
+      size_t pos;    ///< Index of this node among its parent's children
+      size_t count;  ///< Number of entries
+      bool leaf;     ///< Is the node a leaf?
+      typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type
+        slots[max_entries]; ///< Entries, sorted by key
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief B-tree inner node, child \c i holds the keys less than entry
+    ///        \c i
+    ////////////////////////////////////////////////////////////////////////////
+    struct inner_node : public node {
+      node* children[Order]; ///< Children
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Bidirectional iterator for a B-tree
+    /// @tparam U value_type of map
+    ///
+    /// A position is a node and an entry index. end() is the position one past
+    /// the last entry of the rightmost leaf.
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename U>
+      class btree_iterator : public std::iterator<std::bidirectional_iterator_tag, U> {
+        public:
+          //////////////////////////////////////////////////////////////////////
+          /// @name Constructors
+          /// @{
+
+          /// @brief Construction
+          /// @param v Node
+          /// @param j Entry index
+          btree_iterator(node* v = nullptr, size_t j = 0) : n(v), i(j) {}
+
+          /// @brief Copy construction
+          /// @param o Other iterator
+          btree_iterator(const btree_iterator<typename std::remove_const<U>::type>& o) :
+            n(o.n), i(o.i) {}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Comparison
+          /// @{
+
+          /// @brief Equality comparison
+          /// @param o Iterator
+          bool operator==(const btree_iterator& o) const {return n == o.n && i == o.i;}
+          /// @brief Inequality comparison
+          /// @param o Iterator
+          bool operator!=(const btree_iterator& o) const {return !(*this == o);}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Dereference
+          /// @{
+
+          /// @brief Dereference operator
+          U& operator*() const {return n->entry(i);}
+          /// @brief Dereference operator
+          U* operator->() const {return &n->entry(i);}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Advancement
+          /// @{
+
+          /// @brief Pre-increment
+          btree_iterator& operator++() {
+            if(!n->leaf) {
+              n = child(n, i + 1);
+              while(!n->leaf) n = child(n, 0);
+              i = 0;
+              return *this;
+            }
+            if(++i < n->count)
+              return *this;
+            //past the end of a leaf, climb to the first ancestor entry to the
+            //right, or stay put as end()
+            node* v = n;
+            size_t j = i;
+            while(j == v->count && v->parent) {
+              j = v->pos;
+              v = v->parent;
+            }
+            if(j < v->count) {
+              n = v;
+              i = j;
+            }
+            return *this;
+          }
+          /// @brief Post-increment
+          btree_iterator operator++(int) {btree_iterator tmp(*this); ++(*this); return tmp;}
+          /// @brief Pre-decrement
+          btree_iterator& operator--() {
+            if(!n->leaf) {
+              n = child(n, i);
+              while(!n->leaf) n = child(n, n->count);
+              i = n->count;
+            }
+            while(i == 0 && n->parent) {
+              i = n->pos;
+              n = n->parent;
+            }
+            --i;
+            return *this;
+          }
+          /// @brief Post-decrement
+          btree_iterator operator--(int) {btree_iterator tmp(*this); --(*this); return tmp;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+        private:
+          node* n;  ///< Node
+          size_t i; ///< Entry index within node
+
+          friend class btree_map;
+      };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+};
+
+}
+
+#endif
@@ -0,0 +1,425 @@
+#ifndef _CONCURRENT_MAP_H_
+#define _CONCURRENT_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "epoch.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Ordered map safe under any mix of concurrent readers and writers
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Value Value type
+///
+/// Implemented as an optimistic skip list in the style of Herlihy, Lev,
+/// Luchangco and Shavit. find, count and scan take no locks and never retry.
+/// insert and erase search without locks as well, then lock only the
+/// predecessors of the affected node, validate that they are unchanged and
+/// retry the search if not. An erased node is first marked, which makes it
+/// invisible to readers, and then unlinked at every level at once, so it can
+/// be handed to epoch reclamation right away. Readers still walking through it
+/// keep it alive by being pinned.
+///
+/// Values are immutable once inserted and are returned by copy. There are no
+/// iterators; scan copies a key range out, each element reported was present
+/// at some point during the scan.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value>
+class concurrent_map {
+
+  struct node; ///< Forward declare node class
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+    typedef std::pair<const key_type, mapped_type>
+      value_type;              ///< Entry type
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    concurrent_map() : head(create(value_type(), max_level - 1)), sz(0) {}
+
+    concurrent_map(const concurrent_map&) = delete;
+    concurrent_map& operator=(const concurrent_map&) = delete;
+
+    /// @brief Destructor, no other thread may use the map anymore
+    ///
+    /// Erased nodes already belong to epoch reclamation and are freed there.
+    ~concurrent_map() {
+      node* n = head;
+      while(n) {
+        node* next = n->next[0].load(std::memory_order_relaxed);
+        destroy(n);
+        n = next;
+      }
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of map, exact only while no writer is active
+    size_t size() const {return sz.load(std::memory_order_relaxed);}
+    /// @return Does the map contain anything?
+    bool empty() const {return size() == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Insert element into map if its key is absent
+    /// @param v Key, Value pair
+    /// @return true if a new element was inserted, false if the key existed
+    bool insert(const value_type& v) {
+      epoch::guard g;
+      int top = random_level();
+      node* preds[max_level];
+      node* succs[max_level];
+      while(true) {
+        int found = seek(v.first, preds, succs);
+        if(found != -1) {
+          node* f = succs[found];
+          if(!f->marked.load(std::memory_order_acquire)) {
+            while(!f->fully_linked.load(std::memory_order_acquire))
+              std::this_thread::yield();
+            return false;
+          }
+          // An erase of the same key is under way, wait for it to unlink
+          std::this_thread::yield();
+          continue;
+        }
+
+        int locked = -1;
+        bool valid = true;
+        for(int l = 0; valid && l <= top; ++l) {
+          if(l == 0 || preds[l] != preds[l - 1])
+            preds[l]->lock();
+          locked = l;
+          valid = !preds[l]->marked.load(std::memory_order_relaxed) &&
+            (!succs[l] || !succs[l]->marked.load(std::memory_order_relaxed)) &&
+            preds[l]->next[l].load(std::memory_order_relaxed) == succs[l];
+        }
+        if(!valid) {
+          unlock(preds, locked);
+          continue;
+        }
+
+        node* n = create(v, top);
+        for(int l = 0; l <= top; ++l)
+          n->next[l].store(succs[l], std::memory_order_relaxed);
+        for(int l = 0; l <= top; ++l)
+          preds[l]->next[l].store(n, std::memory_order_release);
+        n->fully_linked.store(true, std::memory_order_release);
+        unlock(preds, locked);
+        sz.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    /// @brief Remove element with key \c k
+    /// @param k Key
+    /// @return Number of elements removed (in this case it is at most 1)
+    size_t erase(const Key& k) {
+      epoch::guard g;
+      node* preds[max_level];
+      node* succs[max_level];
+      node* victim = nullptr;
+      while(true) {
+        int found = seek(k, preds, succs);
+        if(!victim) {
+          // Only a fully linked node found at its own top level is erasable,
+          // anything else is still being inserted or already erased
+          if(found == -1)
+            return 0;
+          node* v = succs[found];
+          if(!v->fully_linked.load(std::memory_order_acquire) ||
+              v->top_level != found ||
+              v->marked.load(std::memory_order_acquire))
+            return 0;
+          v->lock();
+          if(v->marked.load(std::memory_order_relaxed)) {
+            v->unlock();
+            return 0;
+          }
+          v->marked.store(true, std::memory_order_release);
+          victim = v;
+        }
+
+        int top = victim->top_level;
+        int locked = -1;
+        bool valid = true;
+        for(int l = 0; valid && l <= top; ++l) {
+          if(l == 0 || preds[l] != preds[l - 1])
+            preds[l]->lock();
+          locked = l;
+          valid = !preds[l]->marked.load(std::memory_order_relaxed) &&
+            preds[l]->next[l].load(std::memory_order_relaxed) == victim;
+        }
+        if(!valid) {
+          unlock(preds, locked);
+          continue;
+        }
+
+        for(int l = top; l >= 0; --l)
+          preds[l]->next[l].store(
+              victim->next[l].load(std::memory_order_relaxed),
+              std::memory_order_release);
+        victim->unlock();
+        unlock(preds, locked);
+        sz.fetch_sub(1, std::memory_order_relaxed);
+        epoch::retire(victim, &reclaim);
+        return 1;
+      }
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @param[out] v Copy of the value if found, untouched otherwise
+    /// @return Was \c k found?
+    bool find(const Key& k, Value& v) const {
+      epoch::guard g;
+      node* n = finder(k);
+      if(n)
+        v = n->value.second;
+      return n;
+    }
+    /// @brief Count elements with specific keys
+    /// @param k Key
+    /// @return Count of elements with key \c k, 1 or 0
+    size_t count(const Key& k) const {
+      epoch::guard g;
+      return finder(k) ? 1 : 0;
+    }
+    /// @brief Copy out the elements with keys in [lo, hi) in ascending order
+    /// @tparam OutputIterator Output iterator accepting value_type
+    /// @param lo Smallest key copied
+    /// @param hi Key past the largest copied
+    /// @param out Destination
+    /// @return Number of elements copied
+    template<class OutputIterator>
+      size_t scan(const Key& lo, const Key& hi, OutputIterator out) const {
+        epoch::guard g;
+        node* pred = head;
+        for(int l = max_level - 1; l >= 0; --l) {
+          node* curr = pred->next[l].load(std::memory_order_acquire);
+          while(curr && curr->value.first < lo) {
+            pred = curr;
+            curr = pred->next[l].load(std::memory_order_acquire);
+          }
+        }
+        size_t n = 0;
+        for(node* curr = pred->next[0].load(std::memory_order_acquire);
+            curr && curr->value.first < hi;
+            curr = curr->next[0].load(std::memory_order_acquire))
+          if(live(curr)) {
+            *out = curr->value;
+            ++out;
+            ++n;
+          }
+        return n;
+      }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @brief Find the predecessor and successor of \c k on every level
+    /// @param k Key
+    /// @param[out] preds Last node with a key less than \c k on each level
+    /// @param[out] succs Node following preds on each level, may be null
+    /// @return Highest level on which a node with key \c k was found, -1 if
+    ///         none was
+    int seek(const Key& k, node** preds, node** succs) const {
+      int found = -1;
+      node* pred = head;
+      for(int l = max_level - 1; l >= 0; --l) {
+        node* curr = pred->next[l].load(std::memory_order_acquire);
+        while(curr && curr->value.first < k) {
+          pred = curr;
+          curr = pred->next[l].load(std::memory_order_acquire);
+        }
+        if(found == -1 && curr && !(k < curr->value.first))
+          found = l;
+        preds[l] = pred;
+        succs[l] = curr;
+      }
+      return found;
+    }
+
+    /// @brief Utility for finding a live node with Key \c k, caller is pinned
+    /// @param k Key
+    /// @return Node pointer to where node exists or nullptr
+    node* finder(const Key& k) const {
+      node* pred = head;
+      for(int l = max_level - 1; l >= 0; --l) {
+        node* curr = pred->next[l].load(std::memory_order_acquire);
+        while(curr && curr->value.first < k) {
+          pred = curr;
+          curr = pred->next[l].load(std::memory_order_acquire);
+        }
+        if(curr && !(k < curr->value.first))
+          return live(curr) ? curr : nullptr;
+      }
+      return nullptr;
+    }
+
+    /// @return Is \c n fully inserted and not erased?
+    static bool live(const node* n) {
+      return n->fully_linked.load(std::memory_order_acquire) &&
+        !n->marked.load(std::memory_order_acquire);
+    }
+
+    /// @brief Unlock the distinct nodes among preds[0..locked]
+    static void unlock(node** preds, int locked) {
+      for(int l = 0; l <= locked; ++l)
+        if(l == 0 || preds[l] != preds[l - 1])
+          preds[l]->unlock();
+    }
+
+    /// @return Level of a new node, level l has probability 4^-l
+    static int random_level() {
+      static thread_local uint64_t x = 0;
+      if(x == 0)
+        x = reinterpret_cast<uintptr_t>(&x) | 1;
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      int l = 0;
+      for(uint64_t r = x; (r & 3) == 0 && l < max_level - 1; r >>= 2)
+        ++l;
+      return l;
+    }
+
+    /// @brief Allocate a node with its tower of \c top + 1 links in one block
+    /// @param v Entry
+    /// @param top Highest level of the node
+    static node* create(const value_type& v, int top) {
+      void* p = ::operator new(sizeof(node) + (top + 1)*sizeof(link));
+      node* n = ::new(p) node(v, top);
+      n->next = reinterpret_cast<link*>(n + 1);
+      for(int l = 0; l <= top; ++l)
+        ::new(static_cast<void*>(&n->next[l])) link(nullptr);
+      return n;
+    }
+    /// @brief Free a node made by create
+    static void destroy(node* n) {
+      n->~node();
+      ::operator delete(n);
+    }
+    /// @brief Free a retired node, called by epoch reclamation
+    static void reclaim(epoch_node* n) {
+      destroy(static_cast<node*>(n));
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    typedef std::atomic<node*> link; ///< Forward link of one level
+
+    static const int max_level = 16; ///< Levels of the head, enough for 4^16
+                                     ///< elements
+
+    node* const head;        ///< Sentinel starting every level
+    std::atomic<size_t> sz;  ///< Number of elements
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Internal structure for skip list, followed by its tower of links
+    ////////////////////////////////////////////////////////////////////////////
+    struct node : epoch_node {
+      public:
+
+        ////////////////////////////////////////////////////////////////////////
+        /// @name Constructors
+        /// @{
+
+        /// @brief Constructor
+        /// @param v Map entry (Key, Value) pair
+        /// @param top Highest level of the node
+        node(const value_type& v, int top) :
+          value(v), next(nullptr), top_level(top), marked(false),
+          fully_linked(false), locked(false) {}
+
+        node(const node&) = delete;
+        node& operator=(const node&) = delete;
+
+        /// @}
+        ////////////////////////////////////////////////////////////////////////
+
+        ////////////////////////////////////////////////////////////////////////
+        /// @name Modifiers
+        /// @{
+
+        /// @brief Spin until the node lock is taken, yielding between tries
+        void lock() {
+          while(locked.exchange(true, std::memory_order_acquire))
+            std::this_thread::yield();
+        }
+        /// @brief Release the node lock
+        void unlock() {
+          locked.store(false, std::memory_order_release);
+        }
+
+        /// @}
+        ////////////////////////////////////////////////////////////////////////
+
+        ////////////////////////////////////////////////////////////////////////
+        /// @name Data
+        /// @{
+
+        value_type value;               ///< Value is pair(key, value)
+        link* next;                     ///< Links of levels 0 to top_level
+        const int top_level;            ///< Highest level of the node
+        std::atomic<bool> marked;       ///< Erased, being unlinked
+        std::atomic<bool> fully_linked; ///< Linked on all of its levels
+        std::atomic<bool> locked;       ///< Lock taken by writers
+
+        /// @}
+        ////////////////////////////////////////////////////////////////////////
+    };
+};
+
+}
+
+#endif
@@ -0,0 +1,1156 @@
+#ifndef _DISK_MAP_H_
+#define _DISK_MAP_H_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief How a disk_map opens its file
+/// @ingroup MySTL
+////////////////////////////////////////////////////////////////////////////////
+enum class disk_access {
+  read_only, ///< Lookups and iteration only, the file is mapped read-only
+  read_write ///< Updates as well, a missing or empty file becomes an empty map
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Map ADT based on C++ map stored as a B+tree in a memory-mapped file
+/// @ingroup MySTL
+/// @tparam Key Key type, trivially copyable
+/// @tparam Value Value type, trivially copyable
+/// @tparam PageSize Size of a tree node in the file, a power of two
+///
+/// Lookup and iteration interface of map. Every node is one page of the file
+/// and the whole file is mapped into memory, so opening a map reads only its
+/// two header pages, and lookups run directly on the page cache and return
+/// references into it. Entries live in the leaves, inner pages hold separator
+/// keys and child page numbers. A map is built from sorted input in one pass
+/// by the range constructor.
+///
+/// Updates never modify a page of the last committed tree, they copy it to a
+/// free page first (copy-on-write). commit() flushes the new pages and then
+/// switches to the new root by writing one of two alternating, checksummed
+/// header pages, so after a crash at any point the file holds either the old
+/// or the new version. Updates not committed are discarded by the destructor.
+/// Pages given up by a commit are reused by later updates through the same
+/// object, but not after reopening; building the map anew compacts the file.
+/// Since reused pages are overwritten, a file must not be updated while other
+/// disk_map objects have it open. Any update invalidates all iterators.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value, size_t PageSize = 4096>
+class disk_map {
+
+  static_assert(std::is_trivially_copyable<Key>::value &&
+      std::is_trivially_copyable<Value>::value,
+      "disk_map stores its entries as raw bytes");
+  static_assert(PageSize >= 256 && (PageSize & (PageSize - 1)) == 0,
+      "disk_map requires a power of two page size of at least 256");
+
+  struct meta;          ///< Forward declare header page class
+  struct page_header;   ///< Forward declare page header class
+  struct leaf_page;     ///< Forward declare leaf page class
+  struct inner_page;    ///< Forward declare inner page class
+  class disk_iterator;  ///< Forward declare iterator class
+
+  typedef uint64_t page_id; ///< Page number within the file
+  typedef typename std::aligned_storage<sizeof(Key), alignof(Key)>::type
+    key_slot;               ///< Raw storage of a key
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+    typedef std::pair<const key_type, mapped_type>
+      value_type;              ///< Entry type
+    typedef disk_iterator
+      const_iterator;          ///< Const bidirectional iterator
+    typedef const_iterator
+      iterator;                ///< Entries are only changed by the modifiers
+    typedef std::reverse_iterator<const_iterator>
+      const_reverse_iterator;  ///< Const reverse bidirectional iterator
+    typedef const_reverse_iterator
+      reverse_iterator;        ///< Reverse bidirectional iterator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor opening a map file
+    /// @param path File name
+    /// @param a Access mode
+    ///
+    /// Throws \c system_error if the file cannot be opened or mapped and
+    /// \c runtime_error if it holds no valid map of this type.
+    disk_map(const std::string& path, disk_access a = disk_access::read_only) :
+      access(a), fd(-1), base(nullptr), mapped(0) {
+      open_file(path, a == disk_access::read_only ? O_RDONLY : O_RDWR | O_CREAT);
+      try {
+        load();
+      }
+      catch(...) {
+        close_file();
+        throw;
+      }
+    }
+    /// @brief Constructor writing a new map file from sorted entries
+    /// @tparam InputIterator Iterator over pairs of Key and Value
+    /// @param path File name, an existing file is replaced
+    /// @param first Start of range, sorted by key
+    /// @param last End of range
+    ///
+    /// Fills the leaves completely and builds the inner pages bottom up, then
+    /// commits. Of equal keys the first is kept, as with insert. Throws
+    /// \c invalid_argument if the range is not sorted. The map is open for
+    /// reading and writing.
+    template<typename InputIterator>
+      disk_map(const std::string& path, InputIterator first,
+          InputIterator last) :
+        access(disk_access::read_write), fd(-1), base(nullptr), mapped(0) {
+        open_file(path, O_RDWR | O_CREAT | O_TRUNC);
+        try {
+          initialize();
+          bulk_load(first, last);
+          commit();
+        }
+        catch(...) {
+          close_file();
+          throw;
+        }
+      }
+    /// @brief Copy constructor - Deleted, a file has one owner
+    disk_map(const disk_map&) = delete;
+    /// @brief Destructor, discards updates since the last commit
+    ~disk_map() {
+      close_file();
+    }
+
+    /// @brief Copy assignment - Deleted, a file has one owner
+    disk_map& operator=(const disk_map&) = delete;
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Iterators
+    /// @{
+
+    /// @return Iterator to beginning
+    const_iterator begin() const {return cbegin();}
+    /// @return Iterator to end
+    const_iterator end() const {return cend();}
+    /// @return Iterator to reverse beginning
+    const_reverse_iterator rbegin() const {return crbegin();}
+    /// @return Iterator to reverse end
+    const_reverse_iterator rend() const {return crend();}
+    /// @return Iterator to beginning
+    const_iterator cbegin() const {
+      const_iterator i(this);
+      i.path[0] = root;
+      i.pos[0] = 0;
+      i.descend(1, false);
+      if(sz == 0)
+        i.depth = 0;
+      return i;
+    }
+    /// @return Iterator to end
+    const_iterator cend() const {return const_iterator(this);}
+    /// @return Iterator to reverse beginning
+    const_reverse_iterator crbegin() const {return const_reverse_iterator(cend());}
+    /// @return Iterator to reverse end
+    const_reverse_iterator crend() const {return const_reverse_iterator(cbegin());}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of map
+    size_t size() const {return sz;}
+    /// @return Does the map contain anything?
+    bool empty() const {return sz == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @param k Input key
+    /// @return Value at given key, a reference into the mapped file
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    const Value& at(const Key& k) const {
+      const_iterator it = find(k);
+      if(it == cend())
+        throw std::out_of_range("out of range");
+      return it->second;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Insert element into map
+    /// @param v Key, Value pair
+    /// @return pair of iterator and bool. Iterator pointing to found element or
+    ///         already existing element. bool is true if a new element was
+    ///         inserted and false if it existed.
+    std::pair<const_iterator, bool> insert(const value_type& v) {
+      bool inserted = update(v.first, v.second, false);
+      return std::make_pair(find(v.first), inserted);
+    }
+    /// @brief Assign \c obj to the value at \c k, inserting \c k if absent
+    /// @param k Key
+    /// @param obj Value
+    /// @return pair of iterator and bool. bool is true if a new element was
+    ///         inserted and false if an existing one was assigned.
+    std::pair<const_iterator, bool> insert_or_assign(const Key& k,
+        const Value& obj) {
+      bool inserted = update(k, obj, true);
+      return std::make_pair(find(k), inserted);
+    }
+    /// @brief Remove element with key \c k
+    /// @param k Key
+    /// @return Number of elements removed (in this case it is at most 1)
+    size_t erase(const Key& k) {
+      check_writable();
+      reserve(2*height);
+      if(!eraser(root, k))
+        return 0;
+      if(!header(root)->leaf && header(root)->count == 0) {
+        page_id r = root;
+        root = inner(r)->children[0];
+        retire(r);
+        --height;
+      }
+      --sz;
+      return 1;
+    }
+    /// @brief Make all updates so far durable
+    ///
+    /// Flushes the pages written since the last commit, then writes and
+    /// flushes the header page not holding the last commit. Pages the
+    /// previous version no longer needs become free afterwards.
+    void commit() {
+      check_writable();
+      sync();
+      meta* m = header_page((generation + 1) % 2);
+      m->magic = magic_number;
+      m->page_size = PageSize;
+      m->key_size = sizeof(Key);
+      m->entry_size = sizeof(value_type);
+      m->generation = generation + 1;
+      m->root = root;
+      m->height = height;
+      m->size = sz;
+      m->pages = pages;
+      m->checksum = checksum(*m);
+      sync();
+
+      ++generation;
+      free_pages.insert(free_pages.end(), pending.begin(), pending.end());
+      pending.clear();
+      for(page_id id : written)
+        dirty[id] = false;
+      written.clear();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, cend() otherwise
+    const_iterator find(const Key& k) const {
+      const_iterator it = lower_bound(k);
+      return it != cend() && !(k < it->first) ? it : cend();
+    }
+
+    /// @brief Count elements with specific keys
+    /// @param k Key
+    /// @return Count of elements with key \c k, 0 or 1
+    size_t count(const Key& k) const {
+      page_id id = root;
+      while(!header(id)->leaf)
+        id = inner(id)->children[upper(inner(id), k)];
+      const leaf_page* l = leaf(id);
+      size_t i = lower(l, k);
+      return i < l->count && !(k < l->key(i)) ? 1 : 0;
+    }
+
+    /// @param k Key
+    /// @return Iterator to the first element whose key is not less than \c k,
+    ///         cend() if there is none
+    const_iterator lower_bound(const Key& k) const {
+      const_iterator it(this);
+      page_id id = root;
+      size_t d = 0;
+      for(; !header(id)->leaf; ++d) {
+        it.path[d] = id;
+        it.pos[d] = upper(inner(id), k);
+        id = inner(id)->children[it.pos[d]];
+      }
+      it.path[d] = id;
+      it.pos[d] = lower(leaf(id), k);
+      it.depth = d + 1;
+      //past the end of a leaf, the next leaf starts with the successor
+      if(it.pos[d] == leaf(id)->count) {
+        if(sz == 0)
+          return cend();
+        --it.pos[d];
+        ++it;
+      }
+      return it;
+    }
+
+    /// @param k Key
+    /// @return Iterator to the first element whose key is greater than \c k,
+    ///         cend() if there is none
+    const_iterator upper_bound(const Key& k) const {
+      const_iterator it = lower_bound(k);
+      if(it != cend() && !(k < it->first))
+        ++it;
+      return it;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    static const uint64_t magic_number = 0x70616d6b736964ULL; ///< "diskmap"
+    static const size_t max_height = 16; ///< Height limit of iterator paths
+
+    /// Entries of a full leaf
+    static const size_t leaf_capacity =
+      (PageSize - 2*sizeof(uint32_t)) / sizeof(value_type);
+    /// Keys of a full inner page, which has one more child
+    static const size_t inner_capacity =
+      (PageSize - 2*sizeof(uint32_t) - sizeof(page_id)) /
+      (sizeof(Key) + sizeof(page_id));
+    static const size_t min_leaf = leaf_capacity/2;   ///< Entries of a
+                                                      ///< minimal leaf
+    static const size_t min_inner = inner_capacity/2; ///< Keys of a minimal
+                                                      ///< inner page
+
+    static_assert(leaf_capacity >= 4 && inner_capacity >= 8,
+        "disk_map page size too small for its entries");
+
+    /// @return Start of page \c id in the mapping
+    char* page(page_id id) const {return base + id*PageSize;}
+    /// @return Header of page \c id
+    page_header* header(page_id id) const {
+      return reinterpret_cast<page_header*>(page(id));
+    }
+    /// @return Page \c id, a leaf
+    leaf_page* leaf(page_id id) const {
+      return reinterpret_cast<leaf_page*>(page(id));
+    }
+    /// @return Page \c id, an inner page
+    inner_page* inner(page_id id) const {
+      return reinterpret_cast<inner_page*>(page(id));
+    }
+    /// @return Header page \c i, 0 or 1
+    meta* header_page(size_t i) const {
+      return reinterpret_cast<meta*>(page(i));
+    }
+
+    /// @brief Index of the first key of \c p not less than \c k
+    /// @tparam Page Page type
+    /// @param p Page
+    /// @param k Key
+    ///
+    /// Branchless binary search as in btree_map.
+    template<typename Page>
+      static size_t lower(const Page* p, const Key& k) {
+        size_t len = p->count;
+        if(len == 0)
+          return 0;
+        size_t base = 0;
+        while(len > 1) {
+          size_t half = len/2;
+          base = p->key(base + half) < k ? base + half : base;
+          len -= half;
+        }
+        return base + (p->key(base) < k);
+      }
+
+    /// @brief Index of the first key of \c p greater than \c k, i.e., the
+    ///        child of an inner page whose subtree may hold \c k
+    /// @tparam Page Page type
+    /// @param p Page
+    /// @param k Key
+    template<typename Page>
+      static size_t upper(const Page* p, const Key& k) {
+        size_t len = p->count;
+        if(len == 0)
+          return 0;
+        size_t base = 0;
+        while(len > 1) {
+          size_t half = len/2;
+          base = k < p->key(base + half) ? base : base + half;
+          len -= half;
+        }
+        return base + !(k < p->key(base));
+      }
+
+    /// @brief Insert or assign the entry of \c k and update the root
+    /// @param k Key
+    /// @param v Value
+    /// @param assign Whether an existing value is replaced
+    /// @return Whether a new entry was inserted
+    bool update(const Key& k, const Value& v, bool assign) {
+      check_writable();
+      if(height == max_height)
+        throw std::length_error("disk_map is too high");
+      //a path copy and a split per level and a new root, reserved up front
+      //so page pointers stay valid throughout
+      reserve(2*height + 1);
+      Key sep;
+      page_id right;
+      int r = inserter(root, k, v, assign, sep, right);
+      if(right) {
+        page_id id = allocate();
+        inner_page* p = inner(id);
+        p->leaf = 0;
+        p->count = 1;
+        p->children[0] = root;
+        p->children[1] = right;
+        p->key(0) = sep;
+        root = id;
+        ++height;
+      }
+      if(r == 1)
+        ++sz;
+      return r == 1;
+    }
+
+    /// @brief Insert or assign the entry of \c k in the subtree of page \c id
+    /// @param id Root of subtree, replaced by its copy if it changes
+    /// @param k Key
+    /// @param v Value
+    /// @param assign Whether an existing value is replaced
+    /// @param sep Set to the least key of the new right sibling after a split
+    /// @param right Set to the new right sibling after a split, 0 otherwise
+    /// @return 1 if an entry was inserted, 2 if one was assigned, 0 otherwise
+    ///
+    /// Recursion depth is the height of the tree.
+    int inserter(page_id& id, const Key& k, const Value& v, bool assign,
+        Key& sep, page_id& right) {
+      right = 0;
+      if(header(id)->leaf) {
+        leaf_page* l = leaf(id);
+        size_t i = lower(l, k);
+        bool found = i < l->count && !(k < l->key(i));
+        if(found && !assign)
+          return 0;
+        id = writable(id);
+        l = leaf(id);
+        if(found) {
+          l->entry(i).second = v;
+          return 2;
+        }
+        if(l->count < leaf_capacity) {
+          insert_entry(l, i, k, v);
+          return 1;
+        }
+        //split, each half ends up with at least min_leaf entries
+        right = allocate();
+        leaf_page* r = leaf(right);
+        r->leaf = 1;
+        size_t half = (leaf_capacity + 1)/2;
+        size_t from = i < half ? half - 1 : half;
+        r->count = l->count - from;
+        move_entries(r, 0, l, from, r->count);
+        l->count = from;
+        if(i < half)
+          insert_entry(l, i, k, v);
+        else
+          insert_entry(r, i - half, k, v);
+        sep = r->key(0);
+        return 1;
+      }
+
+      size_t i = upper(inner(id), k);
+      page_id c = inner(id)->children[i];
+      Key csep;
+      page_id cright;
+      int r = inserter(c, k, v, assign, csep, cright);
+      if(c == inner(id)->children[i] && !cright)
+        return r;
+      id = writable(id);
+      inner_page* p = inner(id);
+      p->children[i] = c;
+      if(!cright)
+        return r;
+      if(p->count < inner_capacity) {
+        insert_child(p, i, csep, cright);
+        return r;
+      }
+
+      //line up the inner_capacity + 1 keys, then cut in the middle
+      key_slot keys[inner_capacity + 1];
+      page_id children[inner_capacity + 2];
+      std::memcpy(keys, p->keys, i*sizeof(Key));
+      std::memcpy(keys + i, &csep, sizeof(Key));
+      std::memcpy(keys + i + 1, p->keys + i, (p->count - i)*sizeof(Key));
+      std::memcpy(children, p->children, (i + 1)*sizeof(page_id));
+      children[i + 1] = cright;
+      std::memcpy(children + i + 2, p->children + i + 1,
+          (p->count - i)*sizeof(page_id));
+      right = allocate();
+      split_keys(keys, children, inner_capacity + 1, p, inner(right));
+      std::memcpy(&sep, keys + p->count, sizeof(Key));
+      return r;
+    }
+
+    /// @brief Remove the entry of \c k from the subtree of page \c id
+    /// @param id Root of subtree, replaced by its copy if it changes
+    /// @param k Key
+    /// @return Whether an entry was removed
+    ///
+    /// A child left below its minimum is refilled from or merged with a
+    /// sibling on the way back up. Separators of removed keys may stay in
+    /// inner pages, they still divide the subtrees correctly.
+    bool eraser(page_id& id, const Key& k) {
+      if(header(id)->leaf) {
+        leaf_page* l = leaf(id);
+        size_t i = lower(l, k);
+        if(i == l->count || k < l->key(i))
+          return false;
+        id = writable(id);
+        l = leaf(id);
+        move_entries(l, i, l, i + 1, l->count - i - 1);
+        --l->count;
+        return true;
+      }
+
+      size_t i = upper(inner(id), k);
+      page_id c = inner(id)->children[i];
+      if(!eraser(c, k))
+        return false;
+      id = writable(id);
+      inner_page* p = inner(id);
+      p->children[i] = c;
+      size_t min = min_inner;
+      if(header(c)->leaf)
+        min = min_leaf;
+      if(header(c)->count < min)
+        rebalance(p, i > 0 ? i - 1 : i);
+      return true;
+    }
+
+    /// @brief Refill or merge children \c j and \c j + 1 of \c p, one of which
+    ///        is below its minimum
+    /// @param p Writable inner page
+    /// @param j Index of the key separating the two children
+    void rebalance(inner_page* p, size_t j) {
+      page_id a = p->children[j] = writable(p->children[j]);
+      page_id b = p->children[j + 1];
+      if(header(a)->leaf) {
+        leaf_page* l = leaf(a);
+        if(l->count + leaf(b)->count <= leaf_capacity) {
+          move_entries(l, l->count, leaf(b), 0, leaf(b)->count);
+          l->count += leaf(b)->count;
+          remove_child(p, j, b);
+          return;
+        }
+        b = p->children[j + 1] = writable(b);
+        leaf_page* r = leaf(b);
+        size_t total = l->count + r->count;
+        size_t left = total/2;
+        if(l->count > left) {
+          size_t n = l->count - left;
+          move_entries(r, n, r, 0, r->count);
+          move_entries(r, 0, l, left, n);
+        }
+        else {
+          size_t n = left - l->count;
+          move_entries(l, l->count, r, 0, n);
+          move_entries(r, 0, r, n, total - left);
+        }
+        l->count = left;
+        r->count = total - left;
+        p->key(j) = r->key(0);
+        return;
+      }
+
+      inner_page* l = inner(a);
+      if(l->count + 1 + inner(b)->count <= inner_capacity) {
+        inner_page* r = inner(b);
+        l->key(l->count) = p->key(j);
+        std::memcpy(l->keys + l->count + 1, r->keys, r->count*sizeof(Key));
+        std::memcpy(l->children + l->count + 1, r->children,
+            (r->count + 1)*sizeof(page_id));
+        l->count += 1 + r->count;
+        remove_child(p, j, b);
+        return;
+      }
+      b = p->children[j + 1] = writable(b);
+      inner_page* r = inner(b);
+      //line up both pages and their separator, then cut in the middle
+      key_slot keys[2*inner_capacity + 1];
+      page_id children[2*inner_capacity + 2];
+      std::memcpy(keys, l->keys, l->count*sizeof(Key));
+      std::memcpy(keys + l->count, p->keys + j, sizeof(Key));
+      std::memcpy(keys + l->count + 1, r->keys, r->count*sizeof(Key));
+      std::memcpy(children, l->children, (l->count + 1)*sizeof(page_id));
+      std::memcpy(children + l->count + 1, r->children,
+          (r->count + 1)*sizeof(page_id));
+      split_keys(keys, children, l->count + 1 + r->count, l, r);
+      std::memcpy(p->keys + j, keys + l->count, sizeof(Key));
+    }
+
+    /// @brief Distribute \c n keys and their children evenly between the
+    ///        writable inner pages \c l and \c r, leaving the middle key out
+    ///        as the separator of the two
+    /// @param keys Keys, the separator is key \c l->count afterwards
+    /// @param children The \c n + 1 children
+    /// @param n Number of keys
+    /// @param l Left page
+    /// @param r Right page
+    static void split_keys(const key_slot* keys, const page_id* children,
+        size_t n, inner_page* l, inner_page* r) {
+      size_t left = n/2;
+      l->leaf = r->leaf = 0;
+      l->count = left;
+      r->count = n - left - 1;
+      std::memcpy(l->keys, keys, left*sizeof(Key));
+      std::memcpy(l->children, children, (left + 1)*sizeof(page_id));
+      std::memcpy(r->keys, keys + left + 1, r->count*sizeof(Key));
+      std::memcpy(r->children, children + left + 1,
+          (r->count + 1)*sizeof(page_id));
+    }
+
+    /// @brief Append sorted entries to the empty tree of a new file
+    /// @tparam InputIterator Iterator over pairs of Key and Value
+    /// @param first Start of range
+    /// @param last End of range
+    template<typename InputIterator>
+      void bulk_load(InputIterator first, InputIterator last) {
+        //least key and page of each page of the level being built
+        std::vector<std::pair<Key, page_id>> level;
+        page_id id = root;
+        for(; first != last; ++first) {
+          if(sz > 0) {
+            const leaf_page* l = leaf(id);
+            Key prev = l->key(l->count - 1);
+            if(first->first < prev)
+              throw std::invalid_argument("disk_map input is not sorted");
+            if(!(prev < first->first))
+              continue;
+            if(l->count == leaf_capacity) {
+              reserve(1);
+              id = allocate();
+              leaf(id)->leaf = 1;
+              leaf(id)->count = 0;
+              level.push_back(std::make_pair(Key(first->first), id));
+            }
+          }
+          else
+            level.push_back(std::make_pair(Key(first->first), id));
+          leaf_page* l = leaf(id);
+          ::new(l->slot(l->count)) value_type(first->first, first->second);
+          ++l->count;
+          ++sz;
+        }
+
+        //even out the last two leaves
+        if(level.size() > 1 && leaf(id)->count < min_leaf) {
+          leaf_page* l = leaf(level[level.size() - 2].second);
+          leaf_page* r = leaf(id);
+          size_t n = (l->count - r->count)/2;
+          move_entries(r, n, r, 0, r->count);
+          move_entries(r, 0, l, l->count - n, n);
+          l->count -= n;
+          r->count += n;
+          level.back().first = r->key(0);
+        }
+
+        //inner levels, children split evenly among ceil(size/(capacity+1))
+        //pages
+        while(level.size() > 1) {
+          std::vector<std::pair<Key, page_id>> up;
+          size_t nodes = (level.size() + inner_capacity)/(inner_capacity + 1);
+          reserve(nodes);
+          for(size_t j = 0, next = 0; j < nodes; ++j) {
+            size_t children = (level.size() - next)/(nodes - j);
+            page_id pid = allocate();
+            inner_page* p = inner(pid);
+            p->leaf = 0;
+            p->count = children - 1;
+            for(size_t c = 0; c < children; ++c) {
+              p->children[c] = level[next + c].second;
+              if(c > 0)
+                p->key(c - 1) = level[next + c].first;
+            }
+            up.push_back(std::make_pair(level[next].first, pid));
+            next += children;
+          }
+          level.swap(up);
+          ++height;
+        }
+        if(!level.empty())
+          root = level[0].second;
+      }
+
+    /// @brief Insert \c k, \c v as entry \c i of the writable leaf \c l, which
+    ///        has room
+    static void insert_entry(leaf_page* l, size_t i, const Key& k,
+        const Value& v) {
+      move_entries(l, i + 1, l, i, l->count - i);
+      ::new(l->slot(i)) value_type(k, v);
+      ++l->count;
+    }
+
+    /// @brief Insert key \c k as key \c i and child \c c as child \c i + 1 of
+    ///        the writable inner page \c p, which has room
+    static void insert_child(inner_page* p, size_t i, const Key& k,
+        page_id c) {
+      std::memmove(p->keys + i + 1, p->keys + i, (p->count - i)*sizeof(Key));
+      std::memmove(p->children + i + 2, p->children + i + 1,
+          (p->count - i)*sizeof(page_id));
+      p->key(i) = k;
+      p->children[i + 1] = c;
+      ++p->count;
+    }
+
+    /// @brief Remove key \c j and child \c j + 1, page \c b, from the writable
+    ///        inner page \c p and free \c b
+    void remove_child(inner_page* p, size_t j, page_id b) {
+      std::memmove(p->keys + j, p->keys + j + 1,
+          (p->count - j - 1)*sizeof(Key));
+      std::memmove(p->children + j + 1, p->children + j + 2,
+          (p->count - j - 1)*sizeof(page_id));
+      --p->count;
+      retire(b);
+    }
+
+    /// @brief Move \c n entries of \c from starting at \c i to \c to starting
+    ///        at \c j, the ranges may overlap
+    static void move_entries(leaf_page* to, size_t j, const leaf_page* from,
+        size_t i, size_t n) {
+      std::memmove(to->slot(j), from->slot(i), n*sizeof(value_type));
+    }
+
+    /// @brief Page \c id if it was written since the last commit, otherwise a
+    ///        copy of it on a new page, retiring \c id
+    page_id writable(page_id id) {
+      if(dirty[id])
+        return id;
+      page_id c = allocate();
+      std::memcpy(page(c), page(id), PageSize);
+      retire(id);
+      return c;
+    }
+
+    /// @return A free page, which must have been reserved
+    page_id allocate() {
+      page_id id;
+      if(!free_pages.empty()) {
+        id = free_pages.back();
+        free_pages.pop_back();
+      }
+      else
+        id = pages++;
+      dirty[id] = true;
+      written.push_back(id);
+      return id;
+    }
+
+    /// @brief Give up page \c id. A page of the committed tree stays intact
+    ///        until the next commit, one written since is free right away.
+    void retire(page_id id) {
+      if(dirty[id])
+        free_pages.push_back(id);
+      else
+        pending.push_back(id);
+    }
+
+    /// @brief Grow the file so that \c n more pages can be allocated without
+    ///        remapping
+    void reserve(size_t n) {
+      if(pages + n > mapped)
+        resize(std::max(2*mapped, size_t(pages + n)));
+    }
+
+    /// @brief Set the file to \c n pages and map all of it
+    void resize(size_t n) {
+      if(ftruncate(fd, n*PageSize))
+        throw std::system_error(errno, std::generic_category(), "ftruncate");
+      unmap();
+      map(n);
+    }
+
+    /// @brief Map the first \c n pages of the file
+    void map(size_t n) {
+      int prot = PROT_READ | (access == disk_access::read_write ? PROT_WRITE : 0);
+      void* p = mmap(nullptr, n*PageSize, prot, MAP_SHARED, fd, 0);
+      if(p == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), "mmap");
+      base = static_cast<char*>(p);
+      mapped = n;
+      dirty.resize(n);
+    }
+
+    /// @brief Unmap the file
+    void unmap() {
+      if(base)
+        munmap(base, mapped*PageSize);
+      base = nullptr;
+    }
+
+    /// @brief Open \c path with open(2) \c flags
+    void open_file(const std::string& path, int flags) {
+      fd = ::open(path.c_str(), flags, 0644);
+      if(fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    /// @brief Unmap and close the file
+    void close_file() {
+      unmap();
+      if(fd >= 0)
+        ::close(fd);
+      fd = -1;
+    }
+
+    /// @brief Map the file and read the newest valid header page, or set up
+    ///        an empty map in an empty writable file
+    void load() {
+      struct stat st;
+      if(fstat(fd, &st))
+        throw std::system_error(errno, std::generic_category(), "fstat");
+      if(st.st_size == 0 && access == disk_access::read_write) {
+        initialize();
+        commit();
+        return;
+      }
+      size_t n = st.st_size/PageSize;
+      if(n < 3)
+        throw std::runtime_error("not a disk_map file");
+      map(n);
+      const meta* m = nullptr;
+      for(size_t i = 0; i < 2; ++i) {
+        const meta* h = header_page(i);
+        if(h->magic == magic_number && h->checksum == checksum(*h) &&
+            h->pages <= n && (!m || h->generation > m->generation))
+          m = h;
+      }
+      if(!m)
+        throw std::runtime_error("not a disk_map file");
+      if(m->page_size != PageSize || m->key_size != sizeof(Key) ||
+          m->entry_size != sizeof(value_type))
+        throw std::runtime_error("disk_map file of a different type");
+      generation = m->generation;
+      root = m->root;
+      height = m->height;
+      sz = m->size;
+      pages = m->pages;
+    }
+
+    /// @brief Set up an empty map in the truncated file, without committing
+    void initialize() {
+      pages = 3;
+      resize(4);
+      std::memset(base, 0, 3*PageSize);
+      root = 2;
+      leaf(root)->leaf = 1;
+      leaf(root)->count = 0;
+      dirty[root] = true;
+      written.push_back(root);
+      height = 1;
+      sz = 0;
+      generation = 0;
+    }
+
+    /// @brief Flush the mapping and the file size to disk
+    void sync() {
+      if(msync(base, mapped*PageSize, MS_SYNC) || fsync(fd))
+        throw std::system_error(errno, std::generic_category(), "msync");
+    }
+
+    /// @brief Throw \c logic_error if the map is read-only
+    void check_writable() const {
+      if(access != disk_access::read_write)
+        throw std::logic_error("disk_map is read-only");
+    }
+
+    /// @return FNV-1a hash of the fields of \c m before its checksum
+    static uint64_t checksum(const meta& m) {
+      const unsigned char* p = reinterpret_cast<const unsigned char*>(&m);
+      uint64_t h = 14695981039346656037ULL;
+      for(size_t i = 0; i < offsetof(meta, checksum); ++i)
+        h = (h ^ p[i])*1099511628211ULL;
+      return h;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    disk_access access;    ///< Access mode
+    int fd;                ///< File descriptor
+    char* base;            ///< Mapping of the whole file
+    size_t mapped;         ///< Number of pages mapped, the file size
+    page_id root;          ///< Root page, a leaf for a map of at most one page
+    size_t height;         ///< Number of levels, 1 for a single leaf
+    size_t sz;             ///< Number of entries
+    page_id pages;         ///< Pages in use, free ones below are listed
+    uint64_t generation;   ///< Number of commits, selects the header page
+
+    std::vector<page_id> free_pages; ///< Pages free for reuse
+    std::vector<page_id> pending;    ///< Pages of the committed tree replaced
+                                     ///< since, free after the next commit
+    std::vector<page_id> written;    ///< Pages allocated since the last commit
+    std::vector<bool> dirty;         ///< Which pages were allocated since the
+                                     ///< last commit and are changed in place
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Header page, pages 0 and 1 alternate between commits
+    ////////////////////////////////////////////////////////////////////////////
+    struct meta {
+      uint64_t magic;      ///< magic_number
+      uint64_t page_size;  ///< PageSize
+      uint64_t key_size;   ///< Size of Key
+      uint64_t entry_size; ///< Size of value_type
+      uint64_t generation; ///< Number of the commit
+      uint64_t root;       ///< Root page
+      uint64_t height;     ///< Number of levels
+      uint64_t size;       ///< Number of entries
+      uint64_t pages;      ///< Pages in use
+      uint64_t checksum;   ///< Hash of the fields above
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Start of every tree page
+    ////////////////////////////////////////////////////////////////////////////
+    struct page_header {
+      uint32_t leaf;  ///< Is the page a leaf?
+      uint32_t count; ///< Number of entries of a leaf, keys of an inner page
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Leaf page, entries live in raw slots sorted by key
+    ////////////////////////////////////////////////////////////////////////////
+    struct leaf_page : public page_header {
+      /// @return Storage of entry \c i
+      void* slot(size_t i) {return &slots[i];}
+      /// @return Storage of entry \c i
+      const void* slot(size_t i) const {return &slots[i];}
+      /// @return Entry \c i
+      value_type& entry(size_t i) {
+        return *reinterpret_cast<value_type*>(&slots[i]);
+      }
+      /// @return Entry \c i
+      const value_type& entry(size_t i) const {
+        return *reinterpret_cast<const value_type*>(&slots[i]);
+      }
+      /// @return Key of entry \c i
+      const Key& key(size_t i) const {return entry(i).first;}
+
+      typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type
+        slots[leaf_capacity]; ///< Entries
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Inner page, child \c i holds the keys less than key \c i and
+    ///        not less than key \c i - 1
+    ////////////////////////////////////////////////////////////////////////////
+    struct inner_page : public page_header {
+      /// @return Key \c i
+      Key& key(size_t i) {return *reinterpret_cast<Key*>(&keys[i]);}
+      /// @return Key \c i
+      const Key& key(size_t i) const {
+        return *reinterpret_cast<const Key*>(&keys[i]);
+      }
+
+      page_id children[inner_capacity + 1]; ///< Child pages
+      key_slot keys[inner_capacity];        ///< Separator keys
+    };
+
+    static_assert(alignof(value_type) <= 8 && alignof(Key) <= 8,
+        "disk_map entries must not need more than 8 byte alignment");
+    static_assert(sizeof(leaf_page) <= PageSize &&
+        sizeof(inner_page) <= PageSize, "disk_map pages overflow");
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Bidirectional iterator for a disk map
+    ///
+    /// A position is the path of pages and child indices from the root to an
+    /// entry of a leaf, pages are not linked to their siblings since they are
+    /// copied on write. end() has an empty path.
+    ////////////////////////////////////////////////////////////////////////////
+    class disk_iterator :
+      public std::iterator<std::bidirectional_iterator_tag, const value_type> {
+        public:
+          //////////////////////////////////////////////////////////////////////
+          /// @name Constructors
+          /// @{
+
+          /// @brief Construction
+          /// @param o Map
+          disk_iterator(const disk_map* o = nullptr) : m(o), depth(0) {}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Comparison
+          /// @{
+
+          /// @brief Equality comparison
+          /// @param o Iterator
+          bool operator==(const disk_iterator& o) const {
+            return depth == o.depth && (depth == 0 ||
+                (path[depth - 1] == o.path[depth - 1] &&
+                 pos[depth - 1] == o.pos[depth - 1]));
+          }
+          /// @brief Inequality comparison
+          /// @param o Iterator
+          bool operator!=(const disk_iterator& o) const {return !(*this == o);}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Dereference
+          /// @{
+
+          /// @brief Dereference operator
+          const value_type& operator*() const {
+            return m->leaf(path[depth - 1])->entry(pos[depth - 1]);
+          }
+          /// @brief Dereference operator
+          const value_type* operator->() const {return &**this;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Advancement
+          /// @{
+
+          /// @brief Pre-increment
+          disk_iterator& operator++() {
+            size_t d = depth - 1;
+            if(++pos[d] < m->header(path[d])->count)
+              return *this;
+            //climb to the first ancestor with a child to the right
+            while(d > 0) {
+              --d;
+              if(++pos[d] <= m->header(path[d])->count) {
+                descend(d + 1, false);
+                return *this;
+              }
+            }
+            depth = 0;
+            return *this;
+          }
+          /// @brief Post-increment
+          disk_iterator operator++(int) {disk_iterator tmp(*this); ++(*this); return tmp;}
+          /// @brief Pre-decrement
+          disk_iterator& operator--() {
+            if(depth == 0) {
+              const page_header* h = m->header(m->root);
+              path[0] = m->root;
+              pos[0] = h->leaf ? h->count - 1 : h->count;
+              descend(1, true);
+              return *this;
+            }
+            size_t d = depth - 1;
+            if(pos[d] > 0) {
+              --pos[d];
+              return *this;
+            }
+            while(pos[--d] == 0);
+            --pos[d];
+            descend(d + 1, true);
+            return *this;
+          }
+          /// @brief Post-decrement
+          disk_iterator operator--(int) {disk_iterator tmp(*this); --(*this); return tmp;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+        private:
+          /// @brief Extend the path from the child chosen at level \c d - 1
+          ///        down to a leaf
+          /// @param d Level of the child
+          /// @param last Whether to follow the last rather than the first
+          ///             positions
+          void descend(size_t d, bool last) {
+            for(; !m->header(path[d - 1])->leaf; ++d) {
+              path[d] = m->inner(path[d - 1])->children[pos[d - 1]];
+              const page_header* h = m->header(path[d]);
+              pos[d] = !last ? 0 : h->leaf ? h->count - 1 : h->count;
+            }
+            depth = d;
+          }
+
+          const disk_map* m;          ///< Map
+          size_t depth;               ///< Length of the path, 0 at end()
+          page_id path[max_height];   ///< Pages from the root to a leaf
+          size_t pos[max_height];     ///< Child or entry index in each page
+
+          friend class disk_map;
+      };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+};
+
+}
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef _EPOCH_H_
+#define _EPOCH_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Intrusive header of objects reclaimed through epoch::retire
+/// @ingroup MySTL
+////////////////////////////////////////////////////////////////////////////////
+struct epoch_node {
+  epoch_node* retired_next;     ///< Next object in the limbo list
+  uint64_t retired_epoch;       ///< Global epoch when the object was retired
+  void (*reclaim)(epoch_node*); ///< Frees the object
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Epoch-based memory reclamation shared by all concurrent containers
+/// @ingroup MySTL
+///
+/// A thread pins the global epoch for the duration of an operation through an
+/// epoch::guard. An object unlinked from a shared structure is retired instead
+/// of freed, tagged with the epoch at that moment, and put on the limbo list
+/// of the retiring thread. The global epoch only advances once every pinned
+/// thread has observed it, so after two advances no thread can still hold a
+/// reference obtained before the object was unlinked and it is freed.
+///
+/// Pinning writes only the thread's own record. Every retire_batch retirements
+/// a thread tries to advance the epoch and frees what has expired. Records of
+/// exited threads are reused, together with their limbo lists, by the next
+/// thread that starts.
+////////////////////////////////////////////////////////////////////////////////
+class epoch {
+
+  struct record;
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Pins the current epoch for its lifetime, guards nest
+    ////////////////////////////////////////////////////////////////////////////
+    class guard {
+      public:
+        /// @brief Constructor, pins the calling thread
+        guard() : r(epoch::local()) {
+          if(r->depth++ == 0) {
+            r->state.store(global().load() << 1 | 1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+          }
+        }
+        /// @brief Destructor, unpins when the outermost guard ends
+        ~guard() {
+          if(--r->depth == 0)
+            r->state.store(0, std::memory_order_release);
+        }
+
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+
+      private:
+        record* r; ///< Record of the calling thread
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Hand an object that is no longer reachable to the reclaimer
+    /// @param n Object, already unlinked from every shared structure
+    /// @param reclaim Function freeing the object, called at most once when
+    ///                no pinned thread can reach it anymore
+    static void retire(epoch_node* n, void (*reclaim)(epoch_node*)) {
+      record* r = local();
+      n->retired_next = nullptr;
+      n->retired_epoch = global().load();
+      n->reclaim = reclaim;
+      if(r->limbo_tail)
+        r->limbo_tail->retired_next = n;
+      else
+        r->limbo_head = n;
+      r->limbo_tail = n;
+      if(++r->since_advance >= retire_batch) {
+        r->since_advance = 0;
+        try_advance();
+        free_expired(r);
+      }
+    }
+    /// @brief Try to advance the epoch and free the calling thread's expired
+    ///        objects
+    /// @return Number of objects freed
+    ///
+    /// A pinned caller holds the epoch back itself, so call it unpinned.
+    static size_t collect() {
+      record* r = local();
+      try_advance();
+      return free_expired(r);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Accessors
+    /// @{
+
+    /// @return Current global epoch
+    static uint64_t current() {return global().load();}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Per thread state, records are never freed
+    ////////////////////////////////////////////////////////////////////////////
+    struct record {
+      std::atomic<uint64_t> state; ///< Pinned epoch << 1 | 1, 0 if unpinned
+      std::atomic<bool> in_use;    ///< Owned by a running thread?
+      record* next;                ///< Next record
+      size_t depth;                ///< Number of live guards
+      epoch_node* limbo_head;      ///< Oldest retired object
+      epoch_node* limbo_tail;      ///< Newest retired object
+      size_t since_advance;        ///< Retirements since the last advance
+      char pad[64];                ///< Keeps states of records off each
+                                   ///< other's cache lines
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Thread local owner of a record, gives it back at thread exit
+    ////////////////////////////////////////////////////////////////////////////
+    struct owner {
+      owner() : r(acquire()) {}
+      ~owner() {
+        try_advance();
+        free_expired(r);
+        r->in_use.store(false, std::memory_order_release);
+      }
+      record* r; ///< Owned record
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @return Global epoch
+    static std::atomic<uint64_t>& global() {
+      static std::atomic<uint64_t> e(0);
+      return e;
+    }
+    /// @return Head of the list of all records
+    static std::atomic<record*>& records() {
+      static std::atomic<record*> head(nullptr);
+      return head;
+    }
+    /// @return Record of the calling thread
+    static record* local() {
+      static thread_local owner o;
+      return o.r;
+    }
+
+    /// @return Unused record of an exited thread, or a new one
+    static record* acquire() {
+      for(record* r = records().load(); r; r = r->next) {
+        bool f = false;
+        if(!r->in_use.load() && r->in_use.compare_exchange_strong(f, true))
+          return r;
+      }
+      record* r = new record();
+      r->state.store(0);
+      r->in_use.store(true);
+      r->depth = 0;
+      r->limbo_head = r->limbo_tail = nullptr;
+      r->since_advance = 0;
+      r->next = records().load();
+      while(!records().compare_exchange_weak(r->next, r));
+      return r;
+    }
+
+    /// @brief Advance the global epoch if every pinned thread has observed it
+    static void try_advance() {
+      uint64_t e = global().load();
+      for(record* r = records().load(); r; r = r->next) {
+        uint64_t s = r->state.load();
+        if((s & 1) && s >> 1 != e)
+          return;
+      }
+      global().compare_exchange_strong(e, e + 1);
+    }
+
+    /// @brief Free the objects of \c r retired two or more epochs ago
+    /// @return Number of objects freed
+    static size_t free_expired(record* r) {
+      uint64_t e = global().load();
+      size_t freed = 0;
+      while(r->limbo_head && r->limbo_head->retired_epoch + 2 <= e) {
+        epoch_node* n = r->limbo_head;
+        r->limbo_head = n->retired_next;
+        n->reclaim(n);
+        ++freed;
+      }
+      if(!r->limbo_head)
+        r->limbo_tail = nullptr;
+      return freed;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    static const size_t retire_batch = 64; ///< Retirements between advances
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
@@ -0,0 +1,391 @@
+#ifndef _FLAT_MAP_H_
+#define _FLAT_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Key layout of flat_map
+/// @ingroup MySTL
+////////////////////////////////////////////////////////////////////////////////
+enum class flat_layout {
+  sorted,   ///< Keys in ascending order, searched by a branchless binary
+            ///< search prefetching both possible midpoints of the next step
+  eytzinger ///< Keys in breadth first order of the implicit search tree, the
+            ///< children of position i at 2i and 2i + 1. The positions a
+            ///< search reaches four levels further down are adjacent, so one
+            ///< prefetch per step covers them and the misses of four levels
+            ///< overlap.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Read-optimized map stored in contiguous arrays, built in bulk
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Value Value type
+/// @tparam Layout Order of the keys in their array
+///
+/// Keys and values are held in two separate arrays in the same order, so a
+/// search only touches keys and fetches a single value at the end. The key
+/// array is aligned to a cache line. The contents are replaced as a whole
+/// with assign, e.g., from a map, there is no insertion or erasure of single
+/// entries. Lookups are O(log n) without a single data dependent branch.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value,
+  flat_layout Layout = flat_layout::eytzinger>
+class flat_map {
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    flat_map() : mem(nullptr), keys(nullptr), sz(0) {}
+    /// @brief Range constructor
+    /// @tparam InputIterator Input iterator over Key, Value pairs
+    /// @param first Start of range
+    /// @param last End of range
+    ///
+    /// See assign.
+    template<typename InputIterator>
+      flat_map(InputIterator first, InputIterator last) :
+        mem(nullptr), keys(nullptr), sz(0) {
+        assign(first, last);
+      }
+    /// @brief Copy constructor
+    /// @param m Other map
+    flat_map(const flat_map& m) : mem(nullptr), keys(nullptr), sz(0) {
+      copy(m);
+    }
+    /// @brief Destructor
+    ~flat_map() {
+      release();
+    }
+
+    /// @brief Copy assignment
+    /// @param m Other map
+    /// @return Reference to self
+    flat_map& operator=(const flat_map& m) {
+      if(this != &m) {
+        release();
+        copy(m);
+      }
+      return *this;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of map
+    size_t size() const {return sz;}
+    /// @return Does the map contain anything?
+    bool empty() const {return sz == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    Value& at(const Key& k) {
+      Value* v = find(k);
+      if(!v)
+        throw std::out_of_range("out of range");
+      return *v;
+    }
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    const Value& at(const Key& k) const {
+      const Value* v = find(k);
+      if(!v)
+        throw std::out_of_range("out of range");
+      return *v;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Replace the contents with the entries of a range
+    /// @tparam InputIterator Input iterator over Key, Value pairs
+    /// @param first Start of range
+    /// @param last End of range
+    ///
+    /// Of entries with equal keys the first one is kept, as if inserted in
+    /// order into a map. O(n) when the range is sorted by key, e.g., the
+    /// entries of a map, O(n log n) otherwise.
+    template<typename InputIterator>
+      void assign(InputIterator first, InputIterator last) {
+        std::vector<std::pair<Key, Value>> e;
+        for(; first != last; ++first)
+          e.push_back(std::pair<Key, Value>(first->first, first->second));
+        auto less = [](const std::pair<Key, Value>& a,
+            const std::pair<Key, Value>& b) {return a.first < b.first;};
+        if(!std::is_sorted(e.begin(), e.end(), less))
+          std::stable_sort(e.begin(), e.end(), less);
+        auto equal = [](const std::pair<Key, Value>& a,
+            const std::pair<Key, Value>& b) {
+          return !(a.first < b.first) && !(b.first < a.first);};
+        e.erase(std::unique(e.begin(), e.end(), equal), e.end());
+        release();
+        build(e);
+      }
+    /// @brief Remove all elements
+    void clear() {
+      release();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Pointer to its value if found, nullptr otherwise
+    Value* find(const Key& k) {
+      size_t i = finder(k);
+      return i == npos ? nullptr : &values[i - first_pos];
+    }
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Pointer to its value if found, nullptr otherwise
+    const Value* find(const Key& k) const {
+      size_t i = finder(k);
+      return i == npos ? nullptr : &values[i - first_pos];
+    }
+
+    /// @brief Count elements with specific keys
+    /// @param k Key
+    /// @return Count of elements with key \c k, 0 or 1
+    size_t count(const Key& k) const {
+      return finder(k) == npos ? 0 : 1;
+    }
+
+    /// @brief Call \c f on every entry in ascending key order
+    /// @tparam Function Callable as f(const Key&, Value&)
+    /// @param f Function
+    template<typename Function>
+      void for_each(Function f) {
+        for(size_t i = leftmost(); i != npos; i = next(i))
+          f(keys[i], values[i - first_pos]);
+      }
+    /// @brief Call \c f on every entry in ascending key order
+    /// @tparam Function Callable as f(const Key&, const Value&)
+    /// @param f Function
+    template<typename Function>
+      void for_each(Function f) const {
+        for(size_t i = leftmost(); i != npos; i = next(i))
+          f(keys[i], values[i - first_pos]);
+      }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    static const bool eytzinger =
+      Layout == flat_layout::eytzinger;         ///< Eytzinger layout?
+    static const size_t npos = size_t(-1);      ///< No position
+    static const size_t first_pos = eytzinger;  ///< Position of the first
+                                                ///< key, the Eytzinger root
+                                                ///< is 1
+    static const size_t line = 64;              ///< Cache line size
+    static const size_t cached = 16384;         ///< Bytes of keys assumed to
+                                                ///< stay in the first level
+                                                ///< cache
+
+    /// @return Keys per prefetch of the Eytzinger search, a power of two
+    ///         whose keys fit a cache line, so that the positions 2^d i to
+    ///         2^d i + 2^d - 1 the search may reach d levels down share one
+    static constexpr size_t stride(size_t s = 1) {
+      return 2*s*sizeof(Key) > line ? s : stride(2*s);
+    }
+
+    /// @brief Prefetch the key at position \c i, which may be past the end
+    void prefetch(size_t i) const {
+      __builtin_prefetch(reinterpret_cast<const char*>(keys) +
+          i*sizeof(Key));
+    }
+
+    /// @brief Utility for finding an entry with key \c k
+    /// @return Position of \c k, or npos if it does not exist
+    size_t finder(const Key& k) const {
+      return eytzinger ? eytzinger_finder(k) : sorted_finder(k);
+    }
+
+    /// @brief Branchless binary search of the sorted keys
+    ///
+    /// The comparison selects the next base with a conditional move instead
+    /// of a jump. While the remaining range is larger than the first level
+    /// cache, the two midpoints the next step may look at are prefetched
+    /// while it waits for the current one. Below that the prefetches only
+    /// lengthen each step.
+    size_t sorted_finder(const Key& k) const {
+      if(sz == 0)
+        return npos;
+      const Key* base = keys;
+      size_t len = sz;
+      while(len*sizeof(Key) > cached) {
+        size_t half = len/2;
+        len -= half;
+        prefetch(base - keys + len/2);
+        prefetch(base - keys + half + len/2);
+        base = base[half] < k ? base + half : base;
+      }
+      while(len > 1) {
+        size_t half = len/2;
+        len -= half;
+        base = base[half] < k ? base + half : base;
+      }
+      size_t i = base - keys + (*base < k);
+      return i < sz && !(k < keys[i]) ? i : size_t(npos);
+    }
+
+    /// @brief Branchless search of the Eytzinger ordered keys
+    ///
+    /// Descends to the right child exactly when the key at hand is less than
+    /// \c k, until it falls off the tree. The last left turn was at the
+    /// lower bound of \c k, undone by dropping the trailing ones and one zero
+    /// of the final position.
+    size_t eytzinger_finder(const Key& k) const {
+      size_t i = 1;
+      while(i <= sz) {
+        prefetch(stride()*i);
+        i = 2*i + (keys[i] < k);
+      }
+      i >>= __builtin_ctzll(~static_cast<unsigned long long>(i)) + 1;
+      return i != 0 && !(k < keys[i]) ? i : size_t(npos);
+    }
+
+    /// @return Position of the least key, npos if empty
+    size_t leftmost() const {
+      if(sz == 0)
+        return npos;
+      if(!eytzinger)
+        return 0;
+      size_t i = 1;
+      while(2*i <= sz)
+        i *= 2;
+      return i;
+    }
+    /// @return Position of the key following the one at \c i, npos if none
+    size_t next(size_t i) const {
+      if(!eytzinger)
+        return i + 1 < sz ? i + 1 : size_t(npos);
+      if(2*i + 1 <= sz) {
+        i = 2*i + 1;
+        while(2*i <= sz)
+          i *= 2;
+        return i;
+      }
+      while(i & 1)
+        i >>= 1;
+      i >>= 1;
+      return i != 0 ? i : size_t(npos);
+    }
+
+    /// @brief Lay out the sorted, distinct entries \c e
+    void build(std::vector<std::pair<Key, Value>>& e) {
+      allocate(e.size());
+      std::vector<size_t> rank(sz + first_pos);
+      size_t r = 0;
+      for(size_t i = leftmost(); i != npos; i = next(i))
+        rank[i] = r++;
+      values.reserve(sz);
+      for(size_t i = first_pos; i < sz + first_pos; ++i) {
+        ::new(keys + i) Key(std::move(e[rank[i]].first));
+        values.push_back(std::move(e[rank[i]].second));
+      }
+    }
+
+    /// @brief Take \c n uninitialized key slots, aligned to a cache line
+    void allocate(size_t n) {
+      mem = ::operator new((n + first_pos)*sizeof(Key) + line);
+      uintptr_t a = reinterpret_cast<uintptr_t>(mem);
+      keys = reinterpret_cast<Key*>((a + line - 1) & ~uintptr_t(line - 1));
+      sz = n;
+    }
+
+    /// @brief Copy the entries of \c m, which has the same layout
+    void copy(const flat_map& m) {
+      allocate(m.sz);
+      for(size_t i = first_pos; i < sz + first_pos; ++i)
+        ::new(keys + i) Key(m.keys[i]);
+      values = m.values;
+    }
+
+    /// @brief Destroy all entries and free the keys
+    void release() {
+      for(size_t i = first_pos; i < sz + first_pos; ++i)
+        keys[i].~Key();
+      ::operator delete(mem);
+      mem = nullptr;
+      keys = nullptr;
+      sz = 0;
+      values.clear();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    void* mem;                 ///< Allocation holding the keys
+    Key* keys;                 ///< Keys in Layout order, from first_pos
+    size_t sz;                 ///< Number of entries
+    std::vector<Value> values; ///< Value of the key at position i at
+                               ///< i - first_pos
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
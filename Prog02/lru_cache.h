@@ -0,0 +1,622 @@
+#ifndef _LRU_CACHE_H_
+#define _LRU_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "node_pool.h"
+#include "unordered_map.h"
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Fixed capacity cache evicting the least recently used entry
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Value Value type
+/// @tparam Hash Hash function object type
+///
+/// Entries live in pool nodes that double as the links of an intrusive
+/// recency list, most recent first, and a hash table maps each key to its
+/// node. get, put, erase and eviction are O(1) expected, a touch relinks a
+/// single node and a miss allocates nothing but the pool slot of the new
+/// entry.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value, class Hash = std::hash<Key>>
+class lru_cache {
+
+  struct link;  ///< Forward declare list link class
+  struct entry; ///< Forward declare entry class
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    /// @param c Most entries held at once
+    lru_cache(size_t c) : cap(c) {
+      head.prev = head.next = &head;
+      index.reserve(c);
+    }
+
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    /// @brief Destructor
+    ~lru_cache() {
+      clear();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Number of entries
+    size_t size() const {return index.size();}
+    /// @return Most entries held at once
+    size_t capacity() const {return cap;}
+    /// @return Does the cache contain anything?
+    bool empty() const {return index.empty();}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @brief Look up \c k and make it the most recently used entry
+    /// @param k Key
+    /// @return Value at \c k, nullptr if absent. Valid until the entry is
+    ///         evicted or erased.
+    Value* get(const Key& k) {
+      auto i = index.find(k);
+      if(i == index.end())
+        return nullptr;
+      entry* e = i->second;
+      unlink(e);
+      push_front(e);
+      return &e->value.second;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Assign \c v to \c k, inserting it if absent, and make it the
+    ///        most recently used entry
+    /// @param k Key
+    /// @param v Value
+    ///
+    /// Inserting into a full cache first evicts the least recently used
+    /// entry.
+    void put(const Key& k, const Value& v) {
+      if(cap == 0)
+        return;
+      auto i = index.find(k);
+      if(i != index.end()) {
+        entry* e = i->second;
+        e->value.second = v;
+        unlink(e);
+        push_front(e);
+        return;
+      }
+      if(index.size() == cap)
+        evict();
+      entry* e = pool.create(k, v);
+      push_front(e);
+      index.try_emplace(k, e);
+    }
+    /// @brief Remove \c k
+    /// @param k Key
+    /// @return Number of entries removed, 0 or 1
+    size_t erase(const Key& k) {
+      auto i = index.find(k);
+      if(i == index.end())
+        return 0;
+      entry* e = i->second;
+      index.erase(k);
+      unlink(e);
+      pool.destroy(e);
+      return 1;
+    }
+    /// @brief Remove all entries
+    void clear() {
+      for(link* l = head.next; l != &head;) {
+        link* next = l->next;
+        pool.destroy(static_cast<entry*>(l));
+        l = next;
+      }
+      head.prev = head.next = &head;
+      index.clear();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @param k Key
+    /// @return Is \c k cached? Leaves its recency unchanged
+    bool contains(const Key& k) const {return index.count(k) != 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @brief Unlink \c l from the recency list
+    static void unlink(link* l) {
+      l->prev->next = l->next;
+      l->next->prev = l->prev;
+    }
+    /// @brief Link \c l at the front of the recency list
+    void push_front(link* l) {
+      l->prev = &head;
+      l->next = head.next;
+      head.next->prev = l;
+      head.next = l;
+    }
+    /// @brief Remove the least recently used entry
+    void evict() {
+      entry* e = static_cast<entry*>(head.prev);
+      index.erase(e->value.first);
+      unlink(e);
+      pool.destroy(e);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Link of the recency list, the sentinel is a bare link
+    ////////////////////////////////////////////////////////////////////////////
+    struct link {
+      link* prev; ///< More recently used entry
+      link* next; ///< Less recently used entry
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Cached entry
+    ////////////////////////////////////////////////////////////////////////////
+    struct entry : public link {
+      /// @brief Constructor
+      /// @param k Key
+      /// @param v Value
+      entry(const Key& k, const Value& v) : value(k, v) {}
+
+      std::pair<const Key, Value> value; ///< Key and value
+    };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    node_pool<entry> pool;                      ///< Storage of entries
+    unordered_map<Key, entry*, Hash> index;     ///< Entry of each key
+    link head;                                  ///< Sentinel of the recency
+                                                ///< list
+    size_t cap;                                 ///< Most entries held
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Fixed capacity cache approximating LRU with the CLOCK algorithm
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Value Value type
+/// @tparam Hash Hash function object type
+///
+/// Entries sit in a circular array of slots, each with a referenced bit, and a
+/// hash table maps each key to its slot. A hit only sets the bit, so unlike
+/// lru_cache it writes no links and touches no other entry. To evict, a hand
+/// sweeps the slots, clearing set bits, and takes the first slot whose bit
+/// was already clear, every entry hit since the last sweep gets a second
+/// chance. O(1) amortized.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value, class Hash = std::hash<Key>>
+class clock_cache {
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    /// @param c Most entries held at once
+    clock_cache(size_t c) : hand(0), cap(c) {
+      slots.reserve(c);
+      index.reserve(c);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Number of entries
+    size_t size() const {return index.size();}
+    /// @return Most entries held at once
+    size_t capacity() const {return cap;}
+    /// @return Does the cache contain anything?
+    bool empty() const {return index.empty();}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @brief Look up \c k and mark it referenced
+    /// @param k Key
+    /// @return Value at \c k, nullptr if absent. Valid until the entry is
+    ///         evicted or erased.
+    Value* get(const Key& k) {
+      auto i = index.find(k);
+      if(i == index.end())
+        return nullptr;
+      slot& s = slots[i->second];
+      s.referenced = true;
+      return &s.value.second;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Assign \c v to \c k, inserting it if absent
+    /// @param k Key
+    /// @param v Value
+    ///
+    /// An existing key is marked referenced. A new one takes a free slot, or
+    /// evicts the entry under the hand in a full cache, and starts
+    /// unreferenced.
+    void put(const Key& k, const Value& v) {
+      if(cap == 0)
+        return;
+      auto i = index.find(k);
+      if(i != index.end()) {
+        slot& s = slots[i->second];
+        s.value.second = v;
+        s.referenced = true;
+        return;
+      }
+      size_t j;
+      if(!free_slots.empty()) {
+        j = free_slots.back();
+        free_slots.pop_back();
+        slots[j].value = std::make_pair(k, v);
+      }
+      else if(slots.size() < cap) {
+        j = slots.size();
+        slots.push_back(slot{std::make_pair(k, v), false});
+      }
+      else {
+        j = victim();
+        index.erase(slots[j].value.first);
+        slots[j].value = std::make_pair(k, v);
+      }
+      slots[j].referenced = false;
+      index.try_emplace(k, j);
+    }
+    /// @brief Remove \c k
+    /// @param k Key
+    /// @return Number of entries removed, 0 or 1
+    ///
+    /// The slot is reused by the next insertion, its old entry is only
+    /// overwritten then.
+    size_t erase(const Key& k) {
+      auto i = index.find(k);
+      if(i == index.end())
+        return 0;
+      free_slots.push_back(i->second);
+      index.erase(k);
+      return 1;
+    }
+    /// @brief Remove all entries
+    void clear() {
+      slots.clear();
+      free_slots.clear();
+      index.clear();
+      hand = 0;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @param k Key
+    /// @return Is \c k cached? Leaves its referenced bit unchanged
+    bool contains(const Key& k) const {return index.count(k) != 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @brief Sweep the hand to the next unreferenced slot of a full cache
+    /// @return Slot to evict
+    size_t victim() {
+      while(slots[hand].referenced) {
+        slots[hand].referenced = false;
+        hand = hand + 1 == cap ? 0 : hand + 1;
+      }
+      size_t j = hand;
+      hand = hand + 1 == cap ? 0 : hand + 1;
+      return j;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Cached entry and its referenced bit
+    ////////////////////////////////////////////////////////////////////////////
+    struct slot {
+      std::pair<Key, Value> value; ///< Key and value
+      bool referenced;             ///< Hit since the hand last passed?
+    };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    std::vector<slot> slots;                ///< Entries in clock order
+    std::vector<size_t> free_slots;         ///< Slots of erased entries
+    unordered_map<Key, size_t, Hash> index; ///< Slot of each key
+    size_t hand;                            ///< Next slot to sweep
+    size_t cap;                             ///< Most entries held
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Cache safe for concurrent use, split into independently locked
+///        shards
+/// @ingroup MySTL
+/// @tparam Cache Cache type of a shard, lru_cache or clock_cache
+/// @tparam Hash Hash function object type selecting the shard of a key
+///
+/// Each key belongs to one shard, chosen by its hash, and every operation
+/// locks only that shard, so threads working on different shards never wait
+/// for each other. Eviction is per shard, each holds an equal share of the
+/// capacity. Values are returned by copy, as another thread may evict an
+/// entry right after the lock is released.
+////////////////////////////////////////////////////////////////////////////////
+template<class Cache,
+  class Hash = std::hash<typename Cache::key_type>>
+class sharded_cache {
+
+  struct shard; ///< Forward declare shard class
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef typename Cache::key_type key_type;       ///< Key type
+    typedef typename Cache::mapped_type mapped_type; ///< Value type
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    /// @param c Most entries held at once, rounded up to a multiple of the
+    ///        number of shards
+    /// @param n Number of shards, rounded up to a power of two
+    sharded_cache(size_t c, size_t n = 16) : nshards(1), shift(64) {
+      while(nshards < n) {
+        nshards *= 2;
+        --shift;
+      }
+      shards = static_cast<shard*>(::operator new(nshards*sizeof(shard)));
+      for(size_t i = 0; i < nshards; ++i)
+        new(shards + i) shard((c + nshards - 1)/nshards);
+    }
+
+    sharded_cache(const sharded_cache&) = delete;
+    sharded_cache& operator=(const sharded_cache&) = delete;
+
+    /// @brief Destructor, no other thread may use the cache anymore
+    ~sharded_cache() {
+      for(size_t i = 0; i < nshards; ++i)
+        shards[i].~shard();
+      ::operator delete(shards);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Number of entries, each shard counted at a different moment
+    size_t size() const {
+      size_t s = 0;
+      for(size_t i = 0; i < nshards; ++i) {
+        std::lock_guard<std::mutex> l(shards[i].lock);
+        s += shards[i].cache.size();
+      }
+      return s;
+    }
+    /// @return Most entries held at once
+    size_t capacity() const {return nshards*shards[0].cache.capacity();}
+    /// @return Number of shards
+    size_t shard_count() const {return nshards;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @brief Look up \c k, counting it as used
+    /// @param k Key
+    /// @param[out] v Value at \c k, unchanged if absent
+    /// @return Was \c k present?
+    bool get(const key_type& k, mapped_type& v) {
+      shard& s = shard_of(k);
+      std::lock_guard<std::mutex> l(s.lock);
+      const mapped_type* p = s.cache.get(k);
+      if(p)
+        v = *p;
+      return p != nullptr;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Assign \c v to \c k, inserting it if absent
+    /// @param k Key
+    /// @param v Value
+    void put(const key_type& k, const mapped_type& v) {
+      shard& s = shard_of(k);
+      std::lock_guard<std::mutex> l(s.lock);
+      s.cache.put(k, v);
+    }
+    /// @brief Remove \c k
+    /// @param k Key
+    /// @return Number of entries removed, 0 or 1
+    size_t erase(const key_type& k) {
+      shard& s = shard_of(k);
+      std::lock_guard<std::mutex> l(s.lock);
+      return s.cache.erase(k);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @return Shard of key \c k, from the top bits of its hash times a
+    ///         constant the shard's own hash table does not use
+    shard& shard_of(const key_type& k) const {
+      const uint64_t m = 0xD6E8FEB86659FD93ull;
+      return shards[nshards == 1 ? 0 : uint64_t(hash(k))*m >> shift];
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Cache and its lock, padded so neighboring shards do not share a
+    ///        cache line
+    ////////////////////////////////////////////////////////////////////////////
+    struct shard {
+      /// @brief Constructor
+      /// @param c Capacity
+      shard(size_t c) : cache(c) {}
+
+      mutable std::mutex lock; ///< Lock of the cache
+      Cache cache;             ///< Entries of the shard
+      char pad[64];            ///< Padding
+    };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    shard* shards;  ///< Shards
+    size_t nshards; ///< Number of shards, a power of two
+    size_t shift;   ///< Right shift leaving the shard bits of a hash
+    Hash hash;      ///< Hash function
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
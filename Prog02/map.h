@@ -3,27 +3,68 @@
 
 #include <iterator>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#include "bloom_filter.h"
+#include "node_pool.h"
 
-#include <iostream>
-using std::cout;
 namespace mystl {
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Balancing strategy of map
+/// @ingroup MySTL
+////////////////////////////////////////////////////////////////////////////////
+enum class map_balance {
+  none,      ///< Plain binary search tree, height may degrade to O(n)
+  red_black, ///< Red-black tree, height is guaranteed O(log n)
+  splay      ///< Semi-splay tree, every lookup and insertion moves the node
+             ///< it reaches toward the root, so frequently used keys stay
+             ///< near the top. O(log n) amortized. Const lookups restructure
+             ///< the tree too, so concurrent readers need a lock.
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Map ADT based on C++ map implemented with binary search tree
 /// @ingroup MySTL
 /// @tparam Key Key type
 /// @tparam Value Value type
+/// @tparam Balance Balancing strategy of the tree
+/// @tparam Threaded Thread the nodes on in-order successor and predecessor
+///         links, so iterators step in O(1) through a single pointer. Costs
+///         two pointers per node and their upkeep on every update.
+/// @tparam Filtered Keep a Bloom filter of the keys, so that most lookups of
+///         missing keys return without touching the tree. Needs std::hash of
+///         Key. Erased keys stay in the filter until it is rebuilt, which
+///         happens once the erasures since the last build reach a quarter of
+///         the entries, or the entries outgrow it.
+/// @tparam Sized Keep the number of nodes of its subtree in every node, which
+///         rank, select, count_range and the set operations rely on. Every
+///         insertion and erasure walks up to the root to update them, so a
+///         hinted insertion costs O(height). Without sizes those functions do
+///         not compile, and a hinted insertion at the right place is O(1)
+///         amortized.
+///
+/// The leftmost and rightmost nodes are cached, begin() is O(1) and inserts
+/// past either end skip the search.
 ///
 /// Assumes the following: There is always enough memory for allocations (not a
 /// good assumption, just good enough for our purposes); Functions not
 /// well-defined on an empty container will exhibit undefined behavior.
 ////////////////////////////////////////////////////////////////////////////////
-template<typename Key, typename Value>
+template<typename Key, typename Value,
+  map_balance Balance = map_balance::red_black, bool Threaded = false,
+  bool Filtered = false, bool Sized = true>
 class map {
 
   class node;           ///< Forward declare node class
+  struct subtree;       ///< Forward declare detached tree class
+  struct thread_links;  ///< Forward declare in-order links class
+  struct no_links;      ///< Forward declare empty links class
+  struct no_filter;     ///< Forward declare empty filter class
   template<typename>
     class map_iterator; ///< Forward declare iterator class
 
@@ -54,16 +95,33 @@ class map {
     /// @{
 
     /// @brief Constructor
-    map() : root(new node()), sz(0) {
-      root->expand();
+    map() : root(pool.create()), sz(0) {
+      relink();
     }
     /// @brief Copy constructor
     /// @param m Other map
-    map(const map& m) : root(new node(*m.root)), sz(m.sz) {
+    map(const map& m) : root(pool.create()), sz(0) {
+      copy(m);
+      relink();
     }
+    /// @brief Range constructor
+    /// @tparam InputIterator Input iterator over Key, Value pairs
+    /// @param first Start of range
+    /// @param last End of range
+    ///
+    /// Linear time when the range is sorted by key, see insert_sorted.
+    template<typename InputIterator>
+      map(InputIterator first, InputIterator last) :
+        root(pool.create()), sz(0) {
+        relink();
+        insert_sorted(first, last);
+      }
     /// @brief Destructor
+    ///
+    /// The pool frees all nodes block by block, the tree is only walked when
+    /// the entries have destructors to run.
     ~map() {
-      delete root;
+      destroy_values();
     }
 
     /// @brief Copy assignment
@@ -71,9 +129,9 @@ class map {
     /// @return Reference to self
     map& operator=(const map& m) {
 		if(this != &m) {
-			delete root;
-			root = new node(*m.root);
-			sz = m.sz;
+			clear();
+			copy(m);
+			relink();
 		}
 		return *this;
 	}
@@ -86,21 +144,21 @@ class map {
     /// @{
 
     /// @return Iterator to beginning
-    iterator begin() {return iterator(root->leftmost());}
+    iterator begin() {return iterator(leftmost_node);}
     /// @return Iterator to end
     iterator end() {return iterator(root);}
     /// @return Iterator to reverse beginning
     reverse_iterator rbegin() {return reverse_iterator(root);}
     /// @return Iterator to reverse end
-    reverse_iterator rend() {return reverse_iterator(root->leftmost());}
+    reverse_iterator rend() {return reverse_iterator(leftmost_node);}
     /// @return Iterator to beginning
-    const_iterator cbegin() const {return const_iterator(root->leftmost());}
+    const_iterator cbegin() const {return const_iterator(leftmost_node);}
     /// @return Iterator to end
     const_iterator cend() const {return const_iterator(root);}
     /// @return Iterator to reverse beginning
     const_reverse_iterator crbegin() const {return const_reverse_iterator(root);}
     /// @return Iterator to reverse end
-    const_reverse_iterator crend() const {return const_reverse_iterator(root->leftmost());}
+    const_reverse_iterator crend() const {return const_reverse_iterator(leftmost_node);}
 
     /// @}
     ////////////////////////////////////////////////////////////////////////////
@@ -130,11 +188,15 @@ class map {
     /// If \c k is not found in the container, the function should insert a new
     /// element with that key and return a reference to its mapped value
     /// (constructed through default construction)
+    ///
+    /// Nothing is constructed or allocated when \c k already exists.
     Value& operator[](const Key& k) {
-      /// @todo implement at function. Utilize inserter function.
-	 node* temp=new node(std::make_pair(k,mapped_type()));
-	 std::pair<node*, bool> pair=inserter(temp->value);
-     return pair.first->value.second;
+      return try_emplace(k).first->second;
+    }
+    /// @param k Input key, moved from only if it is inserted
+    /// @return Value at given key
+    Value& operator[](Key&& k) {
+      return try_emplace(std::move(k)).first->second;
     }
 
     /// @param k Input key
@@ -190,39 +252,284 @@ class map {
       std::pair<node*, bool> n = inserter(v);
 	  return std::make_pair(iterator(n.first), n.second);
     }
+    /// @brief Insert element constructed from \c args if its key is absent
+    /// @tparam Args Argument types of a value_type constructor
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    ///
+    /// The element is built on the stack to learn its key and is moved into a
+    /// new node only if the key is absent, so an existing key costs no
+    /// allocation.
+    template<typename... Args>
+      std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type v(std::forward<Args>(args)...);
+        node* par;
+        node** link;
+        node* pos = locate(v.first, par, link);
+        if(pos)
+          return std::make_pair(iterator(pos), false);
+        return std::make_pair(
+            iterator(attach(pool.create(std::move(v)), par, link)), true);
+      }
+    /// @brief Insert element with key \c k and value constructed from \c args
+    ///        if \c k is absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam Args Argument types of a Value constructor
+    /// @param k Key
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    ///
+    /// Neither \c k nor \c args are touched when \c k exists.
+    template<typename K, typename... Args>
+      std::pair<iterator, bool> try_emplace(K&& k, Args&&... args) {
+        node* par;
+        node** link;
+        node* pos = locate(k, par, link);
+        if(pos)
+          return std::make_pair(iterator(pos), false);
+        pos = pool.create(std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(k)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(iterator(attach(pos, par, link)), true);
+      }
+    /// @brief Assign \c obj to the value at \c k, inserting \c k if absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam M Value argument type
+    /// @param k Key
+    /// @param obj Value
+    /// @return pair of iterator and bool. bool is true if a new element was
+    ///         inserted and false if an existing one was assigned.
+    template<typename K, typename M>
+      std::pair<iterator, bool> insert_or_assign(K&& k, M&& obj) {
+        node* par;
+        node** link;
+        node* pos = locate(k, par, link);
+        if(pos) {
+          pos->value.second = std::forward<M>(obj);
+          return std::make_pair(iterator(pos), false);
+        }
+        pos = pool.create(std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(k)),
+            std::forward_as_tuple(std::forward<M>(obj)));
+        return std::make_pair(iterator(attach(pos, par, link)), true);
+      }
+    /// @brief Insert element, searching from \c hint
+    /// @param hint Position the key is expected to go just before
+    /// @param v Key, Value pair
+    /// @return Iterator pointing to inserted or already existing element
+    ///
+    /// Finding the position is O(1) amortized when the key belongs just
+    /// before or just after \c hint, otherwise a finger search from \c hint,
+    /// see insert_near. Without subtree sizes (\c Sized false) the insertion
+    /// is then O(1) amortized too, so feeding back the returned iterator makes
+    /// a sorted stream linear. With them it walks up to the root to update
+    /// them, O(height).
+    iterator insert(const_iterator hint, const value_type& v) {
+      node* par;
+      node** link;
+      node* pos = locate_near(hint.n, v.first, par, link);
+      if(pos)
+        return iterator(pos);
+      return iterator(attach(pool.create(v), par, link));
+    }
+    /// @brief Insert element constructed from \c args if its key is absent,
+    ///        searching from \c hint
+    /// @tparam Args Argument types of a value_type constructor
+    /// @param hint Position the key is expected to go just before
+    /// @param args Arguments
+    /// @return Iterator as in insert with a hint
+    template<typename... Args>
+      iterator emplace_hint(const_iterator hint, Args&&... args) {
+        value_type v(std::forward<Args>(args)...);
+        node* par;
+        node** link;
+        node* pos = locate_near(hint.n, v.first, par, link);
+        if(pos)
+          return iterator(pos);
+        return iterator(attach(pool.create(std::move(v)), par, link));
+      }
+    /// @brief Insert element, searching up then down from the last inserted
+    ///        one
+    /// @param v Key, Value pair
+    /// @return pair of iterator and bool as in insert
+    ///
+    /// The search climbs from the last inserted node until its subtree spans
+    /// the key and descends from there, about 2 log d steps for a key d
+    /// positions away and O(log n) at worst. Suits nearly sorted or clustered
+    /// keys without threading a hint through the caller. Subtree sizes cost
+    /// O(height) on top as with a hinted insert.
+    std::pair<iterator, bool> insert_near(const value_type& v) {
+      node* par;
+      node** link;
+      node* pos = locate_near(finger, v.first, par, link);
+      if(pos)
+        return std::make_pair(iterator(pos), false);
+      return std::make_pair(
+          iterator(attach(pool.create(v), par, link)), true);
+    }
+    /// @brief Insert the elements of a range sorted by key
+    /// @tparam InputIterator Input iterator over Key, Value pairs
+    /// @param first Start of range
+    /// @param last End of range
+    ///
+    /// Nodes for the range are created in a single pass and chained in order,
+    /// merged with the chain of existing entries, and linked bottom up into a
+    /// perfectly balanced tree, O(n + m) for n existing entries and m new
+    /// ones. A range that is small next to the map is inserted one element at
+    /// a time instead, O(m log n). As with insert, a key already present or
+    /// repeated in the range keeps its first value. Elements out of order are
+    /// still inserted, one by one after the sorted ones.
+    template<typename InputIterator>
+      void insert_sorted(InputIterator first, InputIterator last) {
+        node* chain = nullptr;
+        node** tail = &chain;
+        node* last_node = nullptr;
+        node* stray = nullptr;
+        node** stray_tail = &stray;
+        size_t m = 0;
+        for(; first != last; ++first) {
+          node* x = pool.create(*first);
+          if(!last_node || last_node->value.first < x->value.first) {
+            *tail = last_node = x;
+            tail = &x->right;
+            ++m;
+          }
+          else if(x->value.first < last_node->value.first) {
+            *stray_tail = x;
+            stray_tail = &x->right;
+          }
+          else
+            pool.destroy(x);
+        }
+
+        if(m*log2_floor(sz + m) < sz)
+          place_all(chain);
+        else {
+          size_t n;
+          chain = merge(unravel(), chain, n);
+          root->left = build(chain, n, 0,
+              ((n + 1) & n) == 0 ? size_t(-1) : log2_floor(n));
+          if(root->left)
+            root->left->parent = root;
+          sz = n;
+          relink();
+        }
+        place_all(stray);
+      }
+    /// @brief Remove all elements
+    ///
+    /// O(blocks) for trivially destructible entries, otherwise O(n) to run
+    /// their destructors.
+    void clear() {
+      destroy_values();
+      pool.release();
+      root = pool.create();
+      sz = 0;
+      relink();
+    }
     /// @brief Remove element at specified position
     /// @param position Position
     /// @return Position of new location of element which was after eliminated
     ///         one
-      iterator erase(const_iterator position) {
-      /// @todo Implement erase. Utilize eraser helper.
-	   	  node* v=finder((*position).first);
-	  if(v->is_external()){
-		  cout<<"Non Existent Element";
-		  return end();
-	  }
-	  else{
-	  iterator m(eraser(v));
-	  return m;
-	  } 
+    iterator erase(const_iterator position) {
+      return iterator(eraser(position.n));
     }
     /// @brief Remove element at specified position
     /// @param k Key
     /// @return Number of elements removed (in this case it is at most 1)
     size_t erase(const Key& k) {
-      /// @todo Implement erase. Utilize finder and eraser helpers.
-	        /// @todo Implement erase. Utilize finder and eraser helpers.
- 	  node* v=finder(k);
-	  if(v->is_external()){
-		  cout<<"Non Existent Element";
-		  return 0;
-	  }
-	  else{
-	  eraser(v);
-	  return 1;
-	  } 
+      node* v = finder(k);
+      if(!v)
+        return 0;
+      eraser(v);
+      return 1;
     }
 
+    /// @brief Add the elements of \c m whose keys are absent
+    /// @param m Other map
+    /// @param threads Most threads to work on it
+    ///
+    /// Join-based (Blelloch et al., Just Join for Parallel Ordered Sets): the
+    /// tree of \c m is copied, this tree is split by the key at its root, the
+    /// halves are united with its subtrees in parallel and the results are
+    /// joined back around the root. O(m log(n/m + 1)) work for m <= n
+    /// entries on top of the O(m) copy, O(log^2 n) span. As with insert, keys
+    /// already present keep their values.
+    void union_with(const map& m,
+        size_t threads = std::thread::hardware_concurrency()) {
+      if(&m == this)
+        return;
+      subtree t = take_tree();
+      copy(m);
+      std::vector<node*> added;
+      if(Threaded)
+        for(node* n = root->leftmost(); n != root; n = n->inorder_next())
+          added.push_back(n);
+      subtree c = take_tree();
+      std::vector<node*> discard;
+      put_tree(unite(t, c, discard, threads));
+      if(Threaded) {
+        //copied nodes are threaded in descending order, in front of their
+        //successors, which are threaded already. Discarded ones are marked
+        for(node* n : discard)
+          n->subtree_size = 0;
+        for(auto i = added.rbegin(); i != added.rend(); ++i)
+          if((*i)->subtree_size)
+            thread_before(*i, (*i)->inorder_next(), threaded());
+      }
+      for(node* n : discard)
+        pool.destroy(n);
+      if(Filtered)
+        for(node* n = m.leftmost_node; n != m.root; n = n->inorder_next())
+          filter_added(n->value.first);
+    }
+    /// @brief Remove the elements whose keys are absent from \c m
+    /// @param m Other map
+    /// @param threads Most threads to work on it
+    ///
+    /// Join-based like union_with, \c m is only read. O(m log(n/m + 1))
+    /// work to find the result, plus freeing the removed entries one by one.
+    void intersect_with(const map& m,
+        size_t threads = std::thread::hardware_concurrency()) {
+      if(&m == this)
+        return;
+      std::vector<node*> discard;
+      put_tree(intersect(take_tree(), m.root->left, discard, threads));
+      drop(discard);
+    }
+    /// @brief Remove the elements whose keys are present in \c m
+    /// @param m Other map
+    /// @param threads Most threads to work on it
+    ///
+    /// Join-based like union_with, \c m is only read. O(m log(n/m + 1))
+    /// work.
+    void difference(const map& m,
+        size_t threads = std::thread::hardware_concurrency()) {
+      if(&m == this) {
+        clear();
+        return;
+      }
+      std::vector<node*> discard;
+      put_tree(subtract(take_tree(), m.root->left, discard, threads));
+      drop(discard);
+    }
+    /// @brief Remove the elements for which \c keep is false
+    /// @tparam Pred Predicate on const value_type&
+    /// @param keep Predicate, called from several threads at once and must
+    ///             not throw
+    /// @param threads Most threads to work on it
+    ///
+    /// Both subtrees are filtered in parallel and joined around the root if
+    /// it is kept, O(n) work and O(log^2 n) span.
+    template<typename Pred>
+      void filter(Pred keep,
+          size_t threads = std::thread::hardware_concurrency()) {
+        std::vector<node*> discard;
+        subtree t = take_tree();
+        put_tree(filterer(t, keep, discard, threads));
+        drop(discard);
+      }
+
     /// @}
     ////////////////////////////////////////////////////////////////////////////
 
@@ -236,12 +543,7 @@ class map {
     iterator find(const Key& k) {
       /// @todo Implement find. Utilize the finder helper.
 	  node* pos=finder(k);
-	  iterator m(pos);
-	  if(pos->is_internal()){
-		  return m;
-	  }
-	  else
-      return end();
+	  return pos ? iterator(pos) : end();
     }
 
     /// @brief Search the container for an element with key \c k
@@ -249,13 +551,8 @@ class map {
     /// @return Iterator to position if found, cend() otherwise
     const_iterator find(const Key& k) const {
       /// @todo Implement find. Utilize the finder helper
-	    node* pos=finder(k);
-	  const_iterator m(pos);
-	  if(pos->is_internal()){
-		  return m;
-	  }
-	  else
-		return cend();
+	  node* pos=finder(k);
+	  return pos ? const_iterator(pos) : cend();
     }
 
     /// @brief Count elements with specific keys
@@ -266,12 +563,104 @@ class map {
     /// only return 1 or 0.
     size_t count(const Key& k) const {
       /// @todo Implement count. Utilize the find operation.
-	  if(finder(k)->is_external()){
-	  return 0;
-	  }
-	  else{
-      return 1;
-	  }
+	  return finder(k) ? 1 : 0;
+    }
+
+    /// @brief Search the container for the keys of a range
+    /// @tparam ForwardIterator Forward iterator over keys
+    /// @tparam OutputIterator Output iterator taking iterators
+    /// @param first Start of keys
+    /// @param last End of keys
+    /// @param out Receives for each key an iterator to its element, or end()
+    /// @return \c out past the last written iterator
+    ///
+    /// Lookups proceed in groups of batch_width, a level of every lookup of
+    /// the group per round, each prefetching the node it moves to. The cache
+    /// misses of a group then overlap instead of stalling one after another.
+    template<typename ForwardIterator, typename OutputIterator>
+      OutputIterator find_batch(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) {
+        return batch_finder<iterator>(first, last, out);
+      }
+    /// @brief Search the container for the keys of a range
+    /// @tparam ForwardIterator Forward iterator over keys
+    /// @tparam OutputIterator Output iterator taking const iterators
+    /// @param first Start of keys
+    /// @param last End of keys
+    /// @param out Receives for each key an iterator to its element, or cend()
+    /// @return \c out past the last written iterator
+    template<typename ForwardIterator, typename OutputIterator>
+      OutputIterator find_batch(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) const {
+        return batch_finder<const_iterator>(first, last, out);
+      }
+
+    /// @param k Key
+    /// @return Iterator to the first element whose key is not less than \c k,
+    ///         end() if there is none
+    iterator lower_bound(const Key& k) {return iterator(lower(k));}
+    /// @param k Key
+    /// @return Iterator to the first element whose key is not less than \c k,
+    ///         cend() if there is none
+    const_iterator lower_bound(const Key& k) const {
+      return const_iterator(lower(k));
+    }
+    /// @param k Key
+    /// @return Iterator to the first element whose key is greater than \c k,
+    ///         end() if there is none
+    iterator upper_bound(const Key& k) {return iterator(upper(k));}
+    /// @param k Key
+    /// @return Iterator to the first element whose key is greater than \c k,
+    ///         cend() if there is none
+    const_iterator upper_bound(const Key& k) const {
+      return const_iterator(upper(k));
+    }
+    /// @param k Key
+    /// @return Range of elements with key \c k, empty if \c k is absent
+    std::pair<iterator, iterator> equal_range(const Key& k) {
+      return std::make_pair(lower_bound(k), upper_bound(k));
+    }
+    /// @param k Key
+    /// @return Range of elements with key \c k, empty if \c k is absent
+    std::pair<const_iterator, const_iterator> equal_range(const Key& k) const {
+      return std::make_pair(lower_bound(k), upper_bound(k));
+    }
+
+    /// @brief Count elements with keys less than \c k
+    /// @param k Key
+    /// @return Position \c k has or would have in sorted order
+    ///
+    /// O(height) using the subtree sizes kept in every node.
+    size_t rank(const Key& k) const {
+      static_assert(Sized, "rank needs subtree sizes");
+      size_t r = 0;
+      node* n = root->left;
+      while(n) {
+        if(n->value.first < k) {
+          r += size_of(n->left) + 1;
+          n = n->right;
+        }
+        else
+          n = n->left;
+      }
+      return r;
+    }
+    /// @brief Find the element at position \c i in sorted order
+    /// @param i Index, 0 for the smallest key
+    /// @return Iterator to element, end() if \c i >= size()
+    ///
+    /// O(height) using the subtree sizes kept in every node.
+    iterator select(size_t i) {return iterator(selector(i));}
+    /// @brief Find the element at position \c i in sorted order
+    /// @param i Index, 0 for the smallest key
+    /// @return Iterator to element, cend() if \c i >= size()
+    const_iterator select(size_t i) const {return const_iterator(selector(i));}
+    /// @brief Count elements with keys in [lo, hi)
+    /// @param lo Smallest key counted
+    /// @param hi Key past the largest counted
+    /// @return Number of elements, 0 if \c hi is not greater than \c lo
+    size_t count_range(const Key& lo, const Key& hi) const {
+      return lo < hi ? rank(hi) - rank(lo) : 0;
     }
 
     /// @}
@@ -285,22 +674,136 @@ class map {
 
     /// @brief Utility for finding a node with Key \c k
     /// @param k Key
-    /// @return Node pointer to either where node exists or where it should be
-    ///         inserted
+    /// @return Node pointer to where node exists or nullptr
     ///
     /// Base your algorithm off of Code Fragment 10.9 on page 436
     node* finder(const Key& k) const {
       /// @todo Implement finder helper function
+      if(!bloom.may_contain(k))
+        return nullptr;
       node * n=root->left;
-	  while(n->is_internal() && n->value.first!=k){
+      node * last=nullptr;
+	  while(n){
+		  last=n;
 		  if(k<n->value.first)
 			  n=n->left;
-		  else 
+		  else if(n->value.first<k)
 			  n=n->right;
+		  else
+			  break;
 	  }
+	  //a miss splays the last node visited, so it is paid for as well
+	  if(Balance == map_balance::splay && last)
+		  splay(last);
       return n;
     }
 
+    static const size_t batch_width = 16; ///< Lookups in flight in find_batch
+
+    /// @brief Utility for find_batch
+    /// @tparam It Iterator type to write
+    ///
+    /// Splaying restructures the tree under the other lookups of a group, so a
+    /// splay tree looks the keys up one by one.
+    template<typename It, typename ForwardIterator, typename OutputIterator>
+      OutputIterator batch_finder(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) const {
+        if(Balance == map_balance::splay) {
+          for(; first != last; ++first) {
+            node* n = finder(*first);
+            *out++ = It(n ? n : root);
+          }
+          return out;
+        }
+        ForwardIterator keys[batch_width];
+        node* cur[batch_width];   //next node of each lookup, null when done
+        node* found[batch_width]; //result of each lookup, root if missing
+        while(first != last) {
+          size_t g = 0;
+          for(; g < batch_width && first != last; ++g, ++first) {
+            keys[g] = first;
+            cur[g] = bloom.may_contain(*first) ? root->left : nullptr;
+            found[g] = root;
+          }
+          for(bool active = true; active;) {
+            active = false;
+            for(size_t i = 0; i < g; ++i) {
+              node* n = cur[i];
+              if(!n)
+                continue;
+              if(*keys[i] < n->value.first)
+                n = n->left;
+              else if(n->value.first < *keys[i])
+                n = n->right;
+              else {
+                found[i] = n;
+                n = nullptr;
+              }
+              if(n) {
+                __builtin_prefetch(n);
+                active = true;
+              }
+              cur[i] = n;
+            }
+          }
+          for(size_t i = 0; i < g; ++i)
+            *out++ = It(found[i]);
+        }
+        return out;
+      }
+
+    /// @param k Key
+    /// @return First node whose key is not less than \c k, root if none
+    node* lower(const Key& k) const {
+      node* r = root;
+      node* n = root->left;
+      while(n) {
+        if(n->value.first < k)
+          n = n->right;
+        else {
+          r = n;
+          n = n->left;
+        }
+      }
+      return r;
+    }
+
+    /// @param k Key
+    /// @return First node whose key is greater than \c k, root if none
+    node* upper(const Key& k) const {
+      node* r = root;
+      node* n = root->left;
+      while(n) {
+        if(k < n->value.first) {
+          r = n;
+          n = n->left;
+        }
+        else
+          n = n->right;
+      }
+      return r;
+    }
+
+    /// @param i Index in sorted order
+    /// @return Node at index \c i, root if \c i >= sz
+    node* selector(size_t i) const {
+      static_assert(Sized, "select needs subtree sizes");
+      if(i >= sz)
+        return root;
+      node* n = root->left;
+      while(true) {
+        size_t l = size_of(n->left);
+        if(i < l)
+          n = n->left;
+        else if(i == l)
+          return n;
+        else {
+          i -= l + 1;
+          n = n->right;
+        }
+      }
+    }
+
     /// @brief Utility for inserting a new node into the data structure.
     /// @param v Key, Value pair
     /// @return pair of node and bool. node pointing to found element or
@@ -310,49 +813,973 @@ class map {
     /// Inserter is the "put(k, v)" function of the Map ADT. Remember that Maps
     /// store unique elements, so if the element existed already it is returned.
     ///
-    /// Base you algorithm off of Code Fragment 10.10 on page 436
-    ///
-    /// Hint: Will need to use functions node::replace and node::expand
+    /// Base you algorithm off of Code Fragment 10.10 on page 436, the new node
+    /// is hung directly on the null child where the search fell off the tree.
     std::pair<node*, bool> inserter(const value_type& v) {
       /// @todo Implement inserter helper function
-    	node* pos=finder(v.first);
-		if(pos->is_internal()){
+		node* par;
+		node** link;
+		node* pos=locate(v.first, par, link);
+		if(pos)
 			//existing entry
 			return std::make_pair(pos, false);
-		}
-		pos->expand(); 
-		pos = pos->replace(v);
-		sz++;
-		return std::make_pair(pos, true); 
+		return std::make_pair(attach(pool.create(v), par, link), true); 
+    }
+
+    /// @brief Search for \c k, remembering where it would be inserted
+    /// @param k Key
+    /// @param[out] par Parent of the insertion position if \c k is absent
+    /// @param[out] link Null child pointer of \c par to hang a new node on
+    /// @return Node with key \c k or nullptr
+    node* locate(const Key& k, node*& par, node**& link) const {
+      //keys past either end, as in sorted input, hang off the cached node
+      if(sz && rightmost_node->value.first < k) {
+        par = rightmost_node;
+        link = &par->right;
+        return nullptr;
+      }
+      if(sz && k < leftmost_node->value.first) {
+        par = leftmost_node;
+        link = &par->left;
+        return nullptr;
+      }
+      par=root;
+      link=&root->left;
+      return descend(k, par, link);
+    }
+
+    /// @brief Search for \c k near node \c h, remembering where it would be
+    ///        inserted
+    /// @param h Node to search from, root to search from the top
+    /// @param k Key
+    /// @param[out] par Parent of the insertion position if \c k is absent
+    /// @param[out] link Null child pointer of \c par to hang a new node on
+    /// @return Node with key \c k or nullptr
+    ///
+    /// A key between \c h and its predecessor or successor hangs off one of
+    /// the two, whichever has the free child. Otherwise climb from \c h while
+    /// the key lies beyond the parent and descend from there.
+    node* locate_near(node* h, const Key& k, node*& par, node**& link) const {
+      if(h == root || !sz || rightmost_node->value.first < k ||
+          k < leftmost_node->value.first)
+        return locate(k, par, link);
+      node* x = h;
+      if(k < h->value.first) {
+        node* p = h == leftmost_node ? nullptr : predecessor(h, threaded());
+        if(!p || p->value.first < k) {
+          par = h->left ? p : h;
+          link = h->left ? &p->right : &h->left;
+          return nullptr;
+        }
+        while(x->parent != root &&
+            (x == x->parent->left || !(x->parent->value.first < k)))
+          x = x->parent;
+      }
+      else if(h->value.first < k) {
+        node* s = h == rightmost_node ? nullptr : successor(h, threaded());
+        if(!s || k < s->value.first) {
+          par = h->right ? s : h;
+          link = h->right ? &s->left : &h->right;
+          return nullptr;
+        }
+        while(x->parent != root &&
+            (x == x->parent->right || !(k < x->parent->value.first)))
+          x = x->parent;
+      }
+      par = x->parent;
+      link = x == par->left ? &par->left : &par->right;
+      return descend(k, par, link);
+    }
+
+    /// @brief Search for \c k below \c *link
+    /// @param k Key
+    /// @param[in,out] par Parent of \c *link, then of the insertion position
+    /// @param[in,out] link Child pointer to start from, then null child
+    ///                pointer to hang a new node on
+    /// @return Node with key \c k or nullptr
+    node* descend(const Key& k, node*& par, node**& link) const {
+      while(*link){
+        par=*link;
+        if(k<par->value.first)
+          link=&par->left;
+        else if(par->value.first<k)
+          link=&par->right;
+        else {
+          if(Balance == map_balance::splay)
+            splay(par);
+          return par;
+        }
+      }
+      return nullptr;
+    }
+
+    /// @brief Link a new node at a position found by locate and rebalance
+    /// @param n New node
+    /// @param par Parent from locate
+    /// @param link Child pointer from locate
+    /// @return \c n
+    node* attach(node* n, node* par, node** link) {
+      if(Threaded)
+        thread_before(n, link == &par->left ? par : successor(par, threaded()),
+            threaded());
+      if(par == root)
+        leftmost_node = rightmost_node = n;
+      else if(par == leftmost_node && link == &par->left)
+        leftmost_node = n;
+      else if(par == rightmost_node && link == &par->right)
+        rightmost_node = n;
+      n->parent=par;
+      *link=n;
+      finger=n;
+      sz++;
+      if(Sized)
+        for(node* p = par; p != root; p = p->parent)
+          ++p->subtree_size;
+      if(Balance == map_balance::red_black)
+        insert_fixup(n);
+      else if(Balance == map_balance::splay)
+        splay(n);
+      filter_added(n->value.first);
+      return n;
     }
 
     /// @brief Erase a node from the tree
     /// @param n Node to erase
     /// @return Next inorder successor of \c n in tree
     ///
-    /// Base your algorithm off of Code Fragment 10.11 on page 437
-    ///
-    /// Hint: will need to use functions node::inorder_next, node::replace, and
-    /// node::remove_above_external
+    /// Base your algorithm off of Code Fragment 10.11 on page 437. When \c n
+    /// has two children its successor is relinked into \c n's place rather
+    /// than copied, so iterators to all other elements stay valid.
     node* eraser(node* n) {
       /// @todo Implement eraser helper function
-	  node* w;
-	  if(n->left->is_external()) 
-		w=n->left;
-	  else if(n->right->is_external())
-		w=n->right;
+	  node* next=successor(n, threaded());
+	  if(n == leftmost_node)
+		leftmost_node = next;
+	  if(n == rightmost_node)
+		rightmost_node = n->left ? n->left->rightmost() : n->parent;
+	  unthread(n, threaded());
+	  if(n == finger)
+		finger = root;
+	  bool removed_black=!n->red;
+	  //every ancestor of the position that disappears loses one node
+	  if(Sized)
+		for(node* p = n->left && n->right ? next->parent : n->parent;
+		    p != root; p = p->parent)
+		  --p->subtree_size;
+	  node* x;   //node taking the place of the removed one, may be null
+	  node* xpar;//parent of x
+	  if(!n->left){
+		x=n->right;
+		xpar=n->parent;
+		transplant(n, x);
+	  }
+	  else if(!n->right){
+		x=n->left;
+		xpar=n->parent;
+		transplant(n, x);
+	  }
 	  else{
-		w=n->inorder_next();
-		n = n->replace(w->value);
-		sz--;
-		return w->left->remove_above_external();
+		//the successor has no left child, it is spliced out and takes n's
+		//place and color
+		node* s=next;
+		removed_black=!s->red;
+		x=s->right;
+		if(s->parent==n)
+		  xpar=s;
+		else{
+		  xpar=s->parent;
+		  transplant(s, x);
+		  s->right=n->right;
+		  s->right->parent=s;
 		}
-		sz--;
-		return w->remove_above_external();
-		
+		transplant(n, s);
+		s->left=n->left;
+		s->left->parent=s;
+		s->red=n->red;
+		s->subtree_size=n->subtree_size;
 	  }
-      
-    
+	  pool.destroy(n);
+	  sz--;
+	  if(Balance == map_balance::red_black && removed_black)
+		erase_fixup(x, xpar);
+	  filter_erased(1);
+	  return next;
+	}
+
+    /// @brief Replace the subtree rooted at \c u with the one rooted at \c v
+    /// @param u Node to unlink from its parent
+    /// @param v Node to link in its place, may be null
+    void transplant(node* u, node* v) {
+      if(u == u->parent->left)
+        u->parent->left = v;
+      else
+        u->parent->right = v;
+      if(v)
+        v->parent = u->parent;
+    }
+
+    /// @param n Node or null
+    /// @return Is \c n red? Null children count as black leaves
+    static bool is_red(const node* n) {return n && n->red;}
+
+    /// @param n Node or null
+    /// @return Number of nodes in the subtree rooted at \c n
+    static size_t size_of(const node* n) {return n ? n->subtree_size : 0;}
+
+    typedef std::integral_constant<bool, Threaded>
+      threaded; ///< Tag selecting the threaded helpers
+
+    /// @param n Node
+    /// @return In-order successor of \c n, root after the largest
+    static node* successor(node* n, std::true_type) {return n->next;}
+    /// @param n Node
+    /// @return In-order successor of \c n, root after the largest
+    static node* successor(node* n, std::false_type) {return n->inorder_next();}
+    /// @param n Node
+    /// @return In-order predecessor of \c n, the largest before root
+    static node* predecessor(node* n, std::true_type) {return n->prev;}
+    /// @param n Node
+    /// @return In-order predecessor of \c n, the largest before root
+    static node* predecessor(node* n, std::false_type) {return n->inorder_prev();}
+
+    /// @brief Link \c n into the thread in front of \c s
+    static void thread_before(node* n, node* s, std::true_type) {
+      n->next = s;
+      n->prev = s->prev;
+      s->prev->next = n;
+      s->prev = n;
+    }
+    /// @brief Nothing to link without threads
+    static void thread_before(node*, node*, std::false_type) {}
+
+    /// @brief Unlink \c n from the thread
+    static void unthread(node* n, std::true_type) {
+      n->prev->next = n->next;
+      n->next->prev = n->prev;
+    }
+    /// @brief Nothing to unlink without threads
+    static void unthread(node*, std::false_type) {}
+
+    /// @brief Recompute the cached leftmost and rightmost nodes, root for an
+    ///        empty tree, and drop the finger
+    void find_ends() {
+      finger = root;
+      leftmost_node = root->leftmost();
+      rightmost_node = root->left ? root->left->rightmost() : root;
+    }
+
+    /// @brief Recompute the cached ends and rebuild the whole thread and
+    ///        filter, O(n), after the tree was built other than by attach and
+    ///        eraser
+    void relink() {
+      find_ends();
+      rethread(threaded());
+      refilter();
+    }
+
+    /// @brief Rebuild the filter from the keys of the tree, sized for twice
+    ///        as many
+    void refilter() {
+      if(!Filtered)
+        return;
+      bloom.reset(2*sz);
+      for(node* n = leftmost_node; n != root; n = n->inorder_next())
+        bloom.insert(n->value.first);
+      stale = 0;
+    }
+    /// @brief Add key \c k to the filter, rebuilding it once outgrown
+    void filter_added(const Key& k) {
+      if(!Filtered)
+        return;
+      bloom.insert(k);
+      if(bloom.full())
+        refilter();
+    }
+    /// @brief Count \c n keys erased, rebuilding the filter once they reach a
+    ///        quarter of the entries, O(1) amortized
+    void filter_erased(size_t n) {
+      if(Filtered && 4*(stale += n) > sz)
+        refilter();
+    }
+
+    /// @brief Thread every node in order, the sentinel root closes the cycle
+    void rethread(std::true_type) {
+      node* p = root;
+      for(node* n = leftmost_node; n != root; n = n->inorder_next()) {
+        p->next = n;
+        n->prev = p;
+        p = n;
+      }
+      p->next = root;
+      root->prev = p;
+    }
+    /// @brief Nothing to thread without threads
+    void rethread(std::false_type) {}
+
+    /// @brief Run the destructor of every node, leaving their storage to the
+    ///        pool
+    ///
+    /// Walks the tree bottom up through the parent links, so it needs no
+    /// stack even on a degenerate tree. Skipped entirely when nodes are
+    /// trivially destructible.
+    void destroy_values() {
+      if(std::is_trivially_destructible<node>::value)
+        return;
+      node* n = root;
+      while(n) {
+        if(n->left)
+          n = n->left;
+        else if(n->right)
+          n = n->right;
+        else {
+          node* p = n->parent;
+          if(p) {
+            if(n == p->left)
+              p->left = nullptr;
+            else
+              p->right = nullptr;
+          }
+          n->~node();
+          n = p;
+        }
+      }
+    }
+
+    /// @brief Copy the entries of \c m into this empty map, preserving the
+    ///        shape and colors of its tree
+    /// @param m Other map
+    ///
+    /// Walks both trees in preorder through the parent links, creating each
+    /// child of the copy the first time its source child is reached.
+    void copy(const map& m) {
+      const node* s = m.root;
+      node* d = root;
+      while(true) {
+        if(s->left && !d->left) {
+          d->left = pool.create(s->left->value);
+          d->left->parent = d;
+          s = s->left;
+          d = d->left;
+          d->red = s->red;
+          d->subtree_size = s->subtree_size;
+        }
+        else if(s->right && !d->right) {
+          d->right = pool.create(s->right->value);
+          d->right->parent = d;
+          s = s->right;
+          d = d->right;
+          d->red = s->red;
+          d->subtree_size = s->subtree_size;
+        }
+        else if(s != m.root) {
+          s = s->parent;
+          d = d->parent;
+        }
+        else
+          break;
+      }
+      sz = m.sz;
+    }
+
+    /// @brief Unlink every entry into a chain ascending through right links,
+    ///        leaving the tree empty
+    /// @return First node of chain
+    ///
+    /// Walks from the largest entry backwards. inorder_prev only follows left
+    /// and parent links, so the right links of visited nodes are free to
+    /// reuse.
+    node* unravel() {
+      node* chain = nullptr;
+      node* n = root->left;
+      if(n)
+        while(n->right) n = n->right;
+      for(size_t i = sz; i > 0; --i) {
+        node* p = i > 1 ? n->inorder_prev() : nullptr;
+        n->right = chain;
+        chain = n;
+        n = p;
+      }
+      root->left = nullptr;
+      sz = 0;
+      return chain;
+    }
+
+    /// @brief Merge two ascending chains, dropping nodes of \c b whose key is
+    ///        in \c a
+    /// @param a Chain
+    /// @param b Chain
+    /// @param[out] n Length of merged chain
+    /// @return First node of merged chain
+    node* merge(node* a, node* b, size_t& n) {
+      node* chain = nullptr;
+      node** tail = &chain;
+      n = 0;
+      while(a && b) {
+        if(b->value.first < a->value.first) {
+          *tail = b;
+          b = b->right;
+        }
+        else {
+          if(!(a->value.first < b->value.first)) {
+            node* d = b;
+            b = b->right;
+            pool.destroy(d);
+          }
+          *tail = a;
+          a = a->right;
+        }
+        tail = &(*tail)->right;
+        ++n;
+      }
+      for(*tail = a ? a : b; *tail; tail = &(*tail)->right)
+        ++n;
+      return chain;
+    }
+
+    /// @brief Link the first \c n nodes of an ascending chain into a perfectly
+    ///        balanced subtree
+    /// @param[in,out] chain Chain through right links, advanced past the used
+    ///                      nodes
+    /// @param n Number of nodes
+    /// @param d Depth of the subtree root
+    /// @param red_depth Depth whose nodes are colored red
+    /// @return Root of subtree
+    ///
+    /// Subtree sizes differ by at most one, so every level but the deepest is
+    /// full. Coloring the deepest level red when it is not full gives every
+    /// path the same number of black nodes. Recursion depth is O(log n).
+    node* build(node*& chain, size_t n, size_t d, size_t red_depth) {
+      if(n == 0)
+        return nullptr;
+      node* l = build(chain, (n - 1)/2, d + 1, red_depth);
+      node* x = chain;
+      chain = chain->right;
+      x->left = l;
+      if(l)
+        l->parent = x;
+      x->right = build(chain, n/2, d + 1, red_depth);
+      if(x->right)
+        x->right->parent = x;
+      x->red = d == red_depth;
+      x->subtree_size = n;
+      return x;
+    }
+
+    /// @brief Insert every node of a chain through right links one by one,
+    ///        destroying those whose key exists
+    /// @param chain Chain
+    void place_all(node* chain) {
+      while(chain) {
+        node* x = chain;
+        chain = chain->right;
+        x->right = nullptr;
+        node* par;
+        node** link;
+        if(locate(x->value.first, par, link))
+          pool.destroy(x);
+        else
+          attach(x, par, link);
+      }
+    }
+
+    static const size_t parallel_grain = 4096; ///< Smallest input of a
+                                               ///< parallel set operation step
+
+    /// @brief Detach the tree, leaving the map empty
+    /// @return The tree and its black height
+    subtree take_tree() {
+      static_assert(Balance == map_balance::red_black,
+          "Join-based set operations need a red-black tree");
+      static_assert(Sized, "Join-based set operations need subtree sizes");
+      subtree t = {root->left, 0};
+      for(node* n = t.t; n; n = n->left)
+        t.bh += !n->red;
+      root->left = nullptr;
+      if(t.t)
+        t.t->parent = nullptr;
+      sz = 0;
+      return t;
+    }
+
+    /// @brief Make \c t the tree of this empty map
+    /// @param t Tree
+    void put_tree(subtree t) {
+      if(t.t) {
+        t.t->red = false;
+        t.t->parent = root;
+      }
+      root->left = t.t;
+      sz = size_of(t.t);
+      find_ends();
+    }
+
+    /// @brief Unthread and destroy nodes removed from the tree
+    /// @param discard Nodes
+    void drop(const std::vector<node*>& discard) {
+      for(node* n : discard) {
+        unthread(n, threaded());
+        pool.destroy(n);
+      }
+      filter_erased(discard.size());
+    }
+
+    /// @brief Run \c f and \c g, on two threads if \c parallel
+    template<typename F, typename G>
+      static void fork(bool parallel, F f, G g) {
+        if(parallel) {
+          std::thread t(f);
+          g();
+          t.join();
+        }
+        else {
+          f();
+          g();
+        }
+      }
+
+    /// @brief Union of two detached trees, nodes of \c b whose key is in
+    ///        \c a are discarded
+    subtree unite(subtree a, subtree b, std::vector<node*>& discard,
+        size_t threads) {
+      if(!a.t)
+        return b;
+      if(!b.t)
+        return a;
+      size_t cbh = b.bh - !b.t->red;
+      bool parallel = threads > 1 &&
+        size_of(a.t) + size_of(b.t) >= parallel_grain;
+      subtree l, r;
+      node* k = split(a, b.t->value.first, l, r);
+      if(k)
+        discard.push_back(b.t);
+      else
+        k = b.t;
+      subtree bl = {b.t->left, cbh}, br = {b.t->right, cbh};
+      std::vector<node*> more;
+      fork(parallel,
+          [&]() {l = unite(l, bl, discard, threads/2);},
+          [&]() {r = unite(r, br, parallel ? more : discard,
+            threads - threads/2);});
+      discard.insert(discard.end(), more.begin(), more.end());
+      return join(l, k, r);
+    }
+
+    /// @brief Intersection of a detached tree with the keys of subtree \c n
+    ///        of another map
+    subtree intersect(subtree a, const node* n, std::vector<node*>& discard,
+        size_t threads) {
+      if(!a.t)
+        return a;
+      if(!n) {
+        discard_all(a.t, discard);
+        return subtree();
+      }
+      bool parallel = threads > 1 && size_of(a.t) >= parallel_grain;
+      subtree l, r;
+      node* k = split(a, n->value.first, l, r);
+      std::vector<node*> more;
+      fork(parallel,
+          [&]() {l = intersect(l, n->left, discard, threads/2);},
+          [&]() {r = intersect(r, n->right, parallel ? more : discard,
+            threads - threads/2);});
+      discard.insert(discard.end(), more.begin(), more.end());
+      return k ? join(l, k, r) : join2(l, r);
+    }
+
+    /// @brief Detached tree without the keys of subtree \c n of another map
+    subtree subtract(subtree a, const node* n, std::vector<node*>& discard,
+        size_t threads) {
+      if(!a.t || !n)
+        return a;
+      bool parallel = threads > 1 && size_of(a.t) >= parallel_grain;
+      subtree l, r;
+      node* k = split(a, n->value.first, l, r);
+      if(k)
+        discard.push_back(k);
+      std::vector<node*> more;
+      fork(parallel,
+          [&]() {l = subtract(l, n->left, discard, threads/2);},
+          [&]() {r = subtract(r, n->right, parallel ? more : discard,
+            threads - threads/2);});
+      discard.insert(discard.end(), more.begin(), more.end());
+      return join2(l, r);
+    }
+
+    /// @brief Detached tree without the entries failing \c keep
+    template<typename Pred>
+      subtree filterer(subtree a, Pred& keep, std::vector<node*>& discard,
+          size_t threads) {
+        if(!a.t)
+          return a;
+        size_t cbh = a.bh - !a.t->red;
+        subtree l = {a.t->left, cbh}, r = {a.t->right, cbh};
+        bool parallel = threads > 1 && size_of(a.t) >= parallel_grain;
+        std::vector<node*> more;
+        fork(parallel,
+            [&]() {l = filterer(l, keep, discard, threads/2);},
+            [&]() {r = filterer(r, keep, parallel ? more : discard,
+              threads - threads/2);});
+        discard.insert(discard.end(), more.begin(), more.end());
+        if(keep(static_cast<const value_type&>(a.t->value)))
+          return join(l, a.t, r);
+        discard.push_back(a.t);
+        return join2(l, r);
+      }
+
+    /// @brief Collect every node of subtree \c n
+    static void discard_all(node* n, std::vector<node*>& discard) {
+      if(!n)
+        return;
+      discard_all(n->left, discard);
+      discard_all(n->right, discard);
+      discard.push_back(n);
+    }
+
+    /// @brief Split a detached tree by a key
+    /// @param t Tree
+    /// @param k Key
+    /// @param[out] l Tree of the keys less than \c k
+    /// @param[out] r Tree of the keys greater than \c k
+    /// @return Detached node with key \c k, nullptr if there is none
+    ///
+    /// Joins the subtrees hanging off the search path back together on the
+    /// way up. The black heights of consecutive joins telescope, so O(log n).
+    static node* split(subtree t, const Key& k, subtree& l, subtree& r) {
+      if(!t.t) {
+        l = r = subtree();
+        return nullptr;
+      }
+      node* n = t.t;
+      subtree a = {n->left, t.bh - !n->red}, b = {n->right, t.bh - !n->red};
+      if(k < n->value.first) {
+        node* f = split(a, k, l, a);
+        r = join(a, n, b);
+        return f;
+      }
+      if(n->value.first < k) {
+        node* f = split(b, k, b, r);
+        l = join(a, n, b);
+        return f;
+      }
+      l = a;
+      r = b;
+      n->left = n->right = nullptr;
+      n->subtree_size = 1;
+      return n;
+    }
+
+    /// @brief Join two detached trees around a node
+    /// @param l Tree of keys less than that of \c k
+    /// @param k Node
+    /// @param r Tree of keys greater than that of \c k
+    /// @return Joined tree
+    ///
+    /// \c k is linked in red on the spine of the taller tree, at the black
+    /// node as high as the shorter tree, and the double red is fixed up as
+    /// after an insertion. O(difference of black heights + 1).
+    static subtree join(subtree l, node* k, subtree r) {
+      blacken(l);
+      blacken(r);
+      if(l.bh == r.bh) {
+        hang(k, l.t, r.t);
+        k->red = false;
+        k->parent = nullptr;
+        return subtree{k, l.bh + 1};
+      }
+      if(l.bh > r.bh) {
+        node* p = nullptr;
+        node* c = l.t;
+        for(size_t bh = l.bh; is_red(c) || bh > r.bh; c = c->right) {
+          bh -= !c->red;
+          c->subtree_size += size_of(r.t) + 1;
+          p = c;
+        }
+        hang(k, c, r.t);
+        k->red = true;
+        p->right = k;
+        k->parent = p;
+        return subtree{join_fixup(k, l.t), l.bh};
+      }
+      node* p = nullptr;
+      node* c = r.t;
+      for(size_t bh = r.bh; is_red(c) || bh > l.bh; c = c->left) {
+        bh -= !c->red;
+        c->subtree_size += size_of(l.t) + 1;
+        p = c;
+      }
+      hang(k, l.t, c);
+      k->red = true;
+      p->left = k;
+      k->parent = p;
+      return subtree{join_fixup(k, r.t), r.bh};
+    }
+
+    /// @brief Join two detached trees, all keys of \c l less than those of
+    ///        \c r, around the largest node of \c l
+    static subtree join2(subtree l, subtree r) {
+      if(!l.t)
+        return r;
+      if(!r.t)
+        return l;
+      node* m = l.t;
+      while(m->right)
+        m = m->right;
+      subtree a, b;
+      split(l, m->value.first, a, b);
+      return join(a, m, r);
+    }
+
+    /// @brief Detach the root of \c t and make it black
+    static void blacken(subtree& t) {
+      if(!t.t)
+        return;
+      t.t->parent = nullptr;
+      if(t.t->red) {
+        t.t->red = false;
+        ++t.bh;
+      }
+    }
+
+    /// @brief Make \c l and \c r the children of \c k
+    static void hang(node* k, node* l, node* r) {
+      k->left = l;
+      k->right = r;
+      if(l)
+        l->parent = k;
+      if(r)
+        r->parent = k;
+      k->subtree_size = size_of(l) + size_of(r) + 1;
+    }
+
+    /// @brief Restore the red-black properties of a detached tree after join
+    ///        linked red node \c z into it
+    /// @param z Node
+    /// @param top Black root of the tree
+    /// @return Root of the tree, changed if it was rotated down. It may be
+    ///         red if recoloring reached it, which leaves the black height
+    ///         as it was
+    static node* join_fixup(node* z, node* top) {
+      while(z != top && z->parent->red) {
+        node* p = z->parent;
+        node* g = p->parent;
+        node* u = p == g->left ? g->right : g->left;
+        if(is_red(u)) {
+          p->red = u->red = false;
+          g->red = true;
+          z = g;
+        }
+        else {
+          if(p == g->left) {
+            if(z == p->right) {
+              rotate_left(p);
+              p = z;
+            }
+            rotate_right(g);
+          }
+          else {
+            if(z == p->left) {
+              rotate_right(p);
+              p = z;
+            }
+            rotate_left(g);
+          }
+          p->red = false;
+          g->red = true;
+          if(g == top)
+            top = p;
+          break;
+        }
+      }
+      return top;
+    }
+
+    /// @return floor(log2(n)), 0 for n < 2
+    static size_t log2_floor(size_t n) {
+      size_t l = 0;
+      while(n >>= 1)
+        ++l;
+      return l;
+    }
+
+    /// @brief Rotate \c x down to the left, its right child takes its place
+    /// @param x Internal node with an internal right child, or the root of a
+    ///          detached tree
+    static void rotate_left(node* x) {
+      node* y = x->right;
+      x->right = y->left;
+      if(y->left)
+        y->left->parent = x;
+      y->parent = x->parent;
+      if(x->parent) {
+        if(x == x->parent->left)
+          x->parent->left = y;
+        else
+          x->parent->right = y;
+      }
+      y->left = x;
+      x->parent = y;
+      y->subtree_size = x->subtree_size;
+      x->subtree_size = size_of(x->left) + size_of(x->right) + 1;
+    }
+
+    /// @brief Rotate \c x down to the right, its left child takes its place
+    /// @param x Internal node with an internal left child, or the root of a
+    ///          detached tree
+    static void rotate_right(node* x) {
+      node* y = x->left;
+      x->left = y->right;
+      if(y->right)
+        y->right->parent = x;
+      y->parent = x->parent;
+      if(x->parent) {
+        if(x == x->parent->left)
+          x->parent->left = y;
+        else
+          x->parent->right = y;
+      }
+      y->right = x;
+      x->parent = y;
+      y->subtree_size = x->subtree_size;
+      x->subtree_size = size_of(x->left) + size_of(x->right) + 1;
+    }
+
+    /// @brief Semi-splay \c x toward the true root
+    /// @param x Node
+    ///
+    /// A zig-zig step rotates only the grandparent and goes on from the
+    /// parent, which halves the rotations of a full splay while keeping its
+    /// amortized bounds. \c x itself may stop short of the root.
+    static void splay(node* x) {
+      while(!x->parent->is_root()) {
+        node* p = x->parent;
+        node* g = p->parent;
+        if(g->is_root()) {
+          if(x == p->left)
+            rotate_right(p);
+          else
+            rotate_left(p);
+        }
+        else if(x == p->left && p == g->left) {
+          rotate_right(g);
+          x = p;
+        }
+        else if(x == p->right && p == g->right) {
+          rotate_left(g);
+          x = p;
+        }
+        else if(x == p->left) {
+          rotate_right(p);
+          rotate_left(g);
+        }
+        else {
+          rotate_left(p);
+          rotate_right(g);
+        }
+      }
+    }
+
+    /// @brief Restore the red-black properties after inserting red node \c z
+    /// @param z Newly inserted node
+    ///
+    /// The sentinel root is black, so the loop stops at the true root.
+    void insert_fixup(node* z) {
+      z->red = true;
+      while(z->parent->red) {
+        node* p = z->parent;
+        node* g = p->parent;
+        node* u = p == g->left ? g->right : g->left;
+        if(is_red(u)) {
+          //recolor and move the double red up the tree
+          p->red = u->red = false;
+          g->red = true;
+          z = g;
+        }
+        else {
+          //restructure with one or two rotations
+          if(p == g->left) {
+            if(z == p->right) {
+              rotate_left(p);
+              p = z;
+            }
+            rotate_right(g);
+          }
+          else {
+            if(z == p->left) {
+              rotate_right(p);
+              p = z;
+            }
+            rotate_left(g);
+          }
+          p->red = false;
+          g->red = true;
+          break;
+        }
+      }
+      root->left->red = false;
+    }
+
+    /// @brief Restore the red-black properties after removing a black node
+    /// @param x Node taking the place of the removed node, it is "double
+    ///          black". May be null
+    /// @param p Parent of \c x
+    void erase_fixup(node* x, node* p) {
+      while(x != root->left && !is_red(x)) {
+        if(x == p->left) {
+          node* s = p->right;
+          if(s->red) {
+            s->red = false;
+            p->red = true;
+            rotate_left(p);
+            s = p->right;
+          }
+          if(!is_red(s->left) && !is_red(s->right)) {
+            s->red = true;
+            x = p;
+            p = x->parent;
+          }
+          else {
+            if(!is_red(s->right)) {
+              s->left->red = false;
+              s->red = true;
+              rotate_right(s);
+              s = p->right;
+            }
+            s->red = p->red;
+            p->red = s->right->red = false;
+            rotate_left(p);
+            x = root->left;
+          }
+        }
+        else {
+          node* s = p->left;
+          if(s->red) {
+            s->red = false;
+            p->red = true;
+            rotate_right(p);
+            s = p->left;
+          }
+          if(!is_red(s->left) && !is_red(s->right)) {
+            s->red = true;
+            x = p;
+            p = x->parent;
+          }
+          else {
+            if(!is_red(s->left)) {
+              s->right->red = false;
+              s->red = true;
+              rotate_left(s);
+              s = p->left;
+            }
+            s->red = p->red;
+            p->red = s->left->red = false;
+            rotate_right(p);
+            x = root->left;
+          }
+        }
+      }
+      if(x)
+        x->red = false;
+    }
 
     /// @}
     ////////////////////////////////////////////////////////////////////////////
@@ -361,10 +1788,18 @@ class map {
     /// @name Data
     /// @{
 
+    node_pool<node> pool; ///< Storage of all nodes, must outlive root
     node* root;     ///< Root of binary tree, the root will be a sentinel node
                     ///< for end iterator. root.left is the "true" root for the
-                    ///< data
+                    ///< data. It is the only sentinel, absent children are
+                    ///< null
     size_t sz;      ///< Number of nodes
+    node* leftmost_node;  ///< Node of the smallest key, root if empty
+    node* rightmost_node; ///< Node of the largest key, root if empty
+    node* finger;         ///< Last inserted node, root if none
+    typename std::conditional<Filtered, bloom_filter<Key>, no_filter>::type
+      bloom;              ///< Filter of the keys, or nothing
+    size_t stale;         ///< Keys erased since the filter was built
 
     /// @}
     ////////////////////////////////////////////////////////////////////////////
@@ -373,10 +1808,40 @@ class map {
     /// @name Types
     /// @{
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Stand-in for the filter of a map without one, every key may be
+    ///        present
+    ////////////////////////////////////////////////////////////////////////////
+    struct no_filter {
+      /// @return True
+      bool may_contain(const Key&) const {return true;}
+      /// @brief Nothing to add to
+      void insert(const Key&) {}
+      /// @brief Nothing to size
+      void reset(size_t) {}
+      /// @return False
+      bool full() const {return false;}
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief In-order links of a threaded node, the sentinel root is both
+    ///        before the smallest and after the largest node
+    ////////////////////////////////////////////////////////////////////////////
+    struct thread_links {
+      node* prev; ///< In-order predecessor
+      node* next; ///< In-order successor
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Links of a node that is not threaded
+    ////////////////////////////////////////////////////////////////////////////
+    struct no_links {};
+
     ////////////////////////////////////////////////////////////////////////////
     /// @brief Internal structure for binary search tree
     ////////////////////////////////////////////////////////////////////////////
-    struct node {
+    struct node : public std::conditional<Threaded, thread_links,
+                    no_links>::type {
       public:
 
         ////////////////////////////////////////////////////////////////////////
@@ -386,87 +1851,33 @@ class map {
         /// @brief Constructor
         /// @param v Map entry (Key, Value) pair
         node(const value_type& v = value_type()) :
-          value(v), parent(nullptr), left(nullptr), right(nullptr) {}
+          value(v), parent(nullptr), left(nullptr), right(nullptr), red(false),
+          subtree_size(1) {}
 
-        /// @brief Copy constructor
-        /// @param n node to perform deep copy from
-        node(const node& n) : value(n.value), parent(nullptr), left(nullptr), right(nullptr) {
-          /// @todo Finish implementation of this copy constructor.
-          ///       Hint: left and right are not copied correctly at the moment
-		  if(n.is_internal()){
-			left = new node(*n.left);
-			left->parent=this;
-			right = new node(*n.right);
-			right->parent=this;
-		  }
-        }
+        /// @brief Constructor
+        /// @param v Map entry (Key, Value) pair to move from
+        node(value_type&& v) :
+          value(std::move(v)), parent(nullptr), left(nullptr), right(nullptr),
+          red(false), subtree_size(1) {}
+
+        /// @brief Constructor building the entry in place
+        /// @param pc Piecewise construction tag
+        /// @param k Arguments of the key
+        /// @param v Arguments of the value
+        template<typename... K, typename... V>
+          node(std::piecewise_construct_t pc, std::tuple<K...> k,
+              std::tuple<V...> v) :
+            value(pc, std::move(k), std::move(v)), parent(nullptr),
+            left(nullptr), right(nullptr), red(false), subtree_size(1) {}
+
+        /// @brief Copy constructor - Deleted, map::copy copies whole trees
+        /// @param n Other node
+        node(const node& n) = delete;
 
         /// @brief Copy assignment - Deleted
         /// @param n Other node
         node& operator=(const node& n) = delete;
 
-        /// @brief Destructor
-        ~node() {
-          /// @todo Implement node destructor
-		  parent=nullptr;
-		  left=nullptr;
-		  right=nullptr;
-        }
-
-        /// @}
-        ////////////////////////////////////////////////////////////////////////
-
-        ////////////////////////////////////////////////////////////////////////
-        /// @name Modifiers
-        /// @{
-
-        /// @brief Replace node with a new node of a different value
-        /// @param v New value
-        /// @return Pointer to new node
-		node* replace(const value_type& v) {
-		  node* w = new node(v);
-		  w->parent = parent;
-		  w->left = left;
-		  w->right = right;
-		  node* n = this;
-		  if(n == parent->left)
-			parent->left = w;
-		  else
-			parent->right = w;
-		  if(n->left)
-			n->left->parent = w;
-		  if(n->right)
-			n->right->parent = w;
-		  n->left = n->right = nullptr;
-		  delete n;
-		  return w;
-		}
-
-        /// @brief Expand external node to make it internal
-        void expand() {
-          left = new node;
-          right = new node;
-          left->parent = this;
-          right->parent = this;
-        }
-
-        /// @brief Remove above external node, assumes this is external node
-        /// @return Sibling of \c n, who is promoted to n's parent's position
-        node* remove_above_external() {
-          node* par = parent;
-          node* sib = this == par->left ? par->right : par->left;
-          node* gpar = par->parent;
-          if(par == gpar->left)
-            gpar->left = sib;
-          else
-            gpar->right = sib;
-          sib->parent = gpar;
-          par->left = par->right = nullptr;
-          delete this;
-          delete par;
-          return sib;
-        }
-
         /// @}
         ////////////////////////////////////////////////////////////////////////
 
@@ -475,16 +1886,21 @@ class map {
 
         /// @return If parent is null return true, else false
         bool is_root() const {return parent == nullptr;}
-        /// @return If both children are null return true, else false
-        bool is_external() const {return left == nullptr && right == nullptr;}
-        /// @return If it is not external then it is internal
-        bool is_internal() const {return !is_external();}
 
-        /// @return Leftmost child of this node
-        node* leftmost() const {
-          const node* n = this;
-          while(n->is_internal()) n = n->left;
-          return n->parent;
+        /// @return Leftmost child of this node, or this node if it has no
+        ///         left child
+        node* leftmost() {
+          node* n = this;
+          while(n->left) n = n->left;
+          return n;
+        }
+
+        /// @return Rightmost child of this node, or this node if it has no
+        ///         right child
+        node* rightmost() {
+          node* n = this;
+          while(n->right) n = n->right;
+          return n;
         }
 
         /// @return Next node in the binary tree according to an inorder
@@ -492,7 +1908,7 @@ class map {
         node* inorder_next() {
           //Here, I have a right child, so inorder successor is leftmost child
           //of right subtree
-          if(right->is_internal()) {
+          if(right) {
             return right->leftmost();
           }
           //Otherwise, I am a right child myself and need to find an ancestor
@@ -513,10 +1929,10 @@ class map {
         node* inorder_prev() {
           //Here, I have a left child, so inorder predecessor is rightmost child
           //of left subtree
-          if(left->is_internal()) {
+          if(left) {
             node* n = left;
-            while(n->is_internal()) n = n->right;
-            return n->parent;
+            while(n->right) n = n->right;
+            return n;
           }
           //Otherwise, I am a left child myself and need to find an ancestor
           //who has a left child
@@ -546,11 +1962,23 @@ class map {
         node* parent;     ///< Parent node
         node* left;       ///< Left node
         node* right;      ///< Right node
+        bool red;         ///< Color for red-black balancing, null children
+                          ///< and the sentinel root count as black
+        size_t subtree_size; ///< Number of nodes in the subtree rooted here
 
         /// @}
         ////////////////////////////////////////////////////////////////////////
     };
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Red-black tree detached from the map during set operations, its
+    ///        root has no parent
+    ////////////////////////////////////////////////////////////////////////////
+    struct subtree {
+      node* t;   ///< Root, nullptr for an empty tree
+      size_t bh; ///< Black height, black nodes on every path down from t
+    };
+
     ////////////////////////////////////////////////////////////////////////////
     /// @brief Bidirectional iterator for a linked binary tree
     /// @tparam U value_type of map
@@ -604,11 +2032,11 @@ class map {
           /// @{
 
           /// @brief Pre-increment
-          map_iterator& operator++() {n = n->inorder_next(); return *this;}
+          map_iterator& operator++() {n = successor(n, threaded()); return *this;}
           /// @brief Post-increment
           map_iterator operator++(int) {map_iterator tmp(*this); ++(*this); return tmp;}
           /// @brief Pre-decrement
-          map_iterator& operator--() {n = n->inorder_prev(); return *this;}
+          map_iterator& operator--() {n = predecessor(n, threaded()); return *this;}
           /// @brief Post-decrement
           map_iterator operator--(int) {map_iterator tmp(*this); --(*this); return tmp;}
 
@@ -0,0 +1,171 @@
+#ifndef _NODE_POOL_H_
+#define _NODE_POOL_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Slab allocator for the nodes of a single container
+/// @ingroup MySTL
+/// @tparam T Node type
+///
+/// Nodes are carved out of blocks that double in size up to max_block_size
+/// nodes. Destroyed nodes go on a free list threaded through their own
+/// storage and are handed out again before the current block is touched.
+/// release() gives back every block at once in O(blocks) without running any
+/// destructor, so a container whose nodes are trivially destructible can drop
+/// all of its elements without visiting them.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+class node_pool {
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief Storage of one node, or a free list link while unused
+  //////////////////////////////////////////////////////////////////////////////
+  union slot {
+    slot* next;                                     ///< Next free slot
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type
+      storage;                                      ///< Node storage
+  };
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor, allocates nothing until the first create()
+    node_pool() :
+      blocks(nullptr), free_list(nullptr), bump(nullptr), bump_end(nullptr),
+      next_block_size(min_block_size), num_blocks(0) {}
+
+    node_pool(const node_pool&) = delete;
+    node_pool& operator=(const node_pool&) = delete;
+
+    /// @brief Destructor, releases all blocks without destroying nodes
+    ~node_pool() {
+      release();
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Number of blocks currently held
+    size_t block_count() const {return num_blocks;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Construct a node in pool storage
+    /// @tparam Args Argument types of a T constructor
+    /// @param args Arguments
+    /// @return Pointer to new node
+    template<typename... Args>
+      T* create(Args&&... args) {
+        slot* s = take();
+        try {
+          return ::new(static_cast<void*>(&s->storage))
+            T(std::forward<Args>(args)...);
+        }
+        catch(...) {
+          give(s);
+          throw;
+        }
+      }
+
+    /// @brief Destroy a node and recycle its storage
+    /// @param p Node created by this pool
+    void destroy(T* p) {
+      p->~T();
+      give(reinterpret_cast<slot*>(p));
+    }
+
+    /// @brief Free every block, nodes still alive are not destroyed
+    void release() {
+      while(blocks) {
+        slot* b = blocks;
+        blocks = b->next;
+        ::operator delete(b);
+      }
+      free_list = bump = bump_end = nullptr;
+      next_block_size = min_block_size;
+      num_blocks = 0;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @return Unused slot, from the free list or the current block
+    slot* take() {
+      if(free_list) {
+        slot* s = free_list;
+        free_list = s->next;
+        return s;
+      }
+      if(bump == bump_end)
+        grow();
+      return bump++;
+    }
+
+    /// @brief Put a slot on the free list
+    void give(slot* s) {
+      s->next = free_list;
+      free_list = s;
+    }
+
+    /// @brief Allocate the next block, its first slot links the block list
+    void grow() {
+      slot* b = static_cast<slot*>(
+          ::operator new((next_block_size + 1)*sizeof(slot)));
+      b->next = blocks;
+      blocks = b;
+      bump = b + 1;
+      bump_end = bump + next_block_size;
+      if(next_block_size < max_block_size)
+        next_block_size *= 2;
+      ++num_blocks;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    static const size_t min_block_size = 8;    ///< Nodes in first block
+    static const size_t max_block_size = 4096; ///< Largest block in nodes
+
+    slot* blocks;           ///< Most recent block, blocks are linked through
+                            ///< their first slot
+    slot* free_list;        ///< Destroyed nodes available for reuse
+    slot* bump;             ///< Next untouched slot of the current block
+    slot* bump_end;         ///< End of the current block
+    size_t next_block_size; ///< Nodes in the next block
+    size_t num_blocks;      ///< Number of blocks held
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
@@ -0,0 +1,571 @@
+#ifndef _PERSISTENT_MAP_H_
+#define _PERSISTENT_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Immutable map whose modifiers return new versions
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Value Value type
+///
+/// Implemented as an AVL tree with path copying. insert, insert_or_assign and
+/// erase leave the map untouched and return a new version, which copies only
+/// the O(log n) nodes on the path to the change and shares every other node
+/// with the original. Nodes have no parent links and carry an atomic reference
+/// count, so copying a map, i.e., taking a snapshot, is O(1), and a node is
+/// freed when the last version using it goes away. Versions may be read and
+/// destroyed concurrently from any number of threads; a single persistent_map
+/// object, like any other object, must not be reassigned while another thread
+/// reads it.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value>
+class persistent_map {
+
+  struct node;                  ///< Forward declare node class
+  class persistent_iterator;    ///< Forward declare iterator class
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+    typedef std::pair<const key_type, mapped_type>
+      value_type;              ///< Entry type
+    typedef persistent_iterator
+      const_iterator;          ///< Const forward iterator
+    typedef const_iterator
+      iterator;                ///< Entries are immutable, same as
+                               ///< const_iterator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor
+    persistent_map() : root(nullptr), sz(0) {}
+    /// @brief Copy constructor, O(1) snapshot sharing all nodes
+    /// @param m Other map
+    persistent_map(const persistent_map& m) : root(acquire(m.root)), sz(m.sz) {}
+    /// @brief Move constructor
+    /// @param m Other map, left empty
+    persistent_map(persistent_map&& m) : root(m.root), sz(m.sz) {
+      m.root = nullptr;
+      m.sz = 0;
+    }
+    /// @brief Range constructor
+    /// @tparam ForwardIterator Forward iterator over Key, Value pairs
+    /// @param first Start of range
+    /// @param last End of range
+    ///
+    /// A range sorted by strictly increasing keys is linked into a perfectly
+    /// balanced tree in O(n). Any other range is inserted one element at a
+    /// time, the first value of a repeated key wins.
+    template<typename ForwardIterator>
+      persistent_map(ForwardIterator first, ForwardIterator last) :
+        root(nullptr), sz(0) {
+        size_t n = 0;
+        bool sorted = true;
+        for(ForwardIterator i = first, prev = first; i != last; prev = i++, ++n)
+          sorted = sorted && (n == 0 || prev->first < i->first);
+        if(sorted) {
+          root = build(first, n);
+          sz = n;
+        }
+        else
+          for(; first != last; ++first)
+            *this = insert(*first);
+      }
+    /// @brief Destructor, frees the nodes no other version uses
+    ~persistent_map() {
+      release(root);
+    }
+
+    /// @brief Copy assignment, O(1)
+    /// @param m Other map
+    /// @return Reference to self
+    persistent_map& operator=(const persistent_map& m) {
+      node* r = acquire(m.root);
+      release(root);
+      root = r;
+      sz = m.sz;
+      return *this;
+    }
+    /// @brief Move assignment
+    /// @param m Other map, left empty
+    /// @return Reference to self
+    persistent_map& operator=(persistent_map&& m) {
+      if(this != &m) {
+        release(root);
+        root = m.root;
+        sz = m.sz;
+        m.root = nullptr;
+        m.sz = 0;
+      }
+      return *this;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Iterators
+    /// @{
+
+    /// @return Iterator to beginning
+    const_iterator begin() const {
+      const_iterator i;
+      i.push_left(root);
+      return i;
+    }
+    /// @return Iterator to end
+    const_iterator end() const {return const_iterator();}
+    /// @return Iterator to beginning
+    const_iterator cbegin() const {return begin();}
+    /// @return Iterator to end
+    const_iterator cend() const {return end();}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of map
+    size_t size() const {return sz;}
+    /// @return Does the map contain anything?
+    bool empty() const {return sz == 0;}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    const Value& at(const Key& k) const {
+      const node* n = finder(k);
+      if(!n)
+        throw std::out_of_range("out of range");
+      return n->value.second;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Insert element, i.e., put(k, v) from the Map ADT
+    /// @param v Key, Value pair
+    /// @return New version containing \c v, or a copy of this one if the key
+    ///         existed
+    persistent_map insert(const value_type& v) const {
+      bool added = false;
+      node* r = inserter(root, v, false, added);
+      return r ? persistent_map(r, sz + added) : *this;
+    }
+    /// @brief Insert element, or replace the value of an existing key
+    /// @param v Key, Value pair
+    /// @return New version mapping the key of \c v to its value
+    persistent_map insert_or_assign(const value_type& v) const {
+      bool added = false;
+      node* r = inserter(root, v, true, added);
+      return persistent_map(r, sz + added);
+    }
+    /// @brief Remove element with key \c k
+    /// @param k Key
+    /// @return New version without \c k, or a copy of this one if \c k was
+    ///         absent
+    persistent_map erase(const Key& k) const {
+      bool removed = false;
+      node* r = eraser(root, k, removed);
+      return removed ? persistent_map(r, sz - 1) : *this;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, end() otherwise
+    const_iterator find(const Key& k) const {
+      const_iterator i;
+      const node* n = root;
+      while(n) {
+        if(k < n->value.first) {
+          i.push(n);
+          n = n->left;
+        }
+        else if(n->value.first < k)
+          n = n->right;
+        else {
+          i.push(n);
+          return i;
+        }
+      }
+      return end();
+    }
+    /// @brief Count elements with specific keys
+    /// @param k Key
+    /// @return Count of elements with key \c k, 1 or 0
+    size_t count(const Key& k) const {
+      return finder(k) ? 1 : 0;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor adopting a tree
+    /// @param r Root, its reference passes to the map
+    /// @param n Number of nodes
+    persistent_map(node* r, size_t n) : root(r), sz(n) {}
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    /// @brief Utility for finding a node with Key \c k
+    /// @param k Key
+    /// @return Node pointer to where node exists or nullptr
+    const node* finder(const Key& k) const {
+      const node* n = root;
+      while(n) {
+        if(k < n->value.first)
+          n = n->left;
+        else if(n->value.first < k)
+          n = n->right;
+        else
+          break;
+      }
+      return n;
+    }
+
+    /// @brief Insert along a copy of the path to \c v's key
+    /// @param n Subtree, not modified
+    /// @param v Entry
+    /// @param assign Replace the value if the key exists?
+    /// @param[out] added Set to true if the key was new
+    /// @return New subtree owning one reference, nullptr if the subtree is
+    ///         unchanged
+    static node* inserter(const node* n, const value_type& v, bool assign,
+        bool& added) {
+      if(!n) {
+        added = true;
+        return new node(v, nullptr, nullptr);
+      }
+      if(v.first < n->value.first) {
+        node* l = inserter(n->left, v, assign, added);
+        return l ? balance(n->value, l, acquire(n->right)) : nullptr;
+      }
+      if(n->value.first < v.first) {
+        node* r = inserter(n->right, v, assign, added);
+        return r ? balance(n->value, acquire(n->left), r) : nullptr;
+      }
+      if(!assign)
+        return nullptr;
+      return new node(v, acquire(n->left), acquire(n->right));
+    }
+
+    /// @brief Erase along a copy of the path to \c k
+    /// @param n Subtree, not modified
+    /// @param k Key
+    /// @param[out] removed Set to true if \c k was found
+    /// @return New subtree owning one reference, meaningless unless \c removed
+    static node* eraser(const node* n, const Key& k, bool& removed) {
+      if(!n)
+        return nullptr;
+      if(k < n->value.first) {
+        node* l = eraser(n->left, k, removed);
+        return removed ? balance(n->value, l, acquire(n->right)) : nullptr;
+      }
+      if(n->value.first < k) {
+        node* r = eraser(n->right, k, removed);
+        return removed ? balance(n->value, acquire(n->left), r) : nullptr;
+      }
+      removed = true;
+      if(!n->left)
+        return acquire(n->right);
+      if(!n->right)
+        return acquire(n->left);
+      const node* s = n->right;
+      while(s->left)
+        s = s->left;
+      return balance(s->value, acquire(n->left), erase_min(n->right));
+    }
+
+    /// @param n Non-empty subtree, not modified
+    /// @return Copy of \c n without its smallest entry, owning one reference
+    static node* erase_min(const node* n) {
+      if(!n->left)
+        return acquire(n->right);
+      return balance(n->value, erase_min(n->left), acquire(n->right));
+    }
+
+    /// @brief Make a node from an entry and two subtrees whose heights differ
+    ///        by at most two, rotating to restore the AVL property
+    /// @param v Entry
+    /// @param l Left subtree, its reference passes to the result
+    /// @param r Right subtree, its reference passes to the result
+    /// @return New subtree owning one reference
+    static node* balance(const value_type& v, node* l, node* r) {
+      if(height(l) > height(r) + 1) {
+        node* x;
+        if(height(l->left) >= height(l->right))
+          x = new node(l->value, acquire(l->left),
+              new node(v, acquire(l->right), r));
+        else {
+          const node* lr = l->right;
+          x = new node(lr->value,
+              new node(l->value, acquire(l->left), acquire(lr->left)),
+              new node(v, acquire(lr->right), r));
+        }
+        release(l);
+        return x;
+      }
+      if(height(r) > height(l) + 1) {
+        node* x;
+        if(height(r->right) >= height(r->left))
+          x = new node(r->value, new node(v, l, acquire(r->left)),
+              acquire(r->right));
+        else {
+          const node* rl = r->left;
+          x = new node(rl->value,
+              new node(v, l, acquire(rl->left)),
+              new node(r->value, acquire(rl->right), acquire(r->right)));
+        }
+        release(r);
+        return x;
+      }
+      return new node(v, l, r);
+    }
+
+    /// @brief Link the next \c n entries of a sorted range into a perfectly
+    ///        balanced tree
+    /// @param[in,out] first Start of range, advanced past the used entries
+    /// @param n Number of entries
+    /// @return Root owning one reference
+    template<typename ForwardIterator>
+      static node* build(ForwardIterator& first, size_t n) {
+        if(n == 0)
+          return nullptr;
+        node* l = build(first, (n - 1)/2);
+        const value_type& v = *first;
+        ++first;
+        return new node(v, l, build(first, n/2));
+      }
+
+    /// @param n Node or null
+    /// @return Height of subtree rooted at \c n, 0 if empty
+    static int height(const node* n) {return n ? n->height : 0;}
+
+    /// @brief Add a reference to \c n
+    /// @param n Node or null
+    /// @return \c n
+    static node* acquire(const node* n) {
+      if(n)
+        n->refs.fetch_add(1, std::memory_order_relaxed);
+      return const_cast<node*>(n);
+    }
+    /// @brief Drop a reference to \c n, freeing the nodes that are left
+    ///        without one
+    /// @param n Node or null
+    ///
+    /// Recurses on left children and loops on right ones, so the depth is
+    /// bounded by the height of the tree.
+    static void release(node* n) {
+      while(n && n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        node* r = n->right;
+        release(n->left);
+        delete n;
+        n = r;
+      }
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    node* root; ///< Root of the tree, shared with other versions
+    size_t sz;  ///< Number of nodes
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Internal structure for the tree, immutable once built
+    ////////////////////////////////////////////////////////////////////////////
+    struct node {
+      public:
+
+        ////////////////////////////////////////////////////////////////////////
+        /// @name Constructors
+        /// @{
+
+        /// @brief Constructor
+        /// @param v Map entry (Key, Value) pair
+        /// @param l Left child, its reference passes to the node
+        /// @param r Right child, its reference passes to the node
+        node(const value_type& v, node* l, node* r) :
+          value(v), left(l), right(r),
+          height(1 + (persistent_map::height(l) > persistent_map::height(r) ?
+                persistent_map::height(l) : persistent_map::height(r))),
+          refs(1) {}
+
+        node(const node&) = delete;
+        node& operator=(const node&) = delete;
+
+        /// @}
+        ////////////////////////////////////////////////////////////////////////
+
+        ////////////////////////////////////////////////////////////////////////
+        /// @name Data
+        /// @{
+
+        const value_type value;            ///< Value is pair(key, value)
+        node* const left;                  ///< Left child
+        node* const right;                 ///< Right child
+        const int height;                  ///< Height of the subtree
+        mutable std::atomic<size_t> refs;  ///< Versions and parents sharing
+                                           ///< the node
+
+        /// @}
+        ////////////////////////////////////////////////////////////////////////
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Forward iterator keeping the nodes still to visit on a stack
+    ///
+    /// Valid as long as some version containing its nodes is alive.
+    ////////////////////////////////////////////////////////////////////////////
+    class persistent_iterator :
+      public std::iterator<std::forward_iterator_tag, const value_type> {
+        public:
+          //////////////////////////////////////////////////////////////////////
+          /// @name Constructors
+          /// @{
+
+          /// @brief Construction of an end iterator
+          persistent_iterator() : depth(0) {}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Comparison
+          /// @{
+
+          /// @brief Equality comparison
+          /// @param i Iterator
+          bool operator==(const persistent_iterator& i) const {
+            return depth == i.depth &&
+              (depth == 0 || stack[depth - 1] == i.stack[depth - 1]);
+          }
+          /// @brief Inequality comparison
+          /// @param i Iterator
+          bool operator!=(const persistent_iterator& i) const {
+            return !(*this == i);
+          }
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Dereference
+          /// @{
+
+          /// @brief Dereference operator
+          const value_type& operator*() const {return stack[depth - 1]->value;}
+          /// @brief Dereference operator
+          const value_type* operator->() const {
+            return &stack[depth - 1]->value;
+          }
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Advancement
+          /// @{
+
+          /// @brief Pre-increment
+          persistent_iterator& operator++() {
+            const node* n = stack[--depth];
+            push_left(n->right);
+            return *this;
+          }
+          /// @brief Post-increment
+          persistent_iterator operator++(int) {
+            persistent_iterator tmp(*this);
+            ++(*this);
+            return tmp;
+          }
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+        private:
+          /// @brief Push \c n and its chain of left children
+          void push_left(const node* n) {
+            for(; n; n = n->left)
+              push(n);
+          }
+          /// @brief Push \c n
+          void push(const node* n) {stack[depth++] = n;}
+
+          /// AVL height is below 1.45 log2(n + 2), enough for 2^44 entries
+          static const int max_height = 64;
+
+          const node* stack[max_height]; ///< Current node on top, then the
+                                         ///< ancestors still to visit
+          int depth;                     ///< Number of nodes on the stack
+
+          friend class persistent_map;
+      };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+};
+
+}
+
+#endif
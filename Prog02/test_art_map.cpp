@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "art_map.h"
+
+#include "unit_test.h"
+
+
+#include <iostream>
+
+using std::all_of;
+using std::string;
+using std::pair;
+using std::make_pair;
+using mystl::art_map;
+using std::cout;
+using std::vector;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of adaptive radix tree map
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class art_map_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_element_access_operator_exists();
+
+      test_element_access_operator_not_exists();
+
+      test_element_access_at_exists();
+
+      test_element_access_at_not_exists();
+
+      test_find_exists();
+
+      test_find_not_exists();
+
+      test_count_exists();
+
+      test_count_not_exists();
+
+      test_insert_exists();
+
+      test_insert_not_exists();
+
+      test_emplace();
+
+      test_try_emplace_exists();
+
+      test_try_emplace_not_exists();
+
+      test_insert_or_assign();
+
+      test_erase_iterator();
+
+      test_erase_key();
+
+      test_copy_constructor();
+
+      test_copy_assign();
+
+      test_clear();
+
+      test_sorted_insert_erase();
+
+      test_signed_order();
+
+      test_bounds();
+
+      test_random_insert_erase();
+
+      test_string_keys();
+
+      test_random_string_keys();
+    }
+
+  private:
+
+    /// @brief Setup map of integers to strings
+    void setup_dummy_map(art_map<int, string>& m) {
+      m[3] = "l";
+      m[1] = "H";
+      m[2] = "e";
+      m[5] = "o";
+      m[4] = "l";
+    }
+
+    /// @brief Test default constructor generates map of size 0
+    void test_default_constructor() {
+      art_map<int, string> m;
+
+      assert_msg(m.size() == 0 && m.empty(),
+          "Default construction failed.");
+    }
+
+    /// @brief Test element access operator when element exists
+    void test_element_access_operator_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m[5];
+	  
+      assert_msg(val == "o", "Element access operator exists failed");
+    }
+
+    /// @brief Test element access operator when element does not exist
+    void test_element_access_operator_not_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m[7];
+	 
+      assert_msg(val == "", "Element access operator not exists failed");
+    }
+
+    /// @brief Test element access at when element exists
+    void test_element_access_at_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m.at(5);
+
+      assert_msg(val == "o", "Element access at exists failed");
+    }
+
+    /// @brief Test element access at when element does not exist, ensure this
+    ///        function will throw an error.
+    void test_element_access_at_not_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      try {
+        string val = m.at(7);
+        assert_msg(false, "Element access at not exists failed");
+      }
+      catch(const std::out_of_range&) {
+        //test success!
+      }
+      catch(...) {
+        assert_msg(false, "Element access at not exists failed");
+      }
+    }
+
+    /// @brief Test find when element exists
+    void test_find_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      art_map<int, string>::iterator i = m.find(5);
+		
+      assert_msg(i->first == 5 && i->second == "o", "Find exists failed.");
+    }
+
+    /// @brief Test find when element does not exist
+    void test_find_not_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      art_map<int, string>::iterator i = m.find(7);
+	
+      assert_msg(i == m.end(), "Find exists failed.");
+    }
+
+    /// @brief Test count when element exists
+    void test_count_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.count(5);
+
+      assert_msg(i == 1, "Count exists failed.");
+    }
+
+    /// @brief Test count when element does not exist
+    void test_count_not_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.count(7);
+
+      assert_msg(i == 0, "Count exists failed.");
+    }
+
+    /// @brief Test insertion when element is already in map
+    void test_insert_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<art_map<int, string>::iterator, bool> i = m.insert(make_pair(5, "o"));
+
+      art_map<int, string>::iterator j = m.begin();
+      while(j != m.end() && i.first != j)
+        ++j;
+	  
+      assert_msg(m.size() == 5 && i.first == j && !i.second,
+          "Insert exists failed.");
+    }
+
+    /// @brief Test insertion when element is not already in map
+    void test_insert_not_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<art_map<int, string>::iterator, bool> i = m.insert(make_pair(7, "!"));
+
+      art_map<int, string>::iterator j = m.begin();
+      while(j != m.end() && i.first != j)
+        ++j;
+
+      assert_msg(m.size() == 6 && i.first == j && i.second,
+          "Insert not exists failed.");
+    }
+
+    /// @brief Test emplace of new and existing keys
+    void test_emplace() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<art_map<int, string>::iterator, bool> i = m.emplace(7, "!");
+      pair<art_map<int, string>::iterator, bool> j = m.emplace(5, "x");
+
+      assert_msg(m.size() == 6 && i.second && i.first->second == "!" &&
+          !j.second && j.first->second == "o", "Emplace failed.");
+    }
+
+    /// @brief Test try_emplace leaves an existing element and the arguments
+    ///        untouched
+    void test_try_emplace_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+      string s = "x";
+
+      pair<art_map<int, string>::iterator, bool> i = m.try_emplace(5, std::move(s));
+
+      assert_msg(m.size() == 5 && !i.second && i.first->second == "o" &&
+          s == "x", "Try emplace exists failed.");
+    }
+
+    /// @brief Test try_emplace constructs the value in place
+    void test_try_emplace_not_exists() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<art_map<int, string>::iterator, bool> i = m.try_emplace(7, 3, '!');
+
+      assert_msg(m.size() == 6 && i.second && i.first->first == 7 &&
+          i.first->second == "!!!" && m[7] == "!!!",
+          "Try emplace not exists failed.");
+    }
+
+    /// @brief Test insert_or_assign inserts absent keys and assigns existing
+    ///        ones
+    void test_insert_or_assign() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<art_map<int, string>::iterator, bool> i = m.insert_or_assign(5, "O");
+      pair<art_map<int, string>::iterator, bool> j = m.insert_or_assign(7, "!");
+
+      assert_msg(m.size() == 6 && !i.second && m.at(5) == "O" &&
+          j.second && m.at(7) == "!", "Insert or assign failed.");
+    }
+
+    /// @brief Test erase with an iterator, erasure invalidates iterators so
+    ///        the returned one is checked by its key
+    void test_erase_iterator() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+      int j = (++m.begin())->first;
+
+      art_map<int, string>::iterator i = m.erase(m.begin());
+
+      assert_msg(i == m.begin() && i->first == j && m.size() == 4,
+          "Erase iterator failed.");
+    }
+
+    /// @brief Test erase with a key
+    void test_erase_key() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.erase(5);
+	 
+      assert_msg(i == 1 && m.size() == 4, "Erase key failed.");
+    }
+
+    /// @brief Test copy constuction
+    void test_copy_constructor() {
+      art_map<int, string> m1;
+      setup_dummy_map(m1);
+
+      art_map<int, string> m2(m1);
+
+      for(auto&& x : m2)
+        x.second = "w";
+
+      assert_msg(m2.size() == m1.size() &&
+          all_of(m1.begin(), m1.end(),
+            [](const art_map<int, string>::value_type& x) {
+            return x.second != "w";}
+            ) &&
+          all_of(m2.begin(), m2.end(),
+            [](const art_map<int, string>::value_type& x) {
+            return x.second == "w";}
+            ),
+          "Copy constructor failed.");
+    }
+
+    /// @brief Test copy assignment
+    void test_copy_assign() {
+      art_map<int, string> m1;
+      setup_dummy_map(m1);
+
+      art_map<int, string> m2;
+      m2[4] = "*";
+
+      m2 = m1;
+
+      for(auto&& x : m2)
+        x.second = "w";
+
+      assert_msg(m2.size() == m1.size() &&
+          all_of(m1.begin(), m1.end(),
+            [](const art_map<int, string>::value_type& x) {
+            return x.second != "w";}
+            ) &&
+          all_of(m2.begin(), m2.end(),
+            [](const art_map<int, string>::value_type& x) {
+            return x.second == "w";}
+            ),
+          "Copy assign failed.");
+    }
+
+    /// @brief Test clear empties the map and leaves it usable
+    void test_clear() {
+      art_map<int, string> m;
+      setup_dummy_map(m);
+
+      m.clear();
+      bool cleared = m.empty() && m.begin() == m.end() && m.count(5) == 0;
+      setup_dummy_map(m);
+
+      assert_msg(cleared && m.size() == 5 && m.begin()->second == "H",
+          "Clear failed.");
+    }
+
+    /// @brief Test ascending insertion and erasing every other key, then the
+    ///        rest through iterators, so nodes grow through every size and
+    ///        shrink back
+    void test_sorted_insert_erase() {
+      art_map<int, int> m;
+      for(int i = 0; i < 100000; ++i)
+        m[i] = -i;
+
+      for(int i = 0; i < 100000; i += 2)
+        m.erase(i);
+
+      bool ordered = m.size() == 50000;
+      int k = 1;
+      for(auto&& x : m) {
+        ordered = ordered && x.first == k && x.second == -k;
+        k += 2;
+      }
+
+      art_map<int, int>::iterator i = m.begin();
+      while(i != m.end())
+        i = m.erase(i);
+
+      assert_msg(ordered && k == 100001 && m.empty() && m.begin() == m.end(),
+          "Sorted insert erase failed.");
+    }
+
+    /// @brief Test negative keys iterate before positive ones
+    void test_signed_order() {
+      art_map<int, int> m;
+      for(int i = 1000; i >= -1000; --i)
+        m[i * 65599] = i;
+
+      bool ordered = m.size() == 2001;
+      int k = -1000;
+      for(auto&& x : m)
+        ordered = ordered && x.second == k++;
+
+      assert_msg(ordered && m.begin()->first == -65599000 &&
+          m.rbegin()->first == 65599000, "Signed order failed.");
+    }
+
+    /// @brief Test lower and upper bounds on present, missing and
+    ///        out-of-range keys
+    void test_bounds() {
+      art_map<int, int> m;
+      for(int i = 0; i < 1000; ++i)
+        m[2*i] = i;
+
+      assert_msg(m.lower_bound(10)->first == 10 &&
+          m.lower_bound(11)->first == 12 && m.upper_bound(10)->first == 12 &&
+          m.lower_bound(-5) == m.begin() && m.lower_bound(1999) == m.end() &&
+          m.upper_bound(1998) == m.end(), "Bounds failed.");
+    }
+
+    /// @brief Test a random mix of insertions and erasures of sparse keys
+    ///        against std::map, walking the map forwards and backwards and
+    ///        probing bounds
+    void test_random_insert_erase() {
+      art_map<int, int> m;
+      std::map<int, int> s;
+      srand(7);
+      for(int i = 0; i < 50000; ++i) {
+        int k = (rand() % 4096) << (rand() % 20);
+        if(rand() % 3 == 0) {
+          size_t a = m.erase(k);
+          size_t b = s.erase(k);
+          assert_msg(a == b, "Random insert erase failed.");
+        }
+        else
+          m[k] = s[k] = i;
+      }
+
+      bool backwards = true;
+      art_map<int, int>::iterator j = m.end();
+      for(auto i = s.rbegin(); i != s.rend(); ++i)
+        backwards = backwards && *--j == *i;
+
+      bool bounds = true;
+      for(int i = 0; i < 10000; ++i) {
+        int k = int(unsigned(rand()) << (rand() % 8));
+        auto a = m.lower_bound(k);
+        auto b = s.lower_bound(k);
+        bounds = bounds && (b == s.end() ? a == m.end() : *a == *b);
+      }
+
+      assert_msg(m.size() == s.size() && backwards && bounds &&
+          j == m.begin() && std::equal(s.begin(), s.end(), m.begin()),
+          "Random insert erase failed.");
+    }
+
+    /// @brief Test string keys that are prefixes of each other and share
+    ///        prefixes longer than a node stores
+    void test_string_keys() {
+      art_map<string, int> m;
+      vector<string> keys = {"http://example.com/a/b/c", "http", "h", "",
+        "http://example.com/a/b", "http://example.com/a/c",
+        "http://example.com/", "https://example.com/"};
+      for(size_t i = 0; i < keys.size(); ++i)
+        m[keys[i]] = i;
+      std::sort(keys.begin(), keys.end());
+
+      bool ordered = m.size() == keys.size() &&
+        std::equal(keys.begin(), keys.end(), m.begin(),
+            [](const string& k, const art_map<string, int>::value_type& x) {
+            return k == x.first;});
+      bool found = m.count("http://example.com/a") == 0 &&
+        m.count("http://example.com/a/b/c/d") == 0 &&
+        m.count("http://example.com/x/b") == 0 &&
+        m.lower_bound("http://example.com/a")->first ==
+        "http://example.com/a/b" &&
+        m.lower_bound("http://example.com/b")->first == "https://example.com/";
+
+      m.erase("http://example.com/a/b");
+      m.erase("http://example.com/a/c");
+      found = found && m.at("http://example.com/a/b/c") == 0 &&
+        m.find("http://example.com/a/b") == m.end();
+
+      assert_msg(ordered && found && m.size() == keys.size() - 2,
+          "String keys failed.");
+    }
+
+    /// @brief Test a random mix of insertions and erasures of URL-like keys
+    ///        against std::map
+    void test_random_string_keys() {
+      art_map<string, int> m;
+      std::map<string, int> s;
+      const char* hosts[] = {"http://a.example.com/", "http://b.example.com/",
+        "https://example.org/"};
+      srand(11);
+      for(int i = 0; i < 30000; ++i) {
+        string k = hosts[rand() % 3];
+        for(int d = rand() % 4; d >= 0; --d)
+          k += "dir" + std::to_string(rand() % 5) + "/";
+        if(rand() % 2)
+          k += "index" + std::to_string(rand() % 10);
+        if(rand() % 3 == 0) {
+          size_t a = m.erase(k);
+          size_t b = s.erase(k);
+          assert_msg(a == b, "Random string keys failed.");
+        }
+        else
+          m[k] = s[k] = i;
+      }
+
+      art_map<string, int> c(m);
+      bool bounds = true;
+      for(auto&& x : s) {
+        string k = x.first.substr(0, x.first.size() - 1);
+        auto a = c.lower_bound(k);
+        auto b = s.lower_bound(k);
+        bounds = bounds && a->first == b->first;
+      }
+
+      assert_msg(m.size() == s.size() && c.size() == s.size() && bounds &&
+          std::equal(s.begin(), s.end(), m.begin()) &&
+          std::equal(s.begin(), s.end(), c.begin()),
+          "Random string keys failed.");
+    }
+};
+
+int main() {
+  art_map_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
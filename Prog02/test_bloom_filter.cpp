@@ -0,0 +1,153 @@
+#include <string>
+
+#include "bloom_filter.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using std::string;
+using mystl::bloom_filter;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of Bloom filter
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class bloom_filter_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_no_false_negatives();
+
+      test_false_positive_rate();
+
+      test_strings();
+
+      test_full();
+
+      test_clear();
+
+      test_reset();
+
+      test_copy();
+    }
+
+  private:
+
+    /// @brief Test an empty filter contains nothing
+    void test_default_constructor() {
+      bloom_filter<int> f;
+
+      assert_msg(f.size() == 0 && !f.full() && !f.may_contain(0) &&
+          !f.may_contain(42), "Default construction failed.");
+    }
+
+    /// @brief Test every inserted key is reported, also past capacity
+    void test_no_false_negatives() {
+      bloom_filter<int> f(1000);
+      for(int i = 0; i < 5000; ++i)
+        f.insert(7*i);
+
+      bool all = true;
+      for(int i = 0; all && i < 5000; ++i)
+        all = f.may_contain(7*i);
+
+      assert_msg(all && f.size() == 5000, "No false negatives failed.");
+    }
+
+    /// @brief Test at most 2% of missing keys are reported when full
+    void test_false_positive_rate() {
+      bloom_filter<int> f(10000);
+      for(int i = 0; i < int(f.capacity()); ++i)
+        f.insert(2*i);
+
+      int positives = 0;
+      for(int i = 0; i < 100000; ++i)
+        positives += f.may_contain(2*i + 1);
+
+      assert_msg(positives < 2000, "False positive rate failed.");
+    }
+
+    /// @brief Test string keys
+    void test_strings() {
+      bloom_filter<string> f(100);
+      f.insert("hello");
+      f.insert("world");
+
+      assert_msg(f.may_contain("hello") && f.may_contain("world") &&
+          !f.may_contain("goodbye"), "Strings failed.");
+    }
+
+    /// @brief Test full once more keys than capacity are inserted
+    void test_full() {
+      bloom_filter<int> f(100);
+      bool early = false;
+      for(int i = 0; i < int(f.capacity()); ++i) {
+        f.insert(i);
+        early = early || f.full();
+      }
+      f.insert(-1);
+
+      assert_msg(!early && f.full() && f.capacity() >= 100, "Full failed.");
+    }
+
+    /// @brief Test clear removes all keys and keeps the capacity
+    void test_clear() {
+      bloom_filter<int> f(100);
+      size_t c = f.capacity();
+      for(int i = 0; i < 100; ++i)
+        f.insert(i);
+      f.clear();
+
+      bool none = true;
+      for(int i = 0; none && i < 100; ++i)
+        none = !f.may_contain(i);
+
+      assert_msg(none && f.size() == 0 && f.capacity() == c, "Clear failed.");
+    }
+
+    /// @brief Test reset removes all keys and resizes
+    void test_reset() {
+      bloom_filter<int> f(100);
+      for(int i = 0; i < 100; ++i)
+        f.insert(i);
+      f.reset(100000);
+
+      bool none = true;
+      for(int i = 0; none && i < 100; ++i)
+        none = !f.may_contain(i);
+
+      assert_msg(none && f.size() == 0 && f.capacity() >= 100000,
+          "Reset failed.");
+    }
+
+    /// @brief Test copies hold the same keys and are independent
+    void test_copy() {
+      bloom_filter<int> f(100);
+      for(int i = 0; i < 100; ++i)
+        f.insert(i);
+      bloom_filter<int> g(f);
+      bloom_filter<int> h(100000);
+      h = f;
+      f.clear();
+
+      bool all = true;
+      for(int i = 0; all && i < 100; ++i)
+        all = g.may_contain(i) && h.may_contain(i);
+
+      assert_msg(all && g.size() == 100 && h.size() == 100 &&
+          h.capacity() == g.capacity() && !f.may_contain(0), "Copy failed.");
+    }
+};
+
+int main() {
+  bloom_filter_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
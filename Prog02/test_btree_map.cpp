@@ -0,0 +1,448 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "btree_map.h"
+
+#include "unit_test.h"
+
+
+#include <iostream>
+
+using std::all_of;
+using std::string;
+using std::pair;
+using std::make_pair;
+using mystl::btree_map;
+using std::cout;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of B-tree map
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class btree_map_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_element_access_operator_exists();
+
+      test_element_access_operator_not_exists();
+
+      test_element_access_at_exists();
+
+      test_element_access_at_not_exists();
+
+      test_find_exists();
+
+      test_find_not_exists();
+
+      test_count_exists();
+
+      test_count_not_exists();
+
+      test_insert_exists();
+
+      test_insert_not_exists();
+
+      test_emplace();
+
+      test_try_emplace_exists();
+
+      test_try_emplace_not_exists();
+
+      test_insert_or_assign();
+
+      test_erase_iterator();
+
+      test_erase_key();
+
+      test_copy_constructor();
+
+      test_copy_assign();
+
+      test_clear();
+
+      test_sorted_insert_erase<4>();
+
+      test_sorted_insert_erase<6>();
+
+      test_random_insert_erase<4>();
+
+      test_random_insert_erase<8>();
+
+      test_random_insert_erase<64>();
+
+      test_find_batch<4>();
+
+      test_find_batch<64>();
+    }
+
+  private:
+
+    /// @brief Setup map of integers to strings
+    void setup_dummy_map(btree_map<int, string>& m) {
+      m[3] = "l";
+      m[1] = "H";
+      m[2] = "e";
+      m[5] = "o";
+      m[4] = "l";
+    }
+
+    /// @brief Test default constructor generates map of size 0
+    void test_default_constructor() {
+      btree_map<int, string> m;
+
+      assert_msg(m.size() == 0 && m.empty(),
+          "Default construction failed.");
+    }
+
+    /// @brief Test element access operator when element exists
+    void test_element_access_operator_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m[5];
+	  
+      assert_msg(val == "o", "Element access operator exists failed");
+    }
+
+    /// @brief Test element access operator when element does not exist
+    void test_element_access_operator_not_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m[7];
+	 
+      assert_msg(val == "", "Element access operator not exists failed");
+    }
+
+    /// @brief Test element access at when element exists
+    void test_element_access_at_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m.at(5);
+
+      assert_msg(val == "o", "Element access at exists failed");
+    }
+
+    /// @brief Test element access at when element does not exist, ensure this
+    ///        function will throw an error.
+    void test_element_access_at_not_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      try {
+        string val = m.at(7);
+        assert_msg(false, "Element access at not exists failed");
+      }
+      catch(const std::out_of_range&) {
+        //test success!
+      }
+      catch(...) {
+        assert_msg(false, "Element access at not exists failed");
+      }
+    }
+
+    /// @brief Test find when element exists
+    void test_find_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      btree_map<int, string>::iterator i = m.find(5);
+		
+      assert_msg(i->first == 5 && i->second == "o", "Find exists failed.");
+    }
+
+    /// @brief Test find when element does not exist
+    void test_find_not_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      btree_map<int, string>::iterator i = m.find(7);
+	
+      assert_msg(i == m.end(), "Find exists failed.");
+    }
+
+    /// @brief Test count when element exists
+    void test_count_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.count(5);
+
+      assert_msg(i == 1, "Count exists failed.");
+    }
+
+    /// @brief Test count when element does not exist
+    void test_count_not_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.count(7);
+
+      assert_msg(i == 0, "Count exists failed.");
+    }
+
+    /// @brief Test insertion when element is already in map
+    void test_insert_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<btree_map<int, string>::iterator, bool> i = m.insert(make_pair(5, "o"));
+
+      btree_map<int, string>::iterator j = m.begin();
+      while(j != m.end() && i.first != j)
+        ++j;
+	  
+      assert_msg(m.size() == 5 && i.first == j && !i.second,
+          "Insert exists failed.");
+    }
+
+    /// @brief Test insertion when element is not already in map
+    void test_insert_not_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<btree_map<int, string>::iterator, bool> i = m.insert(make_pair(7, "!"));
+
+      btree_map<int, string>::iterator j = m.begin();
+      while(j != m.end() && i.first != j)
+        ++j;
+
+      assert_msg(m.size() == 6 && i.first == j && i.second,
+          "Insert not exists failed.");
+    }
+
+    /// @brief Test emplace of new and existing keys
+    void test_emplace() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<btree_map<int, string>::iterator, bool> i = m.emplace(7, "!");
+      pair<btree_map<int, string>::iterator, bool> j = m.emplace(5, "x");
+
+      assert_msg(m.size() == 6 && i.second && i.first->second == "!" &&
+          !j.second && j.first->second == "o", "Emplace failed.");
+    }
+
+    /// @brief Test try_emplace leaves an existing element and the arguments
+    ///        untouched
+    void test_try_emplace_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+      string s = "x";
+
+      pair<btree_map<int, string>::iterator, bool> i = m.try_emplace(5, std::move(s));
+
+      assert_msg(m.size() == 5 && !i.second && i.first->second == "o" &&
+          s == "x", "Try emplace exists failed.");
+    }
+
+    /// @brief Test try_emplace constructs the value in place
+    void test_try_emplace_not_exists() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<btree_map<int, string>::iterator, bool> i = m.try_emplace(7, 3, '!');
+
+      assert_msg(m.size() == 6 && i.second && i.first->first == 7 &&
+          i.first->second == "!!!" && m[7] == "!!!",
+          "Try emplace not exists failed.");
+    }
+
+    /// @brief Test insert_or_assign inserts absent keys and assigns existing
+    ///        ones
+    void test_insert_or_assign() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<btree_map<int, string>::iterator, bool> i = m.insert_or_assign(5, "O");
+      pair<btree_map<int, string>::iterator, bool> j = m.insert_or_assign(7, "!");
+
+      assert_msg(m.size() == 6 && !i.second && m.at(5) == "O" &&
+          j.second && m.at(7) == "!", "Insert or assign failed.");
+    }
+
+    /// @brief Test erase with an iterator, erasure invalidates iterators so
+    ///        the returned one is checked by its key
+    void test_erase_iterator() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+      int j = (++m.begin())->first;
+
+      btree_map<int, string>::iterator i = m.erase(m.begin());
+
+      assert_msg(i == m.begin() && i->first == j && m.size() == 4,
+          "Erase iterator failed.");
+    }
+
+    /// @brief Test erase with a key
+    void test_erase_key() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.erase(5);
+	 
+      assert_msg(i == 1 && m.size() == 4, "Erase key failed.");
+    }
+
+    /// @brief Test copy constuction
+    void test_copy_constructor() {
+      btree_map<int, string> m1;
+      setup_dummy_map(m1);
+
+      btree_map<int, string> m2(m1);
+
+      for(auto&& x : m2)
+        x.second = "w";
+
+      assert_msg(m2.size() == m1.size() &&
+          all_of(m1.begin(), m1.end(),
+            [](const btree_map<int, string>::value_type& x) {
+            return x.second != "w";}
+            ) &&
+          all_of(m2.begin(), m2.end(),
+            [](const btree_map<int, string>::value_type& x) {
+            return x.second == "w";}
+            ),
+          "Copy constructor failed.");
+    }
+
+    /// @brief Test copy assignment
+    void test_copy_assign() {
+      btree_map<int, string> m1;
+      setup_dummy_map(m1);
+
+      btree_map<int, string> m2;
+      m2[4] = "*";
+
+      m2 = m1;
+
+      for(auto&& x : m2)
+        x.second = "w";
+
+      assert_msg(m2.size() == m1.size() &&
+          all_of(m1.begin(), m1.end(),
+            [](const btree_map<int, string>::value_type& x) {
+            return x.second != "w";}
+            ) &&
+          all_of(m2.begin(), m2.end(),
+            [](const btree_map<int, string>::value_type& x) {
+            return x.second == "w";}
+            ),
+          "Copy assign failed.");
+    }
+
+    /// @brief Test clear empties the map and leaves it usable
+    void test_clear() {
+      btree_map<int, string> m;
+      setup_dummy_map(m);
+
+      m.clear();
+      bool cleared = m.empty() && m.begin() == m.end() && m.count(5) == 0;
+      setup_dummy_map(m);
+
+      assert_msg(cleared && m.size() == 5 && m.begin()->second == "H",
+          "Clear failed.");
+    }
+
+    /// @brief Test ascending insertion and erasing every other key, then the
+    ///        rest through iterators, with the smallest order so that every
+    ///        split, borrow and merge case is hit
+    template<size_t Order>
+      void test_sorted_insert_erase() {
+        btree_map<int, int, Order> m;
+        for(int i = 0; i < 1000; ++i)
+          m[i] = -i;
+
+        for(int i = 0; i < 1000; i += 2)
+          m.erase(i);
+
+        bool ordered = m.size() == 500;
+        int k = 1;
+        for(auto&& x : m) {
+          ordered = ordered && x.first == k && x.second == -k;
+          k += 2;
+        }
+
+        typename btree_map<int, int, Order>::iterator i = m.begin();
+        while(i != m.end())
+          i = m.erase(i);
+
+        assert_msg(ordered && k == 1001 && m.empty() && m.begin() == m.end(),
+            "Sorted insert erase failed.");
+      }
+
+    /// @brief Test a random mix of insertions and erasures against std::map,
+    ///        walking the map forwards and backwards
+    template<size_t Order>
+      void test_random_insert_erase() {
+        btree_map<int, int, Order> m;
+        std::map<int, int> s;
+        srand(7);
+        for(int i = 0; i < 20000; ++i) {
+          int k = rand() % 512;
+          if(rand() % 3 == 0) {
+            size_t a = m.erase(k);
+            size_t b = s.erase(k);
+            assert_msg(a == b, "Random insert erase failed.");
+          }
+          else
+            m[k] = s[k] = i;
+        }
+
+        bool backwards = true;
+        typename btree_map<int, int, Order>::iterator j = m.end();
+        for(auto i = s.rbegin(); i != s.rend(); ++i)
+          backwards = backwards && *--j == *i;
+
+        assert_msg(m.size() == s.size() && backwards && j == m.begin() &&
+            std::equal(s.begin(), s.end(), m.begin()),
+            "Random insert erase failed.");
+      }
+
+    /// @brief Test find_batch agrees with find on present and missing keys,
+    ///        through both the mutable and the const map
+    template<size_t Order>
+      void test_find_batch() {
+        btree_map<int, int, Order> m;
+        std::vector<int> keys;
+        srand(47);
+        for(int i = 0; i < 1001; ++i) {
+          m[rand() % 2000] = i;
+          keys.push_back(rand() % 2000);
+        }
+        typedef typename btree_map<int, int, Order>::iterator It;
+        typedef typename btree_map<int, int, Order>::const_iterator CIt;
+        std::vector<It> r;
+        std::vector<CIt> c;
+        m.find_batch(keys.begin(), keys.end(), std::back_inserter(r));
+        const btree_map<int, int, Order>& cm = m;
+        cm.find_batch(keys.begin(), keys.end(), std::back_inserter(c));
+        btree_map<int, int, Order> e;
+        It ee;
+        e.find_batch(keys.begin(), keys.begin() + 1, &ee);
+
+        bool ok = r.size() == keys.size() && c.size() == keys.size();
+        for(size_t i = 0; ok && i < keys.size(); ++i)
+          ok = r[i] == m.find(keys[i]) && c[i] == cm.find(keys[i]);
+
+        assert_msg(ok && ee == e.end(), "Find batch failed.");
+      }
+};
+
+int main() {
+  btree_map_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,279 @@
+#include <atomic>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrent_map.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using std::make_pair;
+using std::pair;
+using std::string;
+using std::vector;
+using mystl::concurrent_map;
+using mystl::epoch;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of concurrent map
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class concurrent_map_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_insert_not_exists();
+
+      test_insert_exists();
+
+      test_find_exists();
+
+      test_find_not_exists();
+
+      test_count();
+
+      test_erase();
+
+      test_scan();
+
+      test_random_insert_erase();
+
+      test_erase_reclaims();
+
+      test_concurrent_insert();
+
+      test_concurrent_insert_erase();
+    }
+
+  private:
+
+    /// @brief Setup map of integers to strings
+    void setup_dummy_map(concurrent_map<int, string>& m) {
+      m.insert(make_pair(3, "l"));
+      m.insert(make_pair(1, "H"));
+      m.insert(make_pair(2, "e"));
+      m.insert(make_pair(5, "o"));
+      m.insert(make_pair(4, "l"));
+    }
+
+    /// @brief Value which counts its live instances
+    struct counted {
+      counted() {++live;}
+      counted(const counted&) {++live;}
+      ~counted() {--live;}
+      static std::atomic<int> live;
+    };
+
+    /// @brief Test default constructor generates map
+    void test_default_constructor() {
+      concurrent_map<int, string> m;
+
+      assert_msg(m.size() == 0 && m.empty(), "Default construction failed.");
+    }
+
+    /// @brief Test insert of new keys
+    void test_insert_not_exists() {
+      concurrent_map<int, string> m;
+      setup_dummy_map(m);
+
+      bool inserted = m.insert(make_pair(6, "!"));
+
+      assert_msg(inserted && m.size() == 6, "Insert not exists failed.");
+    }
+
+    /// @brief Test insert of an existing key keeps its value
+    void test_insert_exists() {
+      concurrent_map<int, string> m;
+      setup_dummy_map(m);
+
+      bool inserted = m.insert(make_pair(2, "x"));
+      string v;
+      m.find(2, v);
+
+      assert_msg(!inserted && v == "e" && m.size() == 5,
+          "Insert exists failed.");
+    }
+
+    /// @brief Test find of an existing key
+    void test_find_exists() {
+      concurrent_map<int, string> m;
+      setup_dummy_map(m);
+
+      string v;
+      bool found = m.find(5, v);
+
+      assert_msg(found && v == "o", "Find exists failed.");
+    }
+
+    /// @brief Test find of a missing key leaves the output alone
+    void test_find_not_exists() {
+      concurrent_map<int, string> m;
+      setup_dummy_map(m);
+
+      string v = "unchanged";
+      bool found = m.find(7, v);
+
+      assert_msg(!found && v == "unchanged", "Find not exists failed.");
+    }
+
+    /// @brief Test count
+    void test_count() {
+      concurrent_map<int, string> m;
+      setup_dummy_map(m);
+
+      assert_msg(m.count(1) == 1 && m.count(0) == 0, "Count failed.");
+    }
+
+    /// @brief Test erase of existing and missing keys
+    void test_erase() {
+      concurrent_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t e1 = m.erase(3);
+      size_t e2 = m.erase(3);
+
+      assert_msg(e1 == 1 && e2 == 0 && m.count(3) == 0 && m.size() == 4,
+          "Erase failed.");
+    }
+
+    /// @brief Test scan copies a half-open key range in order
+    void test_scan() {
+      concurrent_map<int, string> m;
+      setup_dummy_map(m);
+
+      vector<pair<int, string>> v;
+      size_t n = m.scan(2, 5, std::back_inserter(v));
+      size_t none = m.scan(5, 2, std::back_inserter(v));
+
+      assert_msg(n == 3 && none == 0 && v.size() == 3 && v[0].first == 2 &&
+          v[1].second == "l" && v[2].first == 4, "Scan failed.");
+    }
+
+    /// @brief Test a random mix of insertions and erasures against std::map
+    void test_random_insert_erase() {
+      concurrent_map<int, int> m;
+      std::map<int, int> s;
+      srand(17);
+      for(int i = 0; i < 20000; ++i) {
+        int k = rand() % 512;
+        if(rand() % 3 == 0) {
+          if(m.erase(k) != s.erase(k))
+            break;
+        }
+        else if(m.insert(make_pair(k, i)) != s.insert(make_pair(k, i)).second)
+          break;
+      }
+
+      vector<pair<int, int>> v;
+      m.scan(0, 512, std::back_inserter(v));
+
+      assert_msg(m.size() == s.size() &&
+          v == vector<pair<int, int>>(s.begin(), s.end()),
+          "Random insert erase failed.");
+    }
+
+    /// @brief Test erased entries are freed once the epoch moves on, and the
+    ///        rest by the destructor
+    void test_erase_reclaims() {
+      {
+        concurrent_map<int, counted> m;
+        for(int i = 0; i < 100; ++i)
+          m.insert(make_pair(i, counted()));
+        for(int i = 0; i < 100; i += 2)
+          m.erase(i);
+        for(int i = 0; i < 4; ++i)
+          epoch::collect();
+
+        // 50 entries and the value of the head sentinel
+        assert_msg(counted::live == 51, "Erase reclaims failed.");
+      }
+      assert_msg(counted::live == 0, "Erase reclaims failed.");
+    }
+
+    /// @brief Test threads inserting interleaved keys all succeed
+    void test_concurrent_insert() {
+      concurrent_map<int, int> m;
+      vector<std::thread> threads;
+      for(int t = 0; t < 4; ++t)
+        threads.push_back(std::thread([&m, t]() {
+              for(int i = t; i < 20000; i += 4)
+                m.insert(make_pair(i, -i));
+              }));
+      for(auto&& t : threads)
+        t.join();
+
+      vector<pair<int, int>> v;
+      m.scan(0, 20000, std::back_inserter(v));
+      bool ok = v.size() == 20000;
+      for(int i = 0; ok && i < 20000; ++i)
+        ok = v[i].first == i && v[i].second == -i;
+
+      assert_msg(ok && m.size() == 20000, "Concurrent insert failed.");
+    }
+
+    /// @brief Test writers inserting and erasing the same keys while readers
+    ///        scan, readers must always see sorted keys with correct values
+    void test_concurrent_insert_erase() {
+      concurrent_map<int, int> m;
+      std::atomic<bool> done(false);
+      std::atomic<bool> ok(true);
+      vector<std::thread> writers;
+      for(int t = 0; t < 3; ++t)
+        writers.push_back(std::thread([&m, t]() {
+              unsigned x = t + 1;
+              for(int i = 0; i < 30000; ++i) {
+                x = x*1103515245 + 12345;
+                int k = (x >> 8) % 1000;
+                if(x & 1)
+                  m.erase(k);
+                else
+                  m.insert(make_pair(k, 2*k));
+              }
+              }));
+      vector<std::thread> readers;
+      for(int t = 0; t < 2; ++t)
+        readers.push_back(std::thread([&m, &done, &ok]() {
+              while(!done) {
+                vector<pair<int, int>> v;
+                m.scan(0, 1000, std::back_inserter(v));
+                for(size_t i = 0; i < v.size(); ++i)
+                  if(v[i].second != 2*v[i].first ||
+                      (i > 0 && !(v[i - 1].first < v[i].first)))
+                    ok = false;
+                int val;
+                if(m.find(500, val) && val != 1000)
+                  ok = false;
+              }
+              }));
+      for(auto&& t : writers)
+        t.join();
+      done = true;
+      for(auto&& t : readers)
+        t.join();
+
+      vector<pair<int, int>> v;
+      m.scan(0, 1000, std::back_inserter(v));
+
+      assert_msg(ok && v.size() == m.size(), "Concurrent insert erase failed.");
+    }
+};
+
+std::atomic<int> concurrent_map_test::counted::live(0);
+
+int main() {
+  concurrent_map_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,364 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "disk_map.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using std::make_pair;
+using std::pair;
+using std::vector;
+using mystl::disk_access;
+using mystl::disk_map;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of disk map
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class disk_map_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_create_empty();
+
+      test_insert_not_exists();
+
+      test_insert_exists();
+
+      test_insert_or_assign();
+
+      test_erase();
+
+      test_at();
+
+      test_bounds();
+
+      test_reverse_iteration();
+
+      test_random_insert_erase();
+
+      test_bulk_load();
+
+      test_bulk_load_unsorted();
+
+      test_reopen();
+
+      test_uncommitted_discarded();
+
+      test_torn_header();
+
+      test_read_only();
+
+      test_pages_reused();
+
+      std::remove(file);
+    }
+
+  private:
+
+    typedef disk_map<int, int, 256> dmap; ///< Small pages give deep trees
+
+    static const char* file; ///< File of the map under test
+
+    /// @brief Setup map of 1000 even keys to their negation, committed
+    static void setup_dummy_map() {
+      vector<pair<int, int>> v;
+      for(int i = 0; i < 1000; ++i)
+        v.push_back(make_pair(2*i, -2*i));
+      dmap m(file, v.begin(), v.end());
+    }
+
+    /// @return Is \c m equal to \c s, entry by entry in order?
+    static bool equal(const dmap& m, const std::map<int, int>& s) {
+      return m.size() == s.size() &&
+        vector<pair<int, int>>(m.begin(), m.end()) ==
+        vector<pair<int, int>>(s.begin(), s.end());
+    }
+
+    /// @return Size of \c file in bytes
+    static long file_size() {
+      std::ifstream in(file, std::ios::binary | std::ios::ate);
+      return in.tellg();
+    }
+
+    /// @brief Test opening a missing file for writing creates an empty map
+    void test_create_empty() {
+      std::remove(file);
+      dmap m(file, disk_access::read_write);
+
+      assert_msg(m.size() == 0 && m.empty() && m.begin() == m.end() &&
+          m.find(1) == m.end() && m.lower_bound(1) == m.end(),
+          "Create empty failed.");
+    }
+
+    /// @brief Test insert of new keys
+    void test_insert_not_exists() {
+      setup_dummy_map();
+      dmap m(file, disk_access::read_write);
+
+      pair<dmap::iterator, bool> p = m.insert(make_pair(7, 70));
+
+      assert_msg(p.second && p.first->first == 7 && p.first->second == 70 &&
+          m.size() == 1001 && m.count(7) == 1, "Insert not exists failed.");
+    }
+
+    /// @brief Test insert of an existing key keeps its value
+    void test_insert_exists() {
+      setup_dummy_map();
+      dmap m(file, disk_access::read_write);
+
+      pair<dmap::iterator, bool> p = m.insert(make_pair(8, 0));
+
+      assert_msg(!p.second && p.first->second == -8 && m.size() == 1000,
+          "Insert exists failed.");
+    }
+
+    /// @brief Test insert_or_assign of present and missing keys
+    void test_insert_or_assign() {
+      setup_dummy_map();
+      dmap m(file, disk_access::read_write);
+
+      bool assigned = !m.insert_or_assign(8, 80).second;
+      bool inserted = m.insert_or_assign(9, 90).second;
+
+      assert_msg(assigned && inserted && m.at(8) == 80 && m.at(9) == 90 &&
+          m.size() == 1001, "Insert or assign failed.");
+    }
+
+    /// @brief Test erase of existing and missing keys
+    void test_erase() {
+      setup_dummy_map();
+      dmap m(file, disk_access::read_write);
+
+      size_t e1 = m.erase(10);
+      size_t e2 = m.erase(10);
+      size_t e3 = m.erase(11);
+
+      assert_msg(e1 == 1 && e2 == 0 && e3 == 0 && m.count(10) == 0 &&
+          m.size() == 999, "Erase failed.");
+    }
+
+    /// @brief Test at of present and missing keys
+    void test_at() {
+      setup_dummy_map();
+      dmap m(file);
+
+      bool thrown = false;
+      try {
+        m.at(3);
+      }
+      catch(const std::out_of_range&) {
+        thrown = true;
+      }
+
+      assert_msg(m.at(1998) == -1998 && thrown, "At failed.");
+    }
+
+    /// @brief Test lower and upper bounds on present, missing and
+    ///        out-of-range keys
+    void test_bounds() {
+      setup_dummy_map();
+      dmap m(file);
+
+      assert_msg(m.lower_bound(10)->first == 10 &&
+          m.lower_bound(11)->first == 12 && m.upper_bound(10)->first == 12 &&
+          m.lower_bound(-5) == m.begin() && m.lower_bound(1999) == m.end() &&
+          m.upper_bound(1998) == m.end(), "Bounds failed.");
+    }
+
+    /// @brief Test reverse iteration visits every key in descending order
+    void test_reverse_iteration() {
+      setup_dummy_map();
+      dmap m(file);
+
+      int expected = 1998;
+      for(dmap::const_reverse_iterator i = m.crbegin(); i != m.crend(); ++i) {
+        if(i->first != expected)
+          break;
+        expected -= 2;
+      }
+
+      assert_msg(expected == -2, "Reverse iteration failed.");
+    }
+
+    /// @brief Test a random mix of insertions, assignments and erasures
+    ///        against std::map, committing now and then
+    void test_random_insert_erase() {
+      std::remove(file);
+      dmap m(file, disk_access::read_write);
+      std::map<int, int> s;
+      srand(29);
+      bool ok = true;
+      for(int i = 0; ok && i < 30000; ++i) {
+        int k = rand() % 3000;
+        if(rand() % 2 == 0)
+          ok = m.erase(k) == s.erase(k);
+        else if(rand() % 2 == 0)
+          ok = m.insert(make_pair(k, i)).second == s.insert(make_pair(k, i)).second;
+        else {
+          m.insert_or_assign(k, i);
+          s[k] = i;
+        }
+        if(i % 1000 == 0)
+          m.commit();
+      }
+      ok = ok && equal(m, s);
+      for(int k = 0; ok && k < 3000; ++k)
+        ok = m.count(k) == s.count(k);
+
+      assert_msg(ok, "Random insert erase failed.");
+    }
+
+    /// @brief Test bulk loading keeps order, drops duplicates and builds a
+    ///        searchable tree for sizes around page boundaries
+    void test_bulk_load() {
+      bool ok = true;
+      for(int n = 0; ok && n < 2000; n = n < 70 ? n + 1 : 3*n/2) {
+        vector<pair<int, int>> v;
+        std::map<int, int> s;
+        for(int i = 0; i < n; ++i) {
+          v.push_back(make_pair(i/3*5, i));
+          s.insert(v.back());
+        }
+        dmap m(file, v.begin(), v.end());
+        ok = equal(m, s);
+        for(auto&& x : s)
+          ok = ok && m.find(x.first)->second == x.second &&
+            m.count(x.first + 1) == 0;
+      }
+
+      assert_msg(ok, "Bulk load failed.");
+    }
+
+    /// @brief Test bulk loading unsorted input throws
+    void test_bulk_load_unsorted() {
+      vector<pair<int, int>> v = {make_pair(1, 1), make_pair(3, 3),
+        make_pair(2, 2)};
+      bool thrown = false;
+      try {
+        dmap m(file, v.begin(), v.end());
+      }
+      catch(const std::invalid_argument&) {
+        thrown = true;
+      }
+
+      assert_msg(thrown, "Bulk load unsorted failed.");
+    }
+
+    /// @brief Test committed updates are seen after reopening
+    void test_reopen() {
+      setup_dummy_map();
+      std::map<int, int> s;
+      {
+        dmap m(file, disk_access::read_write);
+        for(int i = 0; i < 1000; ++i) {
+          m.insert_or_assign(i, i);
+          if(i % 3 == 0)
+            m.erase(i);
+        }
+        m.commit();
+        s.insert(m.begin(), m.end());
+      }
+      dmap m(file);
+
+      assert_msg(equal(m, s), "Reopen failed.");
+    }
+
+    /// @brief Test updates after the last commit are gone after reopening
+    void test_uncommitted_discarded() {
+      setup_dummy_map();
+      {
+        dmap m(file, disk_access::read_write);
+        m.erase(0);
+        m.commit();
+        for(int i = 1; i < 500; i += 2)
+          m.insert(make_pair(i, i));
+        m.erase(2);
+      }
+      dmap m(file);
+
+      assert_msg(m.size() == 999 && m.count(0) == 0 && m.count(1) == 0 &&
+          m.at(2) == -2, "Uncommitted discarded failed.");
+    }
+
+    /// @brief Test a damaged newest header page falls back to the previous
+    ///        commit
+    void test_torn_header() {
+      setup_dummy_map();
+      {
+        dmap m(file, disk_access::read_write);
+        m.erase(0);
+        m.commit();
+      }
+      //the bulk load committed generation 1 to header page 1, the erase
+      //generation 2 to header page 0, damage the root of the latter
+      {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(40);
+        f.put('x');
+      }
+      dmap m(file);
+
+      assert_msg(m.size() == 1000 && m.at(0) == 0, "Torn header failed.");
+    }
+
+    /// @brief Test updates of a read-only map throw
+    void test_read_only() {
+      setup_dummy_map();
+      dmap m(file);
+
+      int thrown = 0;
+      try {
+        m.insert(make_pair(1, 1));
+      }
+      catch(const std::logic_error&) {
+        ++thrown;
+      }
+      try {
+        m.erase(0);
+      }
+      catch(const std::logic_error&) {
+        ++thrown;
+      }
+
+      assert_msg(thrown == 2 && m.size() == 1000, "Read only failed.");
+    }
+
+    /// @brief Test pages freed by commits are reused, so repeated updates of
+    ///        the same keys do not grow the file
+    void test_pages_reused() {
+      setup_dummy_map();
+      dmap m(file, disk_access::read_write);
+      for(int i = 0; i < 100; ++i) {
+        m.insert_or_assign(2*i, i);
+        m.commit();
+      }
+      long size = file_size();
+      for(int i = 0; i < 2000; ++i) {
+        m.insert_or_assign(2*(i % 1000), i);
+        m.commit();
+      }
+
+      assert_msg(file_size() == size && m.at(0) == 1000,
+          "Pages reused failed.");
+    }
+};
+
+const char* disk_map_test::file = "test_disk_map.tmp";
+
+int main() {
+  disk_map_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
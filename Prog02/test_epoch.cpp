@@ -0,0 +1,152 @@
+#include <atomic>
+#include <thread>
+
+#include "epoch.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using mystl::epoch;
+using mystl::epoch_node;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of epoch reclamation
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class epoch_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_retire_delays_reclaim();
+
+      test_collect_reclaims();
+
+      test_pinned_thread_delays_reclaim();
+
+      test_nested_guards();
+
+      test_retire_batch_reclaims();
+    }
+
+  private:
+
+    /// @brief Object which counts its live instances
+    struct counted : epoch_node {
+      counted() {++live;}
+      ~counted() {--live;}
+      static int live;
+    };
+
+    /// @brief Reclaim function of counted
+    static void reclaim(epoch_node* n) {
+      delete static_cast<counted*>(n);
+    }
+
+    /// @brief Collect until nothing is left or \c tries runs out
+    static void collect_all(int tries = 4) {
+      while(tries-- > 0 && counted::live > 0)
+        epoch::collect();
+    }
+
+    /// @brief Test a retired object is not freed right away
+    void test_retire_delays_reclaim() {
+      epoch::retire(new counted(), &reclaim);
+
+      bool alive = counted::live == 1;
+      collect_all();
+
+      assert_msg(alive && counted::live == 0, "Retire delays reclaim failed.");
+    }
+
+    /// @brief Test collect advances the epoch and frees after two advances
+    void test_collect_reclaims() {
+      uint64_t e = epoch::current();
+      epoch::retire(new counted(), &reclaim);
+
+      epoch::collect();
+      bool alive = counted::live == 1;
+      epoch::collect();
+
+      assert_msg(alive && counted::live == 0 && epoch::current() == e + 2,
+          "Collect reclaims failed.");
+    }
+
+    /// @brief Test an object stays alive while another thread is pinned
+    void test_pinned_thread_delays_reclaim() {
+      std::atomic<int> phase(0);
+      std::thread reader([&phase]() {
+          epoch::guard g;
+          phase = 1;
+          while(phase != 2)
+            std::this_thread::yield();
+          });
+      while(phase != 1)
+        std::this_thread::yield();
+
+      epoch::retire(new counted(), &reclaim);
+      collect_all(10);
+      bool alive = counted::live == 1;
+
+      phase = 2;
+      reader.join();
+      collect_all();
+
+      assert_msg(alive && counted::live == 0,
+          "Pinned thread delays reclaim failed.");
+    }
+
+    /// @brief Test a thread stays pinned until its outermost guard ends
+    void test_nested_guards() {
+      std::atomic<int> phase(0);
+      std::thread reader([&phase]() {
+          {
+            epoch::guard outer;
+            {
+              epoch::guard inner;
+            }
+            phase = 1;
+            while(phase != 2)
+              std::this_thread::yield();
+          }
+          phase = 3;
+          });
+      while(phase != 1)
+        std::this_thread::yield();
+
+      epoch::retire(new counted(), &reclaim);
+      collect_all(10);
+      bool alive = counted::live == 1;
+
+      phase = 2;
+      while(phase != 3)
+        std::this_thread::yield();
+      collect_all();
+      reader.join();
+
+      assert_msg(alive && counted::live == 0, "Nested guards failed.");
+    }
+
+    /// @brief Test retiring many objects frees old ones without collect
+    void test_retire_batch_reclaims() {
+      for(int i = 0; i < 1000; ++i)
+        epoch::retire(new counted(), &reclaim);
+
+      bool bounded = counted::live < 1000;
+      collect_all();
+
+      assert_msg(bounded && counted::live == 0, "Retire batch failed.");
+    }
+};
+
+int epoch_test::counted::live = 0;
+
+int main() {
+  epoch_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flat_map.h"
+#include "map.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using std::string;
+using mystl::flat_layout;
+using mystl::flat_map;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of flat map
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class flat_map_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_find<flat_layout::sorted>();
+
+      test_find<flat_layout::eytzinger>();
+
+      test_all_sizes<flat_layout::sorted>();
+
+      test_all_sizes<flat_layout::eytzinger>();
+
+      test_unsorted_duplicates<flat_layout::sorted>();
+
+      test_unsorted_duplicates<flat_layout::eytzinger>();
+
+      test_from_map<flat_layout::sorted>();
+
+      test_from_map<flat_layout::eytzinger>();
+
+      test_strings();
+
+      test_at();
+
+      test_copy();
+
+      test_clear();
+    }
+
+  private:
+
+    /// @brief Test an empty map finds nothing
+    void test_default_constructor() {
+      flat_map<int, int> m;
+      const flat_map<int, int, flat_layout::sorted> s;
+
+      assert_msg(m.empty() && m.size() == 0 && !m.find(0) && !s.find(0) &&
+          m.count(0) == 0, "Default construction failed.");
+    }
+
+    /// @brief Test present, missing, smaller and larger keys are found or
+    ///        missed, and values can be assigned through find
+    template<flat_layout L>
+      void test_find() {
+        std::vector<std::pair<int, int>> v;
+        for(int i = 0; i < 1000; ++i)
+          v.push_back(std::make_pair(2*i, -i));
+        flat_map<int, int, L> m(v.begin(), v.end());
+        bool ok = m.size() == 1000;
+        for(int i = 0; ok && i < 1000; ++i)
+          ok = m.find(2*i) && *m.find(2*i) == -i && !m.find(2*i + 1);
+        *m.find(10) = 42;
+
+        assert_msg(ok && !m.find(-1) && !m.find(2000) && m.at(10) == 42 &&
+            m.count(0) == 1 && m.count(1) == 0, "Find failed.");
+      }
+
+    /// @brief Test every size up to 130, covering full and partial last
+    ///        levels of the Eytzinger tree, finds every key and visits them
+    ///        in order
+    template<flat_layout L>
+      void test_all_sizes() {
+        bool ok = true;
+        for(int n = 0; ok && n <= 130; ++n) {
+          std::vector<std::pair<int, int>> v;
+          for(int i = 0; i < n; ++i)
+            v.push_back(std::make_pair(3*i + 1, i));
+          flat_map<int, int, L> m(v.begin(), v.end());
+          for(int k = -1; ok && k <= 3*n + 1; ++k)
+            ok = (m.find(k) != nullptr) == (k % 3 == 1 && k < 3*n) &&
+              (!m.find(k) || *m.find(k) == k/3);
+          int next = 0;
+          m.for_each([&](const int& k, int& x) {
+              ok = ok && k == 3*next + 1 && x == next;
+              ++next;});
+          ok = ok && next == n;
+        }
+
+        assert_msg(ok, "All sizes failed.");
+      }
+
+    /// @brief Test an unsorted range with repeated keys keeps the first
+    ///        value of each key
+    template<flat_layout L>
+      void test_unsorted_duplicates() {
+        std::vector<std::pair<int, int>> v;
+        std::map<int, int> model;
+        srand(71);
+        for(int i = 0; i < 5000; ++i) {
+          int k = rand() % 2000;
+          v.push_back(std::make_pair(k, i));
+          model.insert(std::make_pair(k, i));
+        }
+        flat_map<int, int, L> m(v.begin(), v.end());
+        bool ok = m.size() == model.size();
+        for(int k = 0; ok && k < 2000; ++k)
+          ok = model.count(k) ? m.find(k) && *m.find(k) == model[k] :
+            !m.find(k);
+
+        assert_msg(ok, "Unsorted duplicates failed.");
+      }
+
+    /// @brief Test rebuilding from a map
+    template<flat_layout L>
+      void test_from_map() {
+        mystl::map<int, string> t;
+        for(int i = 0; i < 300; ++i)
+          t[(i*37) % 300] = std::to_string(i);
+        flat_map<int, string, L> m;
+        m.assign(t.cbegin(), t.cend());
+        bool ok = m.size() == t.size();
+        for(int k = 0; ok && k < 300; ++k)
+          ok = m.find(k) && *m.find(k) == t[k];
+        t.clear();
+        t[5] = "five";
+        m.assign(t.cbegin(), t.cend());
+
+        assert_msg(ok && m.size() == 1 && m.at(5) == "five" && !m.find(0),
+            "From map failed.");
+      }
+
+    /// @brief Test string keys
+    void test_strings() {
+      std::vector<std::pair<string, int>> v;
+      for(int i = 0; i < 100; ++i)
+        v.push_back(std::make_pair("key" + std::to_string(i), i));
+      flat_map<string, int> m(v.begin(), v.end());
+      bool ok = true;
+      for(int i = 0; ok && i < 100; ++i)
+        ok = m.at("key" + std::to_string(i)) == i;
+
+      assert_msg(ok && !m.find("key") && !m.find("key100"), "Strings failed.");
+    }
+
+    /// @brief Test at throws for missing keys
+    void test_at() {
+      std::vector<std::pair<int, int>> v(1, std::make_pair(1, 2));
+      const flat_map<int, int> m(v.begin(), v.end());
+      bool thrown = false;
+      try {
+        m.at(2);
+      }
+      catch(const std::out_of_range&) {
+        thrown = true;
+      }
+
+      assert_msg(m.at(1) == 2 && thrown, "At failed.");
+    }
+
+    /// @brief Test copies hold the same entries and are independent
+    void test_copy() {
+      std::vector<std::pair<string, string>> v;
+      for(int i = 0; i < 50; ++i)
+        v.push_back(std::make_pair(std::to_string(i), std::to_string(-i)));
+      flat_map<string, string> m(v.begin(), v.end());
+      flat_map<string, string> c(m);
+      flat_map<string, string> a;
+      a = m;
+      m.clear();
+
+      bool ok = m.empty() && c.size() == 50 && a.size() == 50;
+      for(int i = 0; ok && i < 50; ++i)
+        ok = c.at(std::to_string(i)) == std::to_string(-i) &&
+          a.at(std::to_string(i)) == std::to_string(-i);
+
+      assert_msg(ok, "Copy failed.");
+    }
+
+    /// @brief Test clear empties the map and it can be refilled
+    void test_clear() {
+      std::vector<std::pair<int, int>> v;
+      for(int i = 0; i < 20; ++i)
+        v.push_back(std::make_pair(i, i));
+      flat_map<int, int> m(v.begin(), v.end());
+      m.clear();
+      bool empty = m.empty() && !m.find(3);
+      m.assign(v.begin(), v.begin() + 5);
+
+      assert_msg(empty && m.size() == 5 && m.at(4) == 4 && !m.find(5),
+          "Clear failed.");
+    }
+};
+
+int main() {
+  flat_map_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
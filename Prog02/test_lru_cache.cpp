@@ -0,0 +1,267 @@
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lru_cache.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using std::string;
+using mystl::clock_cache;
+using mystl::lru_cache;
+using mystl::sharded_cache;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of LRU, CLOCK and sharded caches
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class lru_cache_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_get_put();
+
+      test_evicts_least_recent();
+
+      test_put_refreshes();
+
+      test_erase();
+
+      test_clear();
+
+      test_zero_capacity();
+
+      test_random_against_model();
+
+      test_clock_second_chance();
+
+      test_clock_erase_reuses_slot();
+
+      test_clock_random();
+
+      test_sharded();
+
+      test_sharded_concurrent();
+    }
+
+  private:
+
+    /// @brief Test get finds put entries and misses others
+    void test_get_put() {
+      lru_cache<int, string> c(4);
+      c.put(1, "one");
+      c.put(2, "two");
+
+      assert_msg(c.size() == 2 && *c.get(1) == "one" && *c.get(2) == "two" &&
+          c.get(3) == nullptr && c.capacity() == 4, "Get put failed.");
+    }
+
+    /// @brief Test a full cache evicts the entry used longest ago
+    void test_evicts_least_recent() {
+      lru_cache<int, int> c(3);
+      c.put(1, 1);
+      c.put(2, 2);
+      c.put(3, 3);
+      c.get(1);
+      c.put(4, 4);
+
+      assert_msg(c.size() == 3 && c.contains(1) && !c.contains(2) &&
+          c.contains(3) && c.contains(4), "Evicts least recent failed.");
+    }
+
+    /// @brief Test put of an existing key assigns it and makes it recent
+    void test_put_refreshes() {
+      lru_cache<int, int> c(2);
+      c.put(1, 1);
+      c.put(2, 2);
+      c.put(1, 10);
+      c.put(3, 3);
+
+      assert_msg(c.size() == 2 && *c.get(1) == 10 && !c.contains(2),
+          "Put refreshes failed.");
+    }
+
+    /// @brief Test erase of present and missing keys
+    void test_erase() {
+      lru_cache<int, int> c(3);
+      c.put(1, 1);
+      c.put(2, 2);
+      size_t e1 = c.erase(1);
+      size_t e2 = c.erase(1);
+      c.put(3, 3);
+      c.put(4, 4);
+
+      assert_msg(e1 == 1 && e2 == 0 && c.size() == 3 && c.contains(2),
+          "Erase failed.");
+    }
+
+    /// @brief Test clear removes everything and the cache stays usable
+    void test_clear() {
+      lru_cache<int, string> c(3);
+      c.put(1, "a");
+      c.put(2, "b");
+      c.clear();
+      c.put(3, "c");
+
+      assert_msg(c.size() == 1 && !c.contains(1) && *c.get(3) == "c",
+          "Clear failed.");
+    }
+
+    /// @brief Test a cache of capacity 0 holds nothing
+    void test_zero_capacity() {
+      lru_cache<int, int> c(0);
+      clock_cache<int, int> k(0);
+      c.put(1, 1);
+      k.put(1, 1);
+
+      assert_msg(c.empty() && k.empty() && !c.get(1) && !k.get(1),
+          "Zero capacity failed.");
+    }
+
+    /// @brief Test random gets, puts and erasures against a list kept in
+    ///        recency order
+    void test_random_against_model() {
+      lru_cache<int, int> c(50);
+      std::list<std::pair<int, int>> model;
+      srand(61);
+      bool ok = true;
+      for(int i = 0; ok && i < 50000; ++i) {
+        int k = rand() % 120;
+        auto m = model.begin();
+        while(m != model.end() && m->first != k)
+          ++m;
+        int op = rand() % 10;
+        if(op < 5) {
+          int* v = c.get(k);
+          ok = (v == nullptr) == (m == model.end()) && (!v || *v == m->second);
+          if(m != model.end())
+            model.splice(model.begin(), model, m);
+        }
+        else if(op < 9) {
+          c.put(k, i);
+          if(m != model.end())
+            model.erase(m);
+          model.push_front(std::make_pair(k, i));
+          if(model.size() > 50)
+            model.pop_back();
+        }
+        else {
+          ok = c.erase(k) == (m != model.end() ? 1u : 0u);
+          if(m != model.end())
+            model.erase(m);
+        }
+        ok = ok && c.size() == model.size();
+      }
+
+      assert_msg(ok, "Random against model failed.");
+    }
+
+    /// @brief Test CLOCK evicts an unreferenced entry before referenced ones
+    void test_clock_second_chance() {
+      clock_cache<int, int> c(3);
+      c.put(1, 1);
+      c.put(2, 2);
+      c.put(3, 3);
+      c.get(1);
+      c.get(3);
+      c.put(4, 4);
+      bool first = !c.contains(2);
+      c.put(5, 5);
+
+      assert_msg(first && c.size() == 3 && c.contains(4) && c.contains(5) &&
+          *c.get(4) == 4, "Clock second chance failed.");
+    }
+
+    /// @brief Test an erased slot is taken by the next insertion instead of
+    ///        evicting
+    void test_clock_erase_reuses_slot() {
+      clock_cache<int, int> c(2);
+      c.put(1, 1);
+      c.put(2, 2);
+      c.erase(1);
+      c.put(3, 3);
+
+      assert_msg(c.size() == 2 && c.contains(2) && c.contains(3) &&
+          !c.contains(1), "Clock erase reuses slot failed.");
+    }
+
+    /// @brief Test random use of a CLOCK cache keeps the latest value of
+    ///        every key it holds and stays within capacity
+    void test_clock_random() {
+      clock_cache<int, int> c(40);
+      std::map<int, int> latest;
+      srand(67);
+      bool ok = true;
+      for(int i = 0; ok && i < 50000; ++i) {
+        int k = rand() % 100;
+        int op = rand() % 10;
+        if(op < 5) {
+          int* v = c.get(k);
+          ok = !v || *v == latest[k];
+        }
+        else if(op < 9) {
+          c.put(k, i);
+          latest[k] = i;
+          ok = c.contains(k);
+        }
+        else
+          c.erase(k);
+        ok = ok && c.size() <= 40;
+      }
+      c.clear();
+
+      assert_msg(ok && c.empty(), "Clock random failed.");
+    }
+
+    /// @brief Test a sharded cache spreads its capacity over its shards
+    void test_sharded() {
+      sharded_cache<lru_cache<int, int>> c(100, 5);
+      for(int i = 0; i < 1000; ++i)
+        c.put(i, -i);
+      int v = 1;
+      bool hit = c.get(999, v);
+      c.erase(999);
+      int w = 1;
+
+      assert_msg(c.shard_count() == 8 && c.capacity() == 104 &&
+          c.size() <= 104 && c.size() > 50 && hit && v == -999 &&
+          !c.get(999, w) && w == 1, "Sharded failed.");
+    }
+
+    /// @brief Test threads putting and getting disjoint keys of a sharded
+    ///        CLOCK cache always read back their own values
+    void test_sharded_concurrent() {
+      sharded_cache<clock_cache<int, int>> c(2000, 8);
+      std::vector<int> bad(4, 0);
+      std::vector<std::thread> t;
+      for(int j = 0; j < 4; ++j)
+        t.push_back(std::thread([&c, &bad, j]() {
+          for(int i = 0; i < 20000; ++i) {
+            int k = 4*(i % 700) + j;
+            c.put(k, k + i % 700);
+            int v;
+            if(c.get(4*(i % 500) + j, v) && v != 4*(i % 500) + j + i % 500)
+              ++bad[j];
+          }}));
+      for(auto&& x : t)
+        x.join();
+
+      assert_msg(bad == std::vector<int>(4, 0) && c.size() <= c.capacity(),
+          "Sharded concurrent failed.");
+    }
+};
+
+int main() {
+  lru_cache_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
@@ -1,5 +1,9 @@
 #include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "map.h"
 
@@ -13,6 +17,7 @@ using std::string;
 using std::pair;
 using std::make_pair;
 using mystl::map;
+using mystl::map_balance;
 using std::cout;
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Testing of map
@@ -45,6 +50,14 @@ class map_test : public test_class {
 
       test_insert_not_exists();
 
+      test_emplace();
+
+      test_try_emplace_exists();
+
+      test_try_emplace_not_exists();
+
+      test_insert_or_assign();
+
       test_erase_iterator();
 
       test_erase_key();
@@ -52,6 +65,85 @@ class map_test : public test_class {
       test_copy_constructor();
 
       test_copy_assign();
+
+      test_copy_degenerate();
+
+      test_clear();
+
+      test_sorted_insert_erase<map_balance::none>();
+
+      test_sorted_insert_erase<map_balance::red_black>();
+
+      test_sorted_insert_erase<map_balance::splay>();
+
+      test_random_insert_erase();
+
+      test_range_constructor();
+
+      test_insert_sorted<map_balance::none>();
+
+      test_insert_sorted<map_balance::red_black>();
+
+      test_insert_sorted<map_balance::splay>();
+
+      test_insert_sorted_unordered();
+
+      test_bounds();
+
+      test_equal_range();
+
+      test_rank_select<map_balance::none>();
+
+      test_rank_select<map_balance::red_black>();
+
+      test_rank_select<map_balance::splay>();
+
+      test_splay_lookups();
+
+      test_union_with();
+
+      test_intersect_with();
+
+      test_difference();
+
+      test_filter();
+
+      test_cached_ends();
+
+      test_threaded_iteration();
+
+      test_insert_hint<map<int, int>>();
+
+      test_insert_hint<map<int, int, map_balance::splay>>();
+
+      test_insert_hint<map<int, int, map_balance::red_black, true>>();
+
+      test_insert_hint<map<int, int, map_balance::none, false, false, false>>();
+
+      test_insert_hint<
+        map<int, int, map_balance::red_black, false, false, false>>();
+
+      test_emplace_hint();
+
+      test_insert_near();
+
+      test_hinted_sizes<map_balance::none>();
+
+      test_hinted_sizes<map_balance::red_black>();
+
+      test_hinted_sizes<map_balance::splay>();
+
+      test_hinted_set_operations();
+
+      test_find_batch<map_balance::none>();
+
+      test_find_batch<map_balance::red_black>();
+
+      test_find_batch<map_balance::splay>();
+
+      test_filtered_lookups();
+
+      test_filtered_set_operations();
     }
 
   private:
@@ -113,7 +205,7 @@ class map_test : public test_class {
         string val = m.at(7);
         assert_msg(false, "Element access at not exists failed");
       }
-      catch(std::out_of_range) {
+      catch(const std::out_of_range&) {
         //test success!
       }
       catch(...) {
@@ -191,6 +283,56 @@ class map_test : public test_class {
           "Insert not exists failed.");
     }
 
+    /// @brief Test emplace of new and existing keys
+    void test_emplace() {
+      map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<map<int, string>::iterator, bool> i = m.emplace(7, "!");
+      pair<map<int, string>::iterator, bool> j = m.emplace(5, "x");
+
+      assert_msg(m.size() == 6 && i.second && i.first->second == "!" &&
+          !j.second && j.first->second == "o", "Emplace failed.");
+    }
+
+    /// @brief Test try_emplace leaves an existing element and the arguments
+    ///        untouched
+    void test_try_emplace_exists() {
+      map<int, string> m;
+      setup_dummy_map(m);
+      string s = "x";
+
+      pair<map<int, string>::iterator, bool> i = m.try_emplace(5, std::move(s));
+
+      assert_msg(m.size() == 5 && !i.second && i.first->second == "o" &&
+          s == "x", "Try emplace exists failed.");
+    }
+
+    /// @brief Test try_emplace constructs the value in place
+    void test_try_emplace_not_exists() {
+      map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<map<int, string>::iterator, bool> i = m.try_emplace(7, 3, '!');
+
+      assert_msg(m.size() == 6 && i.second && i.first->first == 7 &&
+          i.first->second == "!!!" && m[7] == "!!!",
+          "Try emplace not exists failed.");
+    }
+
+    /// @brief Test insert_or_assign inserts absent keys and assigns existing
+    ///        ones
+    void test_insert_or_assign() {
+      map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<map<int, string>::iterator, bool> i = m.insert_or_assign(5, "O");
+      pair<map<int, string>::iterator, bool> j = m.insert_or_assign(7, "!");
+
+      assert_msg(m.size() == 6 && !i.second && m.at(5) == "O" &&
+          j.second && m.at(7) == "!", "Insert or assign failed.");
+    }
+
     /// @brief Test erase with an iterator
     void test_erase_iterator() {
       map<int, string> m;
@@ -258,6 +400,651 @@ class map_test : public test_class {
             ),
           "Copy assign failed.");
     }
+
+    /// @brief Test copy of a tree degenerated into a list, which must not
+    ///        recurse per level
+    void test_copy_degenerate() {
+      map<int, int, map_balance::none> m1;
+      for(int i = 0; i < 20000; ++i)
+        m1[i] = i;
+
+      map<int, int, map_balance::none> m2(m1);
+      m1[0] = -1;
+
+      int k = 0;
+      bool ordered = true;
+      for(auto&& x : m2)
+        ordered = ordered && x.first == k && x.second == k++;
+
+      assert_msg(ordered && k == 20000 && m2.size() == 20000,
+          "Copy degenerate failed.");
+    }
+
+    /// @brief Test clear empties the map and leaves it usable
+    void test_clear() {
+      map<int, string> m;
+      setup_dummy_map(m);
+
+      m.clear();
+      bool cleared = m.empty() && m.begin() == m.end() && m.count(5) == 0;
+      setup_dummy_map(m);
+
+      assert_msg(cleared && m.size() == 5 && m.begin()->second == "H",
+          "Clear failed.");
+    }
+
+    /// @brief Test ascending insertion followed by erasing every other key and
+    ///        then the rest, the worst case for an unbalanced tree
+    template<map_balance Balance>
+      void test_sorted_insert_erase() {
+        map<int, int, Balance> m;
+        for(int i = 0; i < 1000; ++i)
+          m[i] = -i;
+
+        for(int i = 0; i < 1000; i += 2)
+          m.erase(i);
+
+        bool ordered = m.size() == 500;
+        int k = 1;
+        for(auto&& x : m) {
+          ordered = ordered && x.first == k && x.second == -k;
+          k += 2;
+        }
+
+        typename map<int, int, Balance>::iterator i = m.begin();
+        while(i != m.end())
+          i = m.erase(i);
+
+        assert_msg(ordered && k == 1001 && m.empty() && m.begin() == m.end(),
+            "Sorted insert erase failed.");
+      }
+
+    /// @brief Test a random mix of insertions and erasures against std::map
+    void test_random_insert_erase() {
+      map<int, int> m;
+      std::map<int, int> s;
+      srand(7);
+      for(int i = 0; i < 20000; ++i) {
+        int k = rand() % 512;
+        if(rand() % 3 == 0 && s.count(k)) {
+          m.erase(k);
+          s.erase(k);
+        }
+        else
+          m[k] = s[k] = i;
+      }
+
+      assert_msg(m.size() == s.size() &&
+          std::equal(s.begin(), s.end(), m.begin(),
+            [](const std::pair<const int, int>& x,
+              const map<int, int>::value_type& y) {
+            return x == y;}
+            ),
+          "Random insert erase failed.");
+    }
+
+    /// @brief Test construction from a sorted range with a repeated key
+    void test_range_constructor() {
+      std::vector<pair<int, string>> v = {
+        make_pair(1, "H"), make_pair(2, "e"), make_pair(2, "x"),
+        make_pair(3, "l"), make_pair(4, "l"), make_pair(5, "o")};
+      map<int, string> m(v.begin(), v.end());
+
+      string s;
+      for(auto&& x : m)
+        s += x.second;
+
+      assert_msg(m.size() == 5 && s == "Hello", "Range constructor failed.");
+    }
+
+    /// @brief Test bulk insertion of a sorted range overlapping existing keys,
+    ///        then further inserts and erases against std::map
+    template<map_balance Balance>
+      void test_insert_sorted() {
+        map<int, int, Balance> m;
+        std::map<int, int> s;
+        for(int i = 0; i < 3000; i += 3)
+          m[i] = s[i] = i;
+
+        std::vector<pair<int, int>> v;
+        for(int i = 0; i < 4000; i += 2)
+          v.push_back(make_pair(i, -i));
+        m.insert_sorted(v.begin(), v.end());
+        s.insert(v.begin(), v.end());
+        bool merged = m.size() == s.size() &&
+          std::equal(s.begin(), s.end(), m.begin());
+
+        srand(11);
+        for(int i = 0; i < 20000; ++i) {
+          int k = rand() % 5000;
+          if(rand() % 2 && s.count(k)) {
+            m.erase(k);
+            s.erase(k);
+          }
+          else
+            m[k] = s[k] = i;
+        }
+
+        assert_msg(merged && m.size() == s.size() &&
+            std::equal(s.begin(), s.end(), m.begin()),
+            "Insert sorted failed.");
+      }
+
+    /// @brief Test elements out of order still get inserted
+    void test_insert_sorted_unordered() {
+      std::vector<pair<int, int>> v = {
+        make_pair(1, 1), make_pair(5, 5), make_pair(3, 3), make_pair(7, 7),
+        make_pair(3, 0), make_pair(9, 9)};
+      map<int, int> m;
+      m[6] = 6;
+      m.insert_sorted(v.begin(), v.end());
+
+      std::vector<int> keys;
+      for(auto&& x : m)
+        keys.push_back(x.first);
+
+      assert_msg(keys == std::vector<int>({1, 3, 5, 6, 7, 9}) && m.at(3) == 3,
+          "Insert sorted unordered failed.");
+    }
+
+    /// @brief Test lower_bound and upper_bound on present and absent keys
+    void test_bounds() {
+      map<int, string> m;
+      m[10] = "a";
+      m[20] = "b";
+      m[30] = "c";
+      const map<int, string>& c = m;
+
+      assert_msg(m.lower_bound(20)->second == "b" &&
+          m.upper_bound(20)->second == "c" &&
+          m.lower_bound(15)->second == "b" &&
+          m.upper_bound(15)->second == "b" &&
+          m.lower_bound(5) == m.begin() &&
+          m.lower_bound(31) == m.end() &&
+          m.upper_bound(30) == m.end() &&
+          c.lower_bound(25)->second == "c" &&
+          c.upper_bound(10)->second == "b",
+          "Bounds failed.");
+    }
+
+    /// @brief Test equal_range is one element for present keys and empty
+    ///        otherwise
+    void test_equal_range() {
+      map<int, string> m;
+      setup_dummy_map(m);
+
+      auto r1 = m.equal_range(3);
+      auto r2 = m.equal_range(6);
+
+      assert_msg(r1.first->second == "l" && std::next(r1.first) == r1.second &&
+          r2.first == r2.second && r2.first == m.end(),
+          "Equal range failed.");
+    }
+
+    /// @brief Test rank, select and count_range against std::map while
+    ///        inserting and erasing at random, and on a copy
+    template<map_balance Balance>
+      void test_rank_select() {
+        map<int, int, Balance> m;
+        std::map<int, int> s;
+        srand(13);
+        bool ok = true;
+        for(int i = 0; i < 5000; ++i) {
+          int k = rand() % 1000;
+          if(rand() % 3 == 0 && s.count(k)) {
+            m.erase(k);
+            s.erase(k);
+          }
+          else
+            m[k] = s[k] = i;
+
+          if(i % 100 == 0) {
+            size_t r = 0;
+            for(auto&& x : s) {
+              ok = ok && m.rank(x.first) == r && m.select(r)->first == x.first;
+              ++r;
+            }
+            ok = ok && m.select(r) == m.end();
+          }
+        }
+
+        const map<int, int, Balance> c(m);
+        for(int lo = -5; lo < 1005; lo += 37)
+          for(int hi = lo - 50; hi < 1005; hi += 53)
+            ok = ok && c.count_range(lo, hi) == size_t(lo < hi ?
+                std::distance(s.lower_bound(lo), s.lower_bound(hi)) : 0);
+        ok = ok && c.select(s.size() / 2)->first ==
+          std::next(s.begin(), s.size() / 2)->first;
+
+        assert_msg(ok, "Rank select failed.");
+      }
+
+    /// @brief Test lookups through a const splay map move nodes around
+    ///        without changing contents, order or iterators
+    void test_splay_lookups() {
+      map<int, int, map_balance::splay> m;
+      std::map<int, int> s;
+      srand(23);
+      for(int i = 0; i < 2000; ++i) {
+        int k = rand() % 4000;
+        m[k] = s[k] = i;
+      }
+      const map<int, int, map_balance::splay>& c = m;
+      map<int, int, map_balance::splay>::const_iterator first = c.cbegin();
+      int first_key = first->first;
+
+      bool ok = true;
+      for(int i = 0; i < 20000; ++i) {
+        int k = rand() % 16 == 0 ? rand() % 4000 : rand() % 8;
+        ok = ok && c.count(k) == s.count(k);
+        if(s.count(k))
+          ok = ok && c.at(k) == s[k] && c.find(k)->second == s[k];
+      }
+
+      assert_msg(ok && first->first == first_key && first == c.cbegin() &&
+          m.size() == s.size() && std::equal(s.begin(), s.end(), m.begin()),
+          "Splay lookups failed.");
+    }
+
+    /// @brief Setup two maps of random keys, large enough to be worked on
+    ///        in parallel, and std::map copies of them
+    void setup_random_maps(map<int, int>& a, std::map<int, int>& sa,
+        map<int, int>& b, std::map<int, int>& sb) {
+      srand(31);
+      for(int i = 0; i < 20000; ++i) {
+        int k = rand() % 30000;
+        a[k] = sa[k] = i;
+        k = rand() % 30000;
+        b[k] = sb[k] = -i;
+      }
+    }
+
+    /// @brief Test union_with keeps existing values, adds the other keys and
+    ///        leaves a map that still takes inserts and erasures
+    void test_union_with() {
+      map<int, int> a, b;
+      std::map<int, int> sa, sb;
+      setup_random_maps(a, sa, b, sb);
+
+      a.union_with(b, 4);
+      sa.insert(sb.begin(), sb.end());
+      bool merged = a.size() == sa.size() &&
+        std::equal(sa.begin(), sa.end(), a.begin()) &&
+        std::equal(sb.begin(), sb.end(), b.begin());
+      for(int i = 0; i < 1000; ++i) {
+        if(sa.count(2*i)) {
+          a.erase(2*i);
+          sa.erase(2*i);
+        }
+        a[30000 + i] = sa[30000 + i] = i;
+      }
+
+      assert_msg(merged && a.size() == sa.size() &&
+          std::equal(sa.begin(), sa.end(), a.begin()) &&
+          a.rank(15000) == size_t(std::distance(sa.begin(),
+              sa.lower_bound(15000))), "Union with failed.");
+    }
+
+    /// @brief Test intersect_with keeps the common keys with their values
+    void test_intersect_with() {
+      map<int, int> a, b;
+      std::map<int, int> sa, sb;
+      setup_random_maps(a, sa, b, sb);
+
+      a.intersect_with(b, 4);
+      for(auto i = sa.begin(); i != sa.end();)
+        i = sb.count(i->first) ? std::next(i) : sa.erase(i);
+      map<int, int> e;
+      b.intersect_with(e, 4);
+
+      assert_msg(a.size() == sa.size() &&
+          std::equal(sa.begin(), sa.end(), a.begin()) && b.empty() &&
+          b.begin() == b.end(), "Intersect with failed.");
+    }
+
+    /// @brief Test difference removes the keys of the other map
+    void test_difference() {
+      map<int, int> a, b;
+      std::map<int, int> sa, sb;
+      setup_random_maps(a, sa, b, sb);
+
+      a.difference(b, 4);
+      for(auto&& x : sb)
+        sa.erase(x.first);
+      b.difference(b);
+
+      assert_msg(a.size() == sa.size() &&
+          std::equal(sa.begin(), sa.end(), a.begin()) && b.empty(),
+          "Difference failed.");
+    }
+
+    /// @brief Test filter keeps the entries satisfying the predicate
+    void test_filter() {
+      map<int, int> a, b;
+      std::map<int, int> sa, sb;
+      setup_random_maps(a, sa, b, sb);
+
+      a.filter([](const map<int, int>::value_type& x) {
+          return x.second % 3 != 0;}, 4);
+      for(auto i = sa.begin(); i != sa.end();)
+        i = i->second % 3 != 0 ? std::next(i) : sa.erase(i);
+
+      assert_msg(a.size() == sa.size() &&
+          std::equal(sa.begin(), sa.end(), a.begin()), "Filter failed.");
+    }
+
+    /// @brief Test begin and rbegin follow erasures of the smallest and
+    ///        largest keys and inserts past either end
+    void test_cached_ends() {
+      map<int, int> m;
+      bool ok = m.begin() == m.end() && m.rbegin() == m.rend();
+      for(int i = 0; i < 100; ++i) {
+        m[100 + i] = i;
+        m[99 - i] = i;
+        ok = ok && m.begin()->first == 99 - i && m.rbegin()->first == 100 + i;
+      }
+      for(int i = 0; i < 99; ++i) {
+        m.erase(i);
+        m.erase(199 - i);
+        ok = ok && m.begin()->first == i + 1 && m.rbegin()->first == 198 - i;
+      }
+      m.erase(99);
+      m.erase(100);
+      ok = ok && m.empty() && m.begin() == m.end() && m.rbegin() == m.rend();
+      m[5] = 5;
+
+      assert_msg(ok && m.begin()->first == 5 && m.rbegin()->first == 5,
+          "Cached ends failed.");
+    }
+
+    /// @return Does \c m hold the entries of \c s, iterated both forwards
+    ///         and backwards?
+    template<typename Map>
+      static bool same(const Map& m, const std::map<int, int>& s) {
+        return m.size() == s.size() &&
+          std::equal(s.begin(), s.end(), m.cbegin()) &&
+          std::equal(s.rbegin(), s.rend(), m.crbegin());
+      }
+
+    /// @brief Test iteration of a threaded map after inserts, erasures, bulk
+    ///        loads, copies and set operations
+    void test_threaded_iteration() {
+      typedef map<int, int, map_balance::red_black, true> tmap;
+      tmap a, b;
+      std::map<int, int> sa, sb;
+      srand(37);
+      bool ok = true;
+      for(int i = 0; i < 20000; ++i) {
+        int k = rand() % 30000;
+        if(rand() % 4 == 0 && sa.count(k)) {
+          a.erase(k);
+          sa.erase(k);
+        }
+        else
+          a[k] = sa[k] = i;
+        k = rand() % 30000;
+        b[k] = sb[k] = -i;
+      }
+      ok = ok && same(a, sa);
+
+      std::vector<pair<int, int>> v;
+      for(int i = 0; i < 300; ++i)
+        v.push_back(make_pair(100*i + 50, i));
+      a.insert_sorted(v.begin(), v.end());
+      sa.insert(v.begin(), v.end());
+      ok = ok && same(a, sa);
+
+      tmap c(a);
+      tmap d;
+      d = b;
+      ok = ok && same(c, sa) && same(d, sb);
+
+      c.union_with(b, 4);
+      std::map<int, int> sc = sa;
+      sc.insert(sb.begin(), sb.end());
+      ok = ok && same(c, sc);
+      c.intersect_with(a, 4);
+      ok = ok && same(c, sa);
+      c.difference(d, 4);
+      for(auto&& x : sb)
+        sc.erase(x.first);
+      for(auto i = sc.begin(); i != sc.end();)
+        i = sa.count(i->first) ? std::next(i) : sc.erase(i);
+      ok = ok && same(c, sc);
+      d.filter([](const tmap::value_type& x) {return x.second % 2 == 0;}, 4);
+      for(auto i = sb.begin(); i != sb.end();)
+        i = i->second % 2 == 0 ? std::next(i) : sb.erase(i);
+      ok = ok && same(d, sb);
+      for(int i = 0; i < 1000; ++i) {
+        c[30000 + i] = sc[30000 + i] = i;
+        c[-1 - i] = sc[-1 - i] = i;
+      }
+      ok = ok && same(c, sc);
+
+      tmap::iterator i = c.begin();
+      while(i != c.end())
+        i = c.erase(i);
+      c.clear();
+      c[1] = 1;
+
+      assert_msg(ok && c.size() == 1 && c.begin()->first == 1 &&
+          std::next(c.begin()) == c.end() && c.rbegin()->first == 1,
+          "Threaded iteration failed.");
+    }
+
+    /// @brief Test insert with good, bad and end hints against std::map,
+    ///        feeding back the returned iterator as the next hint
+    template<typename Map>
+      void test_insert_hint() {
+        Map m;
+        std::map<int, int> s;
+        srand(41);
+        typename Map::iterator h = m.end();
+        bool ok = true;
+        for(int i = 0; ok && i < 20000; ++i) {
+          int k = i % 3 == 0 ? rand() % 30000 : i + rand() % 50;
+          if(rand() % 8 == 0)
+            h = rand() % 2 ? m.begin() : m.end();
+          bool absent = !s.count(k);
+          h = m.insert(h, make_pair(k, i));
+          s.insert(make_pair(k, i));
+          ok = h->first == k && h->second == s[k] && absent == (s[k] == i);
+        }
+
+        assert_msg(ok && same(m, s), "Insert hint failed.");
+      }
+
+    /// @brief Test emplace_hint of a nearly sorted stream and of existing keys
+    void test_emplace_hint() {
+      map<int, string> m;
+      map<int, string>::iterator h = m.end();
+      for(int i = 0; i < 1000; ++i)
+        h = m.emplace_hint(h, i ^ 3, "x");
+      h = m.emplace_hint(m.begin(), 500, "y");
+
+      bool ordered = m.size() == 1000;
+      int k = 0;
+      for(auto&& x : m)
+        ordered = ordered && x.first == k++;
+
+      assert_msg(ordered && h->first == 500 && h->second == "x",
+          "Emplace hint failed.");
+    }
+
+    /// @brief Test insert_near with clustered keys and erasures of the last
+    ///        inserted one against std::map
+    void test_insert_near() {
+      map<int, int> m;
+      std::map<int, int> s;
+      srand(43);
+      bool ok = true;
+      for(int i = 0; ok && i < 20000; ++i) {
+        int k = 100*(i/500) + rand() % 700;
+        pair<map<int, int>::iterator, bool> p = m.insert_near(make_pair(k, i));
+        ok = p.second == s.insert(make_pair(k, i)).second &&
+          p.first->first == k && p.first->second == s[k];
+        if(i % 7 == 0) {
+          m.erase(k);
+          s.erase(k);
+        }
+      }
+
+      assert_msg(ok && m.size() == s.size() &&
+          std::equal(s.begin(), s.end(), m.begin()), "Insert near failed.");
+    }
+
+    /// @brief Test rank and select stay right when hinted and finger
+    ///        inserts mix with plain inserts and erasures
+    template<map_balance Balance>
+      void test_hinted_sizes() {
+        map<int, int, Balance> m;
+        std::map<int, int> s;
+        srand(47);
+        bool ok = true;
+        for(int i = 0; ok && i < 3000; ++i) {
+          int k = rand() % 1000;
+          int op = rand() % 4;
+          if(op == 0)
+            m.emplace_hint(m.end(), k, i);
+          else if(op == 1)
+            m.insert_near(make_pair(k, i));
+          else if(op == 2)
+            m.insert(make_pair(k, i));
+          else
+            m.erase(k);
+          if(op == 3)
+            s.erase(k);
+          else
+            s.insert(make_pair(k, i));
+
+          if(i % 50 == 0) {
+            size_t r = 0;
+            for(auto&& x : s) {
+              ok = ok && m.rank(x.first) == r && m.select(r)->first == x.first;
+              ++r;
+            }
+          }
+        }
+
+        assert_msg(ok && m.size() == s.size() &&
+            std::equal(s.begin(), s.end(), m.begin()), "Hinted sizes failed.");
+      }
+
+    /// @brief Test set operations on maps filled by hinted inserts
+    void test_hinted_set_operations() {
+      map<int, int> a, b, c;
+      std::map<int, int> s;
+      for(int i = 0; i < 3000; ++i) {
+        a.emplace_hint(a.end(), 2*i, i);
+        b.emplace_hint(b.end(), 3*i, i);
+        c.insert_near(make_pair(5*i, i));
+      }
+      map<int, int> u(a);
+      u.union_with(b, 2);
+      map<int, int> n(a);
+      n.intersect_with(c, 2);
+      map<int, int> d(b);
+      d.difference(c, 2);
+
+      bool ok = u.size() == 3000 + 3000 - 1000 && n.size() == 600 &&
+        d.size() == 3000 - 600 && u.rank(3000) == u.count_range(0, 3000) &&
+        n.select(599)->first == 5990 && d.select(0)->first == 3;
+      size_t r = 0;
+      for(auto&& x : d)
+        ok = ok && d.rank(x.first) == r++ && x.first % 3 == 0 &&
+          x.first % 5 != 0;
+
+      assert_msg(ok, "Hinted set operations failed.");
+    }
+
+    /// @brief Test find_batch agrees with find on present and missing keys,
+    ///        through both the mutable and the const map
+    template<map_balance Balance>
+      void test_find_batch() {
+        map<int, int, Balance> m;
+        std::vector<int> keys;
+        srand(47);
+        for(int i = 0; i < 1001; ++i) {
+          m[rand() % 2000] = i;
+          keys.push_back(rand() % 2000);
+        }
+        typedef typename map<int, int, Balance>::iterator It;
+        typedef typename map<int, int, Balance>::const_iterator CIt;
+        std::vector<It> r;
+        std::vector<CIt> c;
+        m.find_batch(keys.begin(), keys.end(), std::back_inserter(r));
+        const map<int, int, Balance>& cm = m;
+        cm.find_batch(keys.begin(), keys.end(), std::back_inserter(c));
+        map<int, int, Balance> e;
+        It ee;
+        e.find_batch(keys.begin(), keys.begin() + 1, &ee);
+
+        bool ok = r.size() == keys.size() && c.size() == keys.size();
+        for(size_t i = 0; ok && i < keys.size(); ++i)
+          ok = r[i] == m.find(keys[i]) && c[i] == cm.find(keys[i]);
+
+        assert_msg(ok && ee == e.end(), "Find batch failed.");
+      }
+
+    /// @brief Test a filtered map against std::map through inserts, erasures
+    ///        that trigger rebuilds, copies, bulk loads and clear
+    void test_filtered_lookups() {
+      typedef map<int, int, map_balance::red_black, false, true> fmap;
+      fmap m;
+      std::map<int, int> s;
+      srand(53);
+      bool ok = true;
+      for(int i = 0; ok && i < 30000; ++i) {
+        int k = rand() % 4000;
+        if(rand() % 3 == 0 && s.count(k)) {
+          m.erase(k);
+          s.erase(k);
+        }
+        else
+          m[k] = s[k] = i;
+        k = rand() % 4000;
+        ok = m.count(k) == s.count(k) &&
+          (m.find(k) == m.end() || m.find(k)->second == s[k]);
+      }
+      fmap c(m);
+      std::vector<pair<int, int>> v;
+      for(int i = 0; i < 100; ++i)
+        v.push_back(make_pair(4000 + i, i));
+      c.insert_sorted(v.begin(), v.end());
+      for(int k = 0; ok && k < 4100; ++k)
+        ok = m.count(k) == s.count(k) && c.count(k) == s.count(k) + (k >= 4000);
+      c.clear();
+      c[7] = 7;
+
+      assert_msg(ok && same(m, s) && c.count(7) == 1 && c.count(8) == 0 &&
+          c.size() == 1, "Filtered lookups failed.");
+    }
+
+    /// @brief Test lookups in a filtered map after set operations
+    void test_filtered_set_operations() {
+      typedef map<int, int, map_balance::red_black, false, true> fmap;
+      fmap a, b;
+      std::map<int, int> sa, sb;
+      srand(59);
+      for(int i = 0; i < 5000; ++i) {
+        int k = rand() % 10000;
+        a[k] = sa[k] = i;
+        k = rand() % 10000;
+        b[k] = sb[k] = -i;
+      }
+
+      fmap u(a), d(a);
+      u.union_with(b, 2);
+      d.difference(b, 2);
+      a.intersect_with(b, 2);
+      bool ok = true;
+      for(int k = 0; ok && k < 10000; ++k)
+        ok = u.count(k) == (sa.count(k) | sb.count(k)) &&
+          d.count(k) == (sa.count(k) & !sb.count(k)) &&
+          a.count(k) == (sa.count(k) & sb.count(k));
+
+      assert_msg(ok, "Filtered set operations failed.");
+    }
 };
 
 int main() {
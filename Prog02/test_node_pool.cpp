@@ -0,0 +1,125 @@
+#include <set>
+#include <string>
+
+#include "node_pool.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using std::set;
+using std::string;
+using mystl::node_pool;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of node pool
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class node_pool_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_create();
+
+      test_distinct_storage();
+
+      test_destroy_reuses();
+
+      test_destroy_runs_destructor();
+
+      test_release();
+    }
+
+  private:
+
+    /// @brief Node which counts its live instances
+    struct counted {
+      counted(int v = 0) : value(v) {++live;}
+      ~counted() {--live;}
+      int value;
+      static int live;
+    };
+
+    /// @brief Test default constructor allocates no blocks
+    void test_default_constructor() {
+      node_pool<int> p;
+
+      assert_msg(p.block_count() == 0, "Default construction failed.");
+    }
+
+    /// @brief Test create forwards its arguments to the constructor
+    void test_create() {
+      node_pool<string> p;
+
+      string* s = p.create(3, 'x');
+
+      assert_msg(*s == "xxx" && p.block_count() == 1, "Create failed.");
+      p.destroy(s);
+    }
+
+    /// @brief Test many nodes across several blocks get distinct storage
+    void test_distinct_storage() {
+      node_pool<long> p;
+      set<long*> seen;
+      bool ok = true;
+      for(long i = 0; i < 10000; ++i) {
+        long* x = p.create(i);
+        ok = ok && seen.insert(x).second;
+      }
+
+      assert_msg(ok && p.block_count() > 1, "Distinct storage failed.");
+    }
+
+    /// @brief Test destroyed storage is handed out again first
+    void test_destroy_reuses() {
+      node_pool<int> p;
+      int* a = p.create(1);
+      p.create(2);
+      p.destroy(a);
+
+      int* b = p.create(3);
+
+      assert_msg(a == b && *b == 3 && p.block_count() == 1,
+          "Destroy reuses failed.");
+    }
+
+    /// @brief Test destroy runs the destructor of the node
+    void test_destroy_runs_destructor() {
+      node_pool<counted> p;
+      counted* a = p.create(1);
+      counted* b = p.create(2);
+      p.destroy(a);
+
+      assert_msg(counted::live == 1 && b->value == 2,
+          "Destroy runs destructor failed.");
+      p.destroy(b);
+    }
+
+    /// @brief Test release gives back all blocks and the pool stays usable
+    void test_release() {
+      node_pool<int> p;
+      for(int i = 0; i < 1000; ++i)
+        p.create(i);
+
+      p.release();
+      size_t after_release = p.block_count();
+      int* x = p.create(7);
+
+      assert_msg(after_release == 0 && *x == 7 && p.block_count() == 1,
+          "Release failed.");
+    }
+};
+
+int node_pool_test::counted::live = 0;
+
+int main() {
+  node_pool_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
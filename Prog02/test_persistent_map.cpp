@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "persistent_map.h"
+
+#include "unit_test.h"
+
+#include <iostream>
+
+using std::make_pair;
+using std::pair;
+using std::string;
+using std::vector;
+using mystl::persistent_map;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of persistent map
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class persistent_map_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_insert_not_exists();
+
+      test_insert_exists();
+
+      test_insert_or_assign();
+
+      test_erase();
+
+      test_erase_not_exists();
+
+      test_find();
+
+      test_at();
+
+      test_snapshot();
+
+      test_range_constructor();
+
+      test_versions_random();
+
+      test_reclaim();
+    }
+
+  private:
+
+    typedef persistent_map<int, string> pmap; ///< Map under test
+
+    /// @brief Value which counts its live instances
+    struct counted {
+      counted() {++live;}
+      counted(const counted&) {++live;}
+      ~counted() {--live;}
+      static int live;
+    };
+
+    /// @brief Setup map of integers to strings
+    pmap setup_dummy_map() {
+      return pmap().insert(make_pair(3, "l")).insert(make_pair(1, "H"))
+        .insert(make_pair(2, "e")).insert(make_pair(5, "o"))
+        .insert(make_pair(4, "l"));
+    }
+
+    /// @return Concatenated values of \c m in key order
+    static string values(const pmap& m) {
+      string s;
+      for(auto&& x : m)
+        s += x.second;
+      return s;
+    }
+
+    /// @brief Test default constructor generates map
+    void test_default_constructor() {
+      pmap m;
+
+      assert_msg(m.size() == 0 && m.empty() && m.begin() == m.end(),
+          "Default construction failed.");
+    }
+
+    /// @brief Test insert returns a new version and leaves the old one alone
+    void test_insert_not_exists() {
+      pmap m1 = setup_dummy_map();
+
+      pmap m2 = m1.insert(make_pair(6, "!"));
+
+      assert_msg(m1.size() == 5 && values(m1) == "Hello" &&
+          m2.size() == 6 && values(m2) == "Hello!",
+          "Insert not exists failed.");
+    }
+
+    /// @brief Test insert of an existing key keeps its value
+    void test_insert_exists() {
+      pmap m1 = setup_dummy_map();
+
+      pmap m2 = m1.insert(make_pair(2, "a"));
+
+      assert_msg(m2.size() == 5 && values(m2) == "Hello",
+          "Insert exists failed.");
+    }
+
+    /// @brief Test insert_or_assign replaces values in the new version only
+    void test_insert_or_assign() {
+      pmap m1 = setup_dummy_map();
+
+      pmap m2 = m1.insert_or_assign(make_pair(2, "a"));
+
+      assert_msg(values(m1) == "Hello" && values(m2) == "Hallo" &&
+          m2.size() == 5, "Insert or assign failed.");
+    }
+
+    /// @brief Test erase returns a new version and leaves the old one alone
+    void test_erase() {
+      pmap m1 = setup_dummy_map();
+
+      pmap m2 = m1.erase(3);
+
+      assert_msg(m1.size() == 5 && values(m1) == "Hello" &&
+          m2.size() == 4 && values(m2) == "Helo" && m2.count(3) == 0,
+          "Erase failed.");
+    }
+
+    /// @brief Test erase of a missing key changes nothing
+    void test_erase_not_exists() {
+      pmap m1 = setup_dummy_map();
+
+      pmap m2 = m1.erase(7);
+
+      assert_msg(m2.size() == 5 && values(m2) == "Hello",
+          "Erase not exists failed.");
+    }
+
+    /// @brief Test find of present and missing keys, and iterating on from
+    ///        a found element
+    void test_find() {
+      pmap m = setup_dummy_map();
+
+      pmap::const_iterator i = m.find(3);
+      string rest;
+      for(; i != m.end(); ++i)
+        rest += i->second;
+
+      assert_msg(rest == "llo" && m.find(6) == m.end() && m.count(1) == 1,
+          "Find failed.");
+    }
+
+    /// @brief Test at of present and missing keys
+    void test_at() {
+      pmap m = setup_dummy_map();
+
+      bool thrown = false;
+      try {
+        m.at(6);
+      }
+      catch(const std::out_of_range&) {
+        thrown = true;
+      }
+
+      assert_msg(m.at(5) == "o" && thrown, "At failed.");
+    }
+
+    /// @brief Test a snapshot is unaffected by later versions of its source
+    void test_snapshot() {
+      pmap m = setup_dummy_map();
+      pmap s(m);
+
+      for(int i = 10; i < 1000; ++i)
+        m = m.insert(make_pair(i, "x"));
+      m = m.erase(1).erase(2);
+
+      assert_msg(values(s) == "Hello" && s.size() == 5 && m.size() == 993,
+          "Snapshot failed.");
+    }
+
+    /// @brief Test construction from sorted and unsorted ranges
+    void test_range_constructor() {
+      vector<pair<int, string>> v = {
+        make_pair(1, "H"), make_pair(2, "e"), make_pair(3, "l"),
+        make_pair(4, "l"), make_pair(5, "o")};
+      pmap m1(v.begin(), v.end());
+      std::swap(v[0], v[4]);
+      v.push_back(make_pair(5, "x"));
+      pmap m2(v.begin(), v.end());
+
+      assert_msg(values(m1) == "Hello" && m1.size() == 5 &&
+          values(m2) == "Hello" && m2.size() == 5,
+          "Range constructor failed.");
+    }
+
+    /// @brief Test random updates against std::map, keeping every version
+    ///        and checking all of them at the end
+    void test_versions_random() {
+      vector<persistent_map<int, int>> versions(1);
+      vector<std::map<int, int>> expected(1);
+      srand(19);
+      for(int i = 0; i < 3000; ++i) {
+        int k = rand() % 300;
+        std::map<int, int> s = expected.back();
+        if(rand() % 3 == 0) {
+          s.erase(k);
+          versions.push_back(versions.back().erase(k));
+        }
+        else {
+          s[k] = i;
+          versions.push_back(versions.back().insert_or_assign(make_pair(k, i)));
+        }
+        expected.push_back(s);
+      }
+
+      bool ok = true;
+      for(size_t i = 0; ok && i < versions.size(); ++i)
+        ok = versions[i].size() == expected[i].size() &&
+          std::equal(expected[i].begin(), expected[i].end(),
+              versions[i].begin(),
+              [](const pair<const int, int>& x,
+                const persistent_map<int, int>::value_type& y) {
+              return x == y;});
+
+      assert_msg(ok, "Versions random failed.");
+    }
+
+    /// @brief Test every node is freed once all versions are gone
+    void test_reclaim() {
+      {
+        persistent_map<int, counted> m;
+        vector<persistent_map<int, counted>> versions;
+        for(int i = 0; i < 500; ++i) {
+          m = m.insert(make_pair(i * 7 % 500, counted()));
+          if(i % 50 == 0)
+            versions.push_back(m);
+        }
+        for(int i = 0; i < 500; i += 3)
+          m = m.erase(i);
+      }
+
+      assert_msg(counted::live == 0, "Reclaim failed.");
+    }
+};
+
+int persistent_map_test::counted::live = 0;
+
+int main() {
+  persistent_map_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
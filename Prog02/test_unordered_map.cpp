@@ -0,0 +1,454 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+#include "unordered_map.h"
+
+#include "unit_test.h"
+
+
+#include <iostream>
+
+using std::all_of;
+using std::string;
+using std::pair;
+using std::make_pair;
+using mystl::unordered_map;
+using std::cout;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Testing of unordered map
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class unordered_map_test : public test_class {
+
+  protected:
+
+    void test() {
+      test_default_constructor();
+
+      test_element_access_operator_exists();
+
+      test_element_access_operator_not_exists();
+
+      test_element_access_at_exists();
+
+      test_element_access_at_not_exists();
+
+      test_find_exists();
+
+      test_find_not_exists();
+
+      test_count_exists();
+
+      test_count_not_exists();
+
+      test_insert_exists();
+
+      test_insert_not_exists();
+
+      test_emplace();
+
+      test_try_emplace_exists();
+
+      test_try_emplace_not_exists();
+
+      test_insert_or_assign();
+
+      test_erase_iterator();
+
+      test_erase_key();
+
+      test_copy_constructor();
+
+      test_copy_assign();
+
+      test_clear();
+
+      test_random_insert_erase<std::hash<int>>(512);
+
+      test_random_insert_erase<std::hash<int>>(100000);
+
+      test_random_insert_erase<constant_hash>(100);
+
+      test_erase_all_iterating();
+
+      test_reserve();
+
+      test_find_batch();
+    }
+
+  private:
+
+    /// @brief Setup map of integers to strings
+    void setup_dummy_map(unordered_map<int, string>& m) {
+      m[3] = "l";
+      m[1] = "H";
+      m[2] = "e";
+      m[5] = "o";
+      m[4] = "l";
+    }
+
+    /// @brief Test default constructor generates map of size 0
+    void test_default_constructor() {
+      unordered_map<int, string> m;
+
+      assert_msg(m.size() == 0 && m.empty(),
+          "Default construction failed.");
+    }
+
+    /// @brief Test element access operator when element exists
+    void test_element_access_operator_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m[5];
+	  
+      assert_msg(val == "o", "Element access operator exists failed");
+    }
+
+    /// @brief Test element access operator when element does not exist
+    void test_element_access_operator_not_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m[7];
+	 
+      assert_msg(val == "", "Element access operator not exists failed");
+    }
+
+    /// @brief Test element access at when element exists
+    void test_element_access_at_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      string val = m.at(5);
+
+      assert_msg(val == "o", "Element access at exists failed");
+    }
+
+    /// @brief Test element access at when element does not exist, ensure this
+    ///        function will throw an error.
+    void test_element_access_at_not_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      try {
+        string val = m.at(7);
+        assert_msg(false, "Element access at not exists failed");
+      }
+      catch(const std::out_of_range&) {
+        //test success!
+      }
+      catch(...) {
+        assert_msg(false, "Element access at not exists failed");
+      }
+    }
+
+    /// @brief Test find when element exists
+    void test_find_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      unordered_map<int, string>::iterator i = m.find(5);
+		
+      assert_msg(i->first == 5 && i->second == "o", "Find exists failed.");
+    }
+
+    /// @brief Test find when element does not exist
+    void test_find_not_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      unordered_map<int, string>::iterator i = m.find(7);
+	
+      assert_msg(i == m.end(), "Find exists failed.");
+    }
+
+    /// @brief Test count when element exists
+    void test_count_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.count(5);
+
+      assert_msg(i == 1, "Count exists failed.");
+    }
+
+    /// @brief Test count when element does not exist
+    void test_count_not_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.count(7);
+
+      assert_msg(i == 0, "Count exists failed.");
+    }
+
+    /// @brief Test insertion when element is already in map
+    void test_insert_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<unordered_map<int, string>::iterator, bool> i = m.insert(make_pair(5, "o"));
+
+      unordered_map<int, string>::iterator j = m.begin();
+      while(j != m.end() && i.first != j)
+        ++j;
+	  
+      assert_msg(m.size() == 5 && i.first == j && !i.second,
+          "Insert exists failed.");
+    }
+
+    /// @brief Test insertion when element is not already in map
+    void test_insert_not_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<unordered_map<int, string>::iterator, bool> i = m.insert(make_pair(7, "!"));
+
+      unordered_map<int, string>::iterator j = m.begin();
+      while(j != m.end() && i.first != j)
+        ++j;
+
+      assert_msg(m.size() == 6 && i.first == j && i.second,
+          "Insert not exists failed.");
+    }
+
+    /// @brief Test emplace of new and existing keys
+    void test_emplace() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<unordered_map<int, string>::iterator, bool> i = m.emplace(7, "!");
+      pair<unordered_map<int, string>::iterator, bool> j = m.emplace(5, "x");
+
+      assert_msg(m.size() == 6 && i.second && i.first->second == "!" &&
+          !j.second && j.first->second == "o", "Emplace failed.");
+    }
+
+    /// @brief Test try_emplace leaves an existing element and the arguments
+    ///        untouched
+    void test_try_emplace_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+      string s = "x";
+
+      pair<unordered_map<int, string>::iterator, bool> i = m.try_emplace(5, std::move(s));
+
+      assert_msg(m.size() == 5 && !i.second && i.first->second == "o" &&
+          s == "x", "Try emplace exists failed.");
+    }
+
+    /// @brief Test try_emplace constructs the value in place
+    void test_try_emplace_not_exists() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<unordered_map<int, string>::iterator, bool> i = m.try_emplace(7, 3, '!');
+
+      assert_msg(m.size() == 6 && i.second && i.first->first == 7 &&
+          i.first->second == "!!!" && m[7] == "!!!",
+          "Try emplace not exists failed.");
+    }
+
+    /// @brief Test insert_or_assign inserts absent keys and assigns existing
+    ///        ones
+    void test_insert_or_assign() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      pair<unordered_map<int, string>::iterator, bool> i = m.insert_or_assign(5, "O");
+      pair<unordered_map<int, string>::iterator, bool> j = m.insert_or_assign(7, "!");
+
+      assert_msg(m.size() == 6 && !i.second && m.at(5) == "O" &&
+          j.second && m.at(7) == "!", "Insert or assign failed.");
+    }
+
+    /// @brief Test erase with an iterator, erasing the first element leaves
+    ///        all remaining ones at or after the returned iterator
+    void test_erase_iterator() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+      int k = m.begin()->first;
+
+      unordered_map<int, string>::iterator i = m.erase(m.begin());
+
+      size_t n = 0;
+      for(; i != m.end(); ++i)
+        ++n;
+
+      assert_msg(n == 4 && m.size() == 4 && m.count(k) == 0,
+          "Erase iterator failed.");
+    }
+
+    /// @brief Test erase with a key
+    void test_erase_key() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      size_t i = m.erase(5);
+	 
+      assert_msg(i == 1 && m.size() == 4, "Erase key failed.");
+    }
+
+    /// @brief Test copy constuction
+    void test_copy_constructor() {
+      unordered_map<int, string> m1;
+      setup_dummy_map(m1);
+
+      unordered_map<int, string> m2(m1);
+
+      for(auto&& x : m2)
+        x.second = "w";
+
+      assert_msg(m2.size() == m1.size() &&
+          all_of(m1.begin(), m1.end(),
+            [](const unordered_map<int, string>::value_type& x) {
+            return x.second != "w";}
+            ) &&
+          all_of(m2.begin(), m2.end(),
+            [](const unordered_map<int, string>::value_type& x) {
+            return x.second == "w";}
+            ),
+          "Copy constructor failed.");
+    }
+
+    /// @brief Test copy assignment
+    void test_copy_assign() {
+      unordered_map<int, string> m1;
+      setup_dummy_map(m1);
+
+      unordered_map<int, string> m2;
+      m2[4] = "*";
+
+      m2 = m1;
+
+      for(auto&& x : m2)
+        x.second = "w";
+
+      assert_msg(m2.size() == m1.size() &&
+          all_of(m1.begin(), m1.end(),
+            [](const unordered_map<int, string>::value_type& x) {
+            return x.second != "w";}
+            ) &&
+          all_of(m2.begin(), m2.end(),
+            [](const unordered_map<int, string>::value_type& x) {
+            return x.second == "w";}
+            ),
+          "Copy assign failed.");
+    }
+
+    /// @brief Test clear empties the map and leaves it usable
+    void test_clear() {
+      unordered_map<int, string> m;
+      setup_dummy_map(m);
+
+      m.clear();
+      bool cleared = m.empty() && m.begin() == m.end() && m.count(5) == 0;
+      setup_dummy_map(m);
+
+      assert_msg(cleared && m.size() == 5 && m.at(1) == "H",
+          "Clear failed.");
+    }
+
+    /// @brief Hash sending every key to the same home slot
+    struct constant_hash {
+      size_t operator()(int) const {return 0;}
+    };
+
+    /// @brief Test a random mix of insertions and erasures against
+    ///        std::unordered_map
+    /// @tparam Hash Hash function of the map
+    /// @param range Keys are drawn from [0, range)
+    template<class Hash>
+      void test_random_insert_erase(int range) {
+        unordered_map<int, int, Hash> m;
+        std::unordered_map<int, int> s;
+        srand(7);
+        bool same = true;
+        for(int i = 0; i < 20000; ++i) {
+          int k = rand() % range;
+          if(rand() % 3 == 0)
+            same = same && m.erase(k) == s.erase(k);
+          else
+            m[k] = s[k] = i;
+          if(i % 1000 == 0)
+            for(int j = 0; j < range; ++j)
+              same = same && m.count(j) == s.count(j) &&
+                (!s.count(j) || m.at(j) == s.at(j));
+        }
+
+        size_t n = 0;
+        for(auto&& x : m)
+          same = same && s.count(x.first) && s.at(x.first) == x.second && ++n;
+
+        assert_msg(same && n == s.size() && m.size() == s.size(),
+            "Random insert erase failed.");
+      }
+
+    /// @brief Test erasing all elements while iterating
+    void test_erase_all_iterating() {
+      unordered_map<int, int> m;
+      for(int i = 0; i < 1000; ++i)
+        m[i * 7] = i;
+
+      unordered_map<int, int>::iterator i = m.begin();
+      while(i != m.end())
+        i = m.erase(i);
+
+      assert_msg(m.empty() && m.begin() == m.end() && m.count(7) == 0,
+          "Erase all iterating failed.");
+    }
+
+    /// @brief Test reserve keeps the table from growing
+    void test_reserve() {
+      unordered_map<int, int> m;
+      m.reserve(1000);
+      size_t c = m.capacity();
+
+      for(int i = 0; i < 1000; ++i)
+        m[i] = i;
+
+      assert_msg(c >= 1000 && m.capacity() == c && m.size() == 1000,
+          "Reserve failed.");
+    }
+
+    /// @brief Test find_batch agrees with find on present and missing keys,
+    ///        through both the mutable and the const map
+    void test_find_batch() {
+      unordered_map<int, int> m;
+      std::vector<int> keys;
+      srand(47);
+      for(int i = 0; i < 1001; ++i) {
+        m[rand() % 2000] = i;
+        keys.push_back(rand() % 2000);
+      }
+      std::vector<unordered_map<int, int>::iterator> r;
+      std::vector<unordered_map<int, int>::const_iterator> c;
+      m.find_batch(keys.begin(), keys.end(), std::back_inserter(r));
+      const unordered_map<int, int>& cm = m;
+      cm.find_batch(keys.begin(), keys.end(), std::back_inserter(c));
+      unordered_map<int, int> e;
+      unordered_map<int, int>::iterator ee;
+      e.find_batch(keys.begin(), keys.begin() + 1, &ee);
+
+      bool ok = r.size() == keys.size() && c.size() == keys.size();
+      for(size_t i = 0; ok && i < keys.size(); ++i)
+        ok = r[i] == m.find(keys[i]) && c[i] == cm.find(keys[i]);
+
+      assert_msg(ok && ee == e.end(), "Find batch failed.");
+    }
+};
+
+int main() {
+  unordered_map_test lt;
+
+  if(lt.run())
+    std::cout << "All tests passed." << std::endl;
+
+  return 0;
+}
+
@@ -2,34 +2,158 @@
 /// @brief Example timing file. Add to this file the functions you want to time
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include "bloom_filter.h"
+#include "btree_map.h"
 #include "map.h"
+#include "unordered_map.h"
 
 using namespace std;
 using namespace chrono;
 
+/// @brief Bytes currently handed out by operator new, atomic as the threaded
+///        set operations allocate concurrently
+atomic<size_t> bytes_in_use(0);
+/// @brief Number of calls to operator new
+atomic<size_t> allocations(0);
+
+/// @brief Room in front of each block to remember its size, keeps the
+///        alignment guarantee of malloc
+const size_t alloc_header = alignof(max_align_t);
+
+/// @brief Counting operator new, used to report memory per map entry
+void* operator new(size_t n) {
+  char* p = static_cast<char*>(malloc(n + alloc_header));
+  if(!p)
+    throw bad_alloc();
+  *reinterpret_cast<size_t*>(p) = n;
+  bytes_in_use.fetch_add(n, memory_order_relaxed);
+  allocations.fetch_add(1, memory_order_relaxed);
+  return p + alloc_header;
+}
+
+/// @brief Counting operator delete
+void operator delete(void* p) noexcept {
+  if(!p)
+    return;
+  char* q = static_cast<char*>(p) - alloc_header;
+  bytes_in_use.fetch_sub(*reinterpret_cast<size_t*>(q),
+      memory_order_relaxed);
+  free(q);
+}
+
+/// @brief Counting sized operator delete
+void operator delete(void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+/// @brief Counting array operator new
+void* operator new[](size_t n) {
+  return operator new(n);
+}
+
+/// @brief Counting array operator delete
+void operator delete[](void* p) noexcept {
+  operator delete(p);
+}
+
+/// @brief Counting sized array operator delete
+void operator delete[](void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+using mystl::btree_map;
+using mystl::map;
+using mystl::map_balance;
+
 /// @brief Function to time n inserts on a linear structured tree (worst case)
+/// @tparam Map Map type with integral keys
 /// @param n Input size
+template<class Map>
 void insert_n_linear_height_tree(size_t n) {
-  using mystl::map;
   // call code to time
-  map<int, int> m;
+  Map m;
   for(size_t i = 0; i < n; ++i)
     m[i] = i;
 }
 
+/// @brief Function to time n hinted inserts in increasing order, each at the
+///        end
+/// @tparam Map Map type with integral keys
+/// @param n Input size
+template<class Map>
+void insert_n_linear_height_tree_hinted(size_t n) {
+  Map m;
+  for(size_t i = 0; i < n; ++i)
+    m.emplace_hint(m.end(), i, i);
+}
+
+/// @brief Timestamps a millisecond apart, each moved up to 16 places from its
+///        sorted position, generated once
+vector<string> nearly_sorted_keys;
+
+/// @brief Function to time n inserts of nearly sorted keys, searching from the
+///        root
+/// @tparam Map Map type with string keys
+/// @param n Input size
+template<class Map>
+void insert_n_nearly_sorted(size_t n) {
+  Map m;
+  for(size_t i = 0; i < n; ++i)
+    m[nearly_sorted_keys[i]] = i;
+}
+
+/// @brief Function to time n inserts of nearly sorted keys, each hinted with
+///        the previous one
+/// @param n Input size
+void insert_n_nearly_sorted_hinted(size_t n) {
+  map<string, int> m;
+  map<string, int>::iterator h = m.end();
+  for(size_t i = 0; i < n; ++i)
+    h = m.emplace_hint(h, nearly_sorted_keys[i], int(i));
+}
+
+/// @brief Function to time n inserts of nearly sorted keys, each searched
+///        from the finger
+/// @param n Input size
+void insert_n_nearly_sorted_near(size_t n) {
+  map<string, int> m;
+  for(size_t i = 0; i < n; ++i)
+    m.insert_near(make_pair(nearly_sorted_keys[i], int(i)));
+}
+
+/// @brief Sorted entries for bulk construction, generated once
+vector<pair<int, int>> sorted_entries;
+
+/// @brief Function to time construction from n sorted entries
+/// @tparam Map Map type with integral keys
+/// @param n Input size
+template<class Map>
+void construct_n_sorted(size_t n) {
+  Map m(sorted_entries.begin(), sorted_entries.begin() + n);
+}
+
 /// @brief Function to time n inserts on a complete binary tree (best case)
+/// @tparam Map Map type with floating point keys
 /// @param n Input size
+template<class Map>
 void insert_n_logarithmic_height_tree(size_t n) {
-  using mystl::map;
   // call code to time
-  map<double, double> m;
+  Map m;
   m[0] = 0;
   double incr = 2;
   double low = -1, high = 1;
@@ -47,11 +171,12 @@ void insert_n_logarithmic_height_tree(size_t n) {
 }
 
 /// @brief Function to time n inserts of random data (avg case)
+/// @tparam Map Map type with integral keys
 /// @param n Input size
+template<class Map>
 void insert_n_random(size_t n) {
-  using mystl::map;
   // call code to time
-  map<int, int> m;
+  Map m;
   for(size_t i = 0; i < n; ++i) {
     int j = rand();
     m[j] = j;
@@ -59,6 +184,377 @@ void insert_n_random(size_t n) {
   
 }
 
+/// @brief Function to time copy construction and copy assignment of a map of
+///        n random entries, including building and destroying all three
+/// @param n Input size
+void copy_n_random(size_t n) {
+  using mystl::map;
+  map<int, int> m;
+  for(size_t i = 0; i < n; ++i) {
+    int j = rand();
+    m[j] = j;
+  }
+  map<int, int> c(m);
+  map<int, int> d;
+  d = c;
+}
+
+/// @brief Keys of the hot-key workloads, long enough to live on the heap
+vector<string> hot_keys;
+
+/// @brief Function to time n find-or-insert operations drawn from a small set
+///        of hot keys, i.e., counting with operator[] where nearly every call
+///        hits an existing key
+/// @param n Input size
+void find_or_insert_n_hot_keys(size_t n) {
+  using mystl::map;
+  map<string, size_t> m;
+  for(size_t i = 0; i < n; ++i)
+    ++m[hot_keys[rand() % hot_keys.size()]];
+}
+
+/// @brief Function to time n find-or-insert operations on 1024 hot integer
+///        keys
+/// @param n Input size
+void find_or_insert_n_hot_ints(size_t n) {
+  using mystl::map;
+  map<int, size_t> m;
+  for(size_t i = 0; i < n; ++i)
+    ++m[rand() % 1024];
+}
+
+/// @brief Output bytes and allocations per entry of maps of random data
+/// @param max_size Maximum size of map
+///
+/// Bytes are the sizes requested from operator new, i.e., without the
+/// overhead of the system allocator.
+void memory_per_entry(size_t max_size) {
+  using mystl::map;
+  cout << "Memory per entry, map<int, int>" << endl;
+  cout << setw(15) << "Size" << setw(15) << "Bytes" << setw(15) << "Allocs"
+    << endl;
+  for(size_t i = 1024; i <= max_size; i *= 4) {
+    size_t bytes = bytes_in_use.load(), allocs = allocations.load();
+    map<int, int> m;
+    while(m.size() < i) {
+      int j = rand();
+      m[j] = j;
+    }
+    cout << setw(15) << i
+      << setw(15) << double(bytes_in_use.load() - bytes) / i
+      << setw(15) << double(allocations.load() - allocs) / i << endl;
+  }
+}
+
+/// @brief Sink for looked up values, keeps the optimizer from dropping them
+volatile size_t sink;
+
+/// @brief Time the 99 percentiles of a map of n entries found by select, the
+///        ranks of the same keys, and the percentiles found by one in-order
+///        walk as was needed before subtree sizes
+/// @param n Number of entries
+void percentile_queries(size_t n) {
+  vector<pair<int, int>> v;
+  for(size_t i = 0; i < n; ++i)
+    v.push_back(make_pair(int(2*i), rand()));
+  map<int, int> m(v.begin(), v.end());
+  v = vector<pair<int, int>>();
+
+  cout << "Percentile queries, map<int, int> of " << n << " entries" << endl;
+  cout << setw(15) << "Method" << setw(15) << "Time(sec)" << endl;
+
+  const size_t reps = 10000;
+  size_t s = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(size_t r = 0; r < reps; ++r)
+    for(size_t p = 1; p < 100; ++p)
+      s += m.select(p*(n - 1)/100)->second;
+  duration<double> diff = high_resolution_clock::now() - start;
+  cout << setw(15) << "select" << setw(15) << diff.count() / reps << endl;
+
+  start = high_resolution_clock::now();
+  for(size_t r = 0; r < reps; ++r)
+    for(size_t p = 1; p < 100; ++p)
+      s += m.rank(int(p*(n - 1)/50));
+  diff = high_resolution_clock::now() - start;
+  cout << setw(15) << "rank" << setw(15) << diff.count() / reps << endl;
+
+  start = high_resolution_clock::now();
+  size_t i = 0, p = 1;
+  for(auto it = m.begin(); p < 100; ++it, ++i)
+    if(i == p*(n - 1)/100) {
+      s += it->second;
+      ++p;
+    }
+  diff = high_resolution_clock::now() - start;
+  cout << setw(15) << "walk" << setw(15) << diff.count() << endl;
+  sink = s;
+}
+
+/// @brief Time finds of a stream of keys in a map built by inserting keys
+///        in the given order
+/// @tparam Map Map type
+/// @param keys Keys to insert
+/// @param queries Keys to find
+/// @return Seconds taken by the finds
+template<class Map>
+double find_queries(const vector<int>& keys, const vector<int>& queries) {
+  Map m;
+  for(int k : keys)
+    m[k] = k;
+
+  size_t s = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(int q : queries)
+    s += m.find(q)->second;
+  duration<double> diff = high_resolution_clock::now() - start;
+  sink = s;
+  return diff.count();
+}
+
+/// @brief Time Zipf distributed finds in maps of n random keys, for the
+///        unbalanced, red-black and splay variants
+/// @param n Number of entries
+/// @param queries Number of finds for each skew
+void zipf_queries(size_t n, size_t queries) {
+  vector<int> keys;
+  for(size_t i = 0; i < n; ++i)
+    keys.push_back(int(2*i));
+  random_shuffle(keys.begin(), keys.end());
+  vector<int> hot(keys);
+  random_shuffle(hot.begin(), hot.end());
+
+  cout << "Zipf distributed finds, " << queries << " in maps of " << n
+    << " entries" << endl;
+  cout << setw(15) << "Skew" << setw(15) << "Unbalanced" << setw(15)
+    << "Red-black" << setw(15) << "Splay" << endl;
+
+  const double skews[] = {0, 0.8, 1.1, 1.3, 1.5};
+  for(double skew : skews) {
+    // The key of rank r is drawn with probability proportional to 1/r^skew,
+    // ranks are a shuffle independent of the insertion order
+    vector<double> cdf(n);
+    double total = 0;
+    for(size_t r = 0; r < n; ++r)
+      cdf[r] = total += pow(double(r + 1), -skew);
+    vector<int> q;
+    q.reserve(queries);
+    for(size_t i = 0; i < queries; ++i) {
+      double u = total * rand() / (double(RAND_MAX) + 1);
+      q.push_back(hot[upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin()]);
+    }
+
+    cout << setw(15) << skew
+      << setw(15) << find_queries<map<int, int, map_balance::none>>(keys, q)
+      << setw(15) << find_queries<map<int, int>>(keys, q)
+      << setw(15) << find_queries<map<int, int, map_balance::splay>>(keys, q)
+      << endl;
+  }
+}
+
+/// @brief Seconds taken by \c f on a copy of \c a, the copy is not timed
+template<typename Func>
+double time_on_copy(const map<int, int>& a, Func f) {
+  map<int, int> c(a);
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  f(c);
+  duration<double> diff = high_resolution_clock::now() - start;
+  sink = c.size();
+  return diff.count();
+}
+
+/// @brief Time union, intersection and difference of a map of n random keys
+///        with maps of m random keys, element by element against the
+///        join-based set operations on one and on all hardware threads
+/// @param n Number of entries of the larger map
+void set_operations(size_t n) {
+  map<int, int> a;
+  for(size_t i = 0; i < n; ++i)
+    a[rand() % int(4*n)] = int(i);
+  size_t threads = thread::hardware_concurrency();
+
+  const char* names[] = {"union", "intersection", "difference"};
+  for(int op = 0; op < 3; ++op) {
+    cout << "Set operation " << names[op] << " of " << a.size()
+      << " and m entries (sec)" << endl;
+    cout << setw(15) << "m" << setw(15) << "Element-wise" << setw(15)
+      << "Join 1 thread" << setw(15)
+      << "Join " + to_string(threads) + " threads" << endl;
+    for(size_t m = n; m >= 256; m /= 16) {
+      map<int, int> b;
+      for(size_t i = 0; i < m; ++i)
+        b[rand() % int(4*n)] = int(i);
+
+      double loop = time_on_copy(a, [&b, op](map<int, int>& c) {
+          if(op == 0)
+            for(auto i = b.cbegin(); i != b.cend(); ++i)
+              c.insert(*i);
+          else if(op == 1) {
+            map<int, int> r;
+            for(auto i = b.cbegin(); i != b.cend(); ++i)
+              if(c.count(i->first))
+                r.insert(*c.find(i->first));
+            c = r;
+          }
+          else
+            for(auto i = b.cbegin(); i != b.cend(); ++i)
+              if(c.count(i->first))
+                c.erase(i->first);
+          });
+      double join[2];
+      for(int j = 0; j < 2; ++j) {
+        size_t t = j == 0 ? 1 : threads;
+        join[j] = time_on_copy(a, [&b, op, t](map<int, int>& c) {
+            if(op == 0)
+              c.union_with(b, t);
+            else if(op == 1)
+              c.intersect_with(b, t);
+            else
+              c.difference(b, t);
+            });
+      }
+      cout << setw(15) << b.size() << setw(15) << loop << setw(15) << join[0]
+        << setw(15) << join[1] << endl;
+    }
+  }
+}
+
+/// @brief Seconds per full forward scan of \c m, summing its values
+template<class Map>
+double scan(const Map& m, size_t reps) {
+  size_t s = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(size_t r = 0; r < reps; ++r)
+    for(auto i = m.cbegin(); i != m.cend(); ++i)
+      s += i->second;
+  duration<double> diff = high_resolution_clock::now() - start;
+  sink = s;
+  return diff.count() / reps;
+}
+
+/// @brief Time full scans of maps built by random inserts, stepping through
+///        parent links against threaded successor links and B-tree leaves
+/// @param max_size Largest map
+void full_scan(size_t max_size) {
+  cout << "Full forward scan of n random entries (sec)" << endl;
+  cout << setw(15) << "Size" << setw(15) << "Red-black" << setw(15)
+    << "Threaded" << setw(15) << "B-tree" << endl;
+  for(size_t n = 1 << 12; n <= max_size; n *= 4) {
+    map<int, int> m;
+    map<int, int, map_balance::red_black, true> t;
+    btree_map<int, int> b;
+    for(size_t i = 0; i < n; ++i) {
+      int k = rand();
+      m[k] = t[k] = b[k] = int(i);
+    }
+    size_t reps = max_size / n;
+    cout << setw(15) << m.size() << setw(15) << scan(m, reps) << setw(15)
+      << scan(t, reps) << setw(15) << scan(b, reps) << endl;
+  }
+}
+
+/// @brief Seconds taken by looking up \c keys in \c m one by one with find
+///        and all at once with find_batch
+template<class Map>
+pair<double, double> finds_vs_batch(const Map& m, const vector<int>& keys) {
+  size_t s = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(int k : keys)
+    s += m.find(k) != m.cend();
+  double one = duration<double>(high_resolution_clock::now() - start).count();
+
+  vector<typename Map::const_iterator> r(keys.size());
+  start = high_resolution_clock::now();
+  m.find_batch(keys.begin(), keys.end(), r.begin());
+  for(auto&& i : r)
+    s += i != m.cend();
+  double batch = duration<double>(high_resolution_clock::now() - start).count();
+  sink = s;
+  return make_pair(one, batch);
+}
+
+/// @brief Time random lookups, half of them hits, one by one against batched
+///        with prefetching, for growing maps
+/// @param max_size Largest map
+/// @param queries Number of lookups
+void batch_finds(size_t max_size, size_t queries) {
+  cout << "Random finds of " << queries << " keys, find against find_batch "
+    << "(sec)" << endl;
+  cout << setw(10) << "Size" << setw(12) << "map" << setw(12) << "map batch"
+    << setw(12) << "btree" << setw(12) << "btree batch" << setw(12)
+    << "hash" << setw(12) << "hash batch" << endl;
+  for(size_t n = 1 << 12; n <= max_size; n *= 4) {
+    map<int, int> m;
+    btree_map<int, int> b;
+    mystl::unordered_map<int, int> h;
+    for(size_t i = 0; i < n; ++i) {
+      int k = rand() % int(2*n);
+      m[k] = b[k] = h[k] = int(i);
+    }
+    vector<int> keys;
+    for(size_t i = 0; i < queries; ++i)
+      keys.push_back(rand() % int(2*n));
+
+    pair<double, double> tm = finds_vs_batch(m, keys);
+    pair<double, double> tb = finds_vs_batch(b, keys);
+    pair<double, double> th = finds_vs_batch(h, keys);
+    cout << setw(10) << m.size() << setw(12) << tm.first << setw(12)
+      << tm.second << setw(12) << tb.first << setw(12) << tb.second
+      << setw(12) << th.first << setw(12) << th.second << endl;
+  }
+}
+
+/// @return Seconds taken by counting \c keys in \c m
+template<class Map>
+double count_queries(const Map& m, const vector<int>& keys) {
+  size_t s = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(int k : keys)
+    s += m.count(k);
+  duration<double> diff = high_resolution_clock::now() - start;
+  sink = s;
+  return diff.count();
+}
+
+/// @brief Report the false positive rate of a full Bloom filter and time
+///        lookups, 80% of them misses and all of them hits, in maps with and
+///        without a filter, for growing maps
+/// @param max_size Largest map
+/// @param queries Number of lookups
+void filtered_lookups(size_t max_size, size_t queries) {
+  cout << "Bloom filter false positives and " << queries << " lookups (sec)"
+    << endl;
+  cout << setw(10) << "Size" << setw(12) << "FPR full" << setw(12)
+    << "80% miss" << setw(12) << "filtered" << setw(12) << "All hits"
+    << setw(12) << "filtered" << endl;
+  for(size_t n = 1 << 12; n <= max_size; n *= 4) {
+    mystl::bloom_filter<int> f(n);
+    for(size_t i = 0; i < f.capacity(); ++i)
+      f.insert(int(2*i));
+    size_t positives = 0;
+    for(size_t i = 0; i < queries; ++i)
+      positives += f.may_contain(int(2*(rand() % (4*n)) + 1));
+
+    map<int, int> m;
+    map<int, int, map_balance::red_black, false, true> fm;
+    vector<int> present;
+    for(size_t i = 0; i < n; ++i) {
+      int k = 2*rand();
+      m[k] = fm[k] = int(i);
+      present.push_back(k);
+    }
+    vector<int> mixed, hits;
+    for(size_t i = 0; i < queries; ++i) {
+      mixed.push_back(rand() % 5 == 0 ? present[rand() % n] : 2*rand() + 1);
+      hits.push_back(present[rand() % n]);
+    }
+    cout << setw(10) << m.size() << setw(12) << double(positives)/queries
+      << setw(12) << count_queries(m, mixed) << setw(12)
+      << count_queries(fm, mixed) << setw(12) << count_queries(m, hits)
+      << setw(12) << count_queries(fm, hits) << endl;
+  }
+}
+
 /// @brief Control timing of a single function
 /// @tparam Func Function type
 /// @param f Function taking a single size_t parameter
@@ -96,10 +592,84 @@ void time_function(Func f, size_t max_size, string name) {
 }
 
 /// @brief Main function to time all your functions
+///
+/// First prints tables of memory per entry, percentiles by rank and select,
+/// Zipf distributed finds on the plain, red-black and splay trees, set
+/// operations element-wise and join-based on one and all threads, full scans
+/// through parent links, threads and B-tree leaves, find against find_batch
+/// on map, B-tree and hash map, and lookups with and without a Bloom filter.
+/// Then times the insertion benchmarks on the plain binary search tree, the
+/// red-black tree and the B-tree, hinted and finger inserts with and without
+/// subtree sizes, and bulk construction from sorted entries. The linear cases
+/// of the plain tree stay at 2^15, as they are quadratic.
 int main() {
-	
-  //time_function(insert_n_linear_height_tree, pow(2, 15), "Linear height n inserts");
-  //time_function(insert_n_logarithmic_height_tree, pow(2, 22), "Logarithmic height n inserts");
-  time_function(insert_n_random, pow(2, 20), "Random n inserts");
+  for(size_t i = 0; i < 1024; ++i)
+    hot_keys.push_back("hot key number " + to_string(rand()));
+
+  for(int i = 0; i < pow(2, 22); ++i)
+    sorted_entries.push_back(make_pair(i, i));
+
+  for(size_t i = 0; i < pow(2, 20); ++i) {
+    char t[32];
+    snprintf(t, sizeof(t), "2024-06-01T%02zu:%02zu:%02zu.%03zu",
+        i/3600000 % 24, i/60000 % 60, i/1000 % 60, i % 1000);
+    nearly_sorted_keys.push_back(t);
+  }
+  for(size_t i = 0; i + 16 < nearly_sorted_keys.size(); ++i)
+    swap(nearly_sorted_keys[i], nearly_sorted_keys[i + rand() % 16]);
 
+  memory_per_entry(pow(2, 20));
+  percentile_queries(10000000);
+  zipf_queries(pow(2, 20), 10000000);
+  set_operations(pow(2, 22));
+  full_scan(pow(2, 22));
+  batch_finds(pow(2, 22), 1 << 22);
+  filtered_lookups(pow(2, 22), 1 << 22);
+  time_function(copy_n_random, pow(2, 20), "Random n inserts and copies");
+  time_function(find_or_insert_n_hot_keys, pow(2, 20),
+      "Hot string key n find-or-inserts");
+  time_function(find_or_insert_n_hot_ints, pow(2, 20),
+      "Hot integer key n find-or-inserts");
+  time_function(insert_n_linear_height_tree<map<int, int, map_balance::none>>,
+      pow(2, 15), "Linear height n inserts, unbalanced");
+  time_function(
+      insert_n_linear_height_tree_hinted<map<int, int, map_balance::none>>,
+      pow(2, 15), "Linear height n hinted inserts, unbalanced");
+  time_function(insert_n_linear_height_tree_hinted<
+      map<int, int, map_balance::none, false, false, false>>, pow(2, 22),
+      "Linear height n hinted inserts, unbalanced without sizes");
+  time_function(insert_n_linear_height_tree<map<int, int>>, pow(2, 22),
+      "Linear height n inserts, red-black");
+  time_function(insert_n_linear_height_tree_hinted<map<int, int>>, pow(2, 22),
+      "Linear height n hinted inserts, red-black");
+  time_function(insert_n_linear_height_tree_hinted<
+      map<int, int, map_balance::red_black, false, false, false>>, pow(2, 22),
+      "Linear height n hinted inserts, red-black without sizes");
+  time_function(insert_n_linear_height_tree<btree_map<int, int>>, pow(2, 22),
+      "Linear height n inserts, B-tree");
+  time_function(insert_n_nearly_sorted<map<string, int>>, pow(2, 20),
+      "Nearly sorted timestamp n inserts, red-black");
+  time_function(insert_n_nearly_sorted_hinted, pow(2, 20),
+      "Nearly sorted timestamp n hinted inserts, red-black");
+  time_function(insert_n_nearly_sorted_near, pow(2, 20),
+      "Nearly sorted timestamp n finger inserts, red-black");
+  time_function(insert_n_nearly_sorted<btree_map<string, int>>, pow(2, 20),
+      "Nearly sorted timestamp n inserts, B-tree");
+  time_function(construct_n_sorted<map<int, int, map_balance::none>>,
+      pow(2, 22), "Sorted n bulk construction, unbalanced");
+  time_function(construct_n_sorted<map<int, int>>, pow(2, 22),
+      "Sorted n bulk construction, red-black");
+  time_function(
+      insert_n_logarithmic_height_tree<map<double, double, map_balance::none>>,
+      pow(2, 22), "Logarithmic height n inserts, unbalanced");
+  time_function(insert_n_logarithmic_height_tree<map<double, double>>,
+      pow(2, 22), "Logarithmic height n inserts, red-black");
+  time_function(insert_n_logarithmic_height_tree<btree_map<double, double>>,
+      pow(2, 22), "Logarithmic height n inserts, B-tree");
+  time_function(insert_n_random<map<int, int, map_balance::none>>, pow(2, 20),
+      "Random n inserts, unbalanced");
+  time_function(insert_n_random<map<int, int>>, pow(2, 20),
+      "Random n inserts, red-black");
+  time_function(insert_n_random<btree_map<int, int>>, pow(2, 20),
+      "Random n inserts, B-tree");
 }
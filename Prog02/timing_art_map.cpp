@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of adaptive radix tree map inserts and finds against map and
+///        B-tree map on dense integers, sparse integers and URL-like strings
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "art_map.h"
+#include "btree_map.h"
+#include "map.h"
+
+using namespace std;
+using namespace chrono;
+
+using mystl::art_map;
+using mystl::btree_map;
+using mystl::map;
+
+/// @brief Sink for looked up values, keeps the optimizer from dropping them
+volatile size_t sink;
+
+/// @return Seconds since \c start
+double seconds_since(high_resolution_clock::time_point start) {
+  return duration_cast<duration<double>>(
+      high_resolution_clock::now() - start).count();
+}
+
+/// @return The integers 0 to n - 1 in random order
+vector<int> dense_keys(size_t n) {
+  vector<int> v;
+  for(size_t i = 0; i < n; ++i)
+    v.push_back(int(i));
+  random_shuffle(v.begin(), v.end());
+  return v;
+}
+
+/// @return n distinct integers spread over the whole int range, in random
+///         order
+vector<int> sparse_keys(size_t n) {
+  vector<int> v;
+  for(size_t i = 0; i < n; ++i)
+    v.push_back(int(unsigned(rand()) << 1 ^ unsigned(rand()) << 17));
+  sort(v.begin(), v.end());
+  v.erase(unique(v.begin(), v.end()), v.end());
+  random_shuffle(v.begin(), v.end());
+  return v;
+}
+
+/// @return n distinct URL-like strings of a few hosts and nested paths, in
+///         random order
+vector<string> url_keys(size_t n) {
+  const char* hosts[] = {"http://www.example.com/", "https://www.example.com/",
+    "https://docs.example.org/", "http://blog.example.net/"};
+  const char* dirs[] = {"articles/", "images/", "static/", "users/",
+    "archive/", "api/v1/", "api/v2/", "wiki/"};
+  vector<string> v;
+  for(size_t i = 0; i < n; ++i) {
+    string s = hosts[rand() % 4];
+    for(int d = rand() % 3; d >= 0; --d)
+      s += dirs[rand() % 8];
+    s += "page" + to_string(rand() % 100000) + ".html";
+    v.push_back(s);
+  }
+  sort(v.begin(), v.end());
+  v.erase(unique(v.begin(), v.end()), v.end());
+  random_shuffle(v.begin(), v.end());
+  return v;
+}
+
+/// @brief Time inserting \c keys into an empty Map and finding each of them
+///        again in another random order
+/// @return Seconds taken by the inserts and by the finds
+template<class Map, typename Key>
+pair<double, double> insert_find(const vector<Key>& keys,
+    const vector<Key>& queries) {
+  Map m;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(size_t i = 0; i < keys.size(); ++i)
+    m[keys[i]] = int(i);
+  double insert = seconds_since(start);
+
+  size_t s = 0;
+  start = high_resolution_clock::now();
+  for(auto&& k : queries)
+    s += m.find(k)->second;
+  double find = seconds_since(start);
+  sink = s;
+  return make_pair(insert, find);
+}
+
+/// @brief Print insert and find times of map, btree_map and art_map for key
+///        sets of growing size
+/// @param name Name of the key set
+/// @param make Function returning a key set of a given size
+/// @param max_size Largest key set
+template<typename Func>
+void compare(string name, Func make, size_t max_size) {
+  cout << "Inserts and finds of n keys, " << name << " (sec)" << endl;
+  cout << setw(10) << "Size" << setw(12) << "map ins" << setw(12)
+    << "btree ins" << setw(12) << "art ins" << setw(12) << "map find"
+    << setw(12) << "btree find" << setw(12) << "art find" << endl;
+  for(size_t n = 1 << 12; n <= max_size; n *= 4) {
+    auto keys = make(n);
+    auto queries = keys;
+    random_shuffle(queries.begin(), queries.end());
+    typedef typename decltype(keys)::value_type Key;
+
+    pair<double, double> m = insert_find<map<Key, int>>(keys, queries);
+    pair<double, double> b = insert_find<btree_map<Key, int>>(keys, queries);
+    pair<double, double> a = insert_find<art_map<Key, int>>(keys, queries);
+    cout << setw(10) << keys.size() << setw(12) << m.first << setw(12)
+      << b.first << setw(12) << a.first << setw(12) << m.second << setw(12)
+      << b.second << setw(12) << a.second << endl;
+  }
+}
+
+/// @brief Main function to time all your functions
+int main() {
+  compare("dense integers", dense_keys, pow(2, 22));
+  compare("sparse integers", sparse_keys, pow(2, 22));
+  compare("URL-like strings", url_keys, pow(2, 20));
+}
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of concurrent map against map behind a reader-writer lock
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+
+#include "concurrent_map.h"
+#include "map.h"
+
+using namespace std;
+using namespace chrono;
+
+/// @brief Sink for looked up values, keeps the optimizer from dropping them
+volatile size_t sink;
+
+/// @brief Keys are drawn from [0, key_range)
+const int key_range = 1 << 20;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief mystl::map shared through a single reader-writer lock, the setup
+///        concurrent_map replaces
+////////////////////////////////////////////////////////////////////////////////
+class locked_map {
+  public:
+    locked_map() {pthread_rwlock_init(&lock, nullptr);}
+    ~locked_map() {pthread_rwlock_destroy(&lock);}
+
+    bool find(int k, int& v) {
+      pthread_rwlock_rdlock(&lock);
+      mystl::map<int, int>::iterator i = m.find(k);
+      bool found = i != m.end();
+      if(found)
+        v = i->second;
+      pthread_rwlock_unlock(&lock);
+      return found;
+    }
+    bool insert(const pair<int, int>& v) {
+      pthread_rwlock_wrlock(&lock);
+      bool inserted = m.insert(v).second;
+      pthread_rwlock_unlock(&lock);
+      return inserted;
+    }
+    size_t erase(int k) {
+      pthread_rwlock_wrlock(&lock);
+      size_t erased = m.count(k) ? m.erase(k) : 0;
+      pthread_rwlock_unlock(&lock);
+      return erased;
+    }
+
+  private:
+    mystl::map<int, int> m;  ///< Shared map
+    pthread_rwlock_t lock;   ///< Guards m
+};
+
+/// @brief Run \c ops operations split over \c threads threads on a map holding
+///        half of the key range
+/// @tparam Map Map type with find, insert and erase
+/// @param threads Number of threads
+/// @param ops Total number of operations
+/// @param find_percent Percentage of finds, the rest is split evenly between
+///                     inserts and erases
+/// @return Seconds taken
+template<class Map>
+double mixed_ops(size_t threads, size_t ops, unsigned find_percent) {
+  Map m;
+  for(int k = 0; k < key_range; k += 2)
+    m.insert(make_pair(k, k));
+
+  vector<thread> workers;
+  vector<size_t> hits(threads);
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(size_t t = 0; t < threads; ++t)
+    workers.push_back(thread([&m, &hits, t, threads, ops, find_percent]() {
+          unsigned x = 2*t + 1;
+          size_t h = 0;
+          for(size_t i = 0; i < ops / threads; ++i) {
+            x = x*1103515245 + 12345;
+            int k = (x >> 4) % key_range;
+            unsigned op = (x >> 24) % 100;
+            int v;
+            if(op < find_percent)
+              h += m.find(k, v);
+            else if(op % 2)
+              h += m.insert(make_pair(k, k));
+            else
+              h += m.erase(k);
+          }
+          hits[t] = h;
+          }));
+  for(auto&& w : workers)
+    w.join();
+  duration<double> diff = duration_cast<duration<double>>(
+      high_resolution_clock::now() - start);
+
+  size_t s = 0;
+  for(size_t h : hits)
+    s += h;
+  sink = s;
+  return diff.count();
+}
+
+/// @brief Print throughput of both maps for 1 to max_threads threads
+/// @param max_threads Maximum number of threads
+/// @param find_percent Percentage of finds
+/// @param name Name of workload for nice output
+void time_threads(size_t max_threads, unsigned find_percent, string name) {
+  const size_t ops = 1 << 21;
+  cout << "Workload: " << name << ", " << ops << " operations" << endl;
+  cout << setw(15) << "Threads" << setw(20) << "Locked map Mops/s"
+    << setw(20) << "Concurrent Mops/s" << endl;
+  for(size_t t = 1; t <= max_threads; t *= 2)
+    cout << setw(15) << t
+      << setw(20) << ops / mixed_ops<locked_map>(t, ops, find_percent) / 1e6
+      << setw(20) << ops /
+      mixed_ops<mystl::concurrent_map<int, int>>(t, ops, find_percent) / 1e6
+      << endl;
+}
+
+/// @brief Main function to time all your functions
+int main() {
+  cout << "Hardware threads: " << thread::hardware_concurrency() << endl;
+  time_threads(64, 90, "90% find, 5% insert, 5% erase");
+  time_threads(64, 50, "50% find, 25% insert, 25% erase");
+}
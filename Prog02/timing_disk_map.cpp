@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of disk map startup, lookups and updates against rebuilding a
+///        map from a text file
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "disk_map.h"
+#include "map.h"
+
+using namespace std;
+using namespace chrono;
+
+using mystl::disk_access;
+using mystl::disk_map;
+using mystl::map;
+
+/// @brief Sink for looked up values, keeps the optimizer from dropping them
+volatile size_t sink;
+
+/// @brief Text file of the table, one "key value" line per entry
+const char* text_file = "timing_disk_map.txt";
+/// @brief File of the disk map
+const char* map_file = "timing_disk_map.db";
+
+/// @return Seconds since \c start
+double seconds_since(high_resolution_clock::time_point start) {
+  return duration_cast<duration<double>>(
+      high_resolution_clock::now() - start).count();
+}
+
+/// @brief Drop the cached pages of \c file, so the next access reads the disk
+void evict(const char* file) {
+  int fd = open(file, O_RDONLY);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+/// @brief Write a table of n entries with keys 0, 2, 4, ... as text
+/// @param n Number of entries
+void write_table(size_t n) {
+  ofstream out(text_file);
+  for(size_t i = 0; i < n; ++i)
+    out << 2*i << ' ' << rand() << '\n';
+}
+
+/// @brief Look up \c queries random keys of a table of \c n entries, half of
+///        them present
+/// @return Seconds taken
+template<class Map>
+double random_finds(const Map& m, size_t n, size_t queries) {
+  size_t s = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(size_t i = 0; i < queries; ++i)
+    s += m.count(int(rand() % (2*n)));
+  double t = seconds_since(start);
+  sink = s;
+  return t;
+}
+
+/// @brief Time startup of a table of n entries: rebuilding a map from the
+///        text file against opening a disk map built from it once, and the
+///        lookups that follow
+/// @param n Number of entries
+/// @param queries Number of lookups
+void startup(size_t n, size_t queries) {
+  write_table(n);
+
+  evict(text_file);
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  map<int, int> m;
+  {
+    ifstream in(text_file);
+    int k, v;
+    while(in >> k >> v)
+      m[k] = v;
+  }
+  double rebuild = seconds_since(start);
+
+  start = high_resolution_clock::now();
+  {
+    vector<pair<int, int>> v;
+    ifstream in(text_file);
+    int k, x;
+    while(in >> k >> x)
+      v.push_back(make_pair(k, x));
+    disk_map<int, int> d(map_file, v.begin(), v.end());
+  }
+  double build = seconds_since(start);
+
+  evict(map_file);
+  start = high_resolution_clock::now();
+  disk_map<int, int> d(map_file);
+  sink = d.at(int(n));
+  double open_cold = seconds_since(start);
+  double finds_cold = random_finds(d, n, queries);
+  double finds_warm = random_finds(d, n, queries);
+  double finds_map = random_finds(m, n, queries);
+
+  cout << "Table of " << n << " entries, " << queries << " random finds"
+    << endl;
+  cout << setw(40) << "Map rebuilt from text (sec)" << setw(15) << rebuild
+    << endl;
+  cout << setw(40) << "Disk map built from text (sec)" << setw(15) << build
+    << endl;
+  cout << setw(40) << "Disk map open and find, cold (sec)" << setw(15)
+    << open_cold << endl;
+  cout << setw(40) << "Random finds, disk map, cold (sec)" << setw(15)
+    << finds_cold << endl;
+  cout << setw(40) << "Random finds, disk map, warm (sec)" << setw(15)
+    << finds_warm << endl;
+  cout << setw(40) << "Random finds, map (sec)" << setw(15) << finds_map
+    << endl;
+}
+
+/// @brief Time random updates of the disk map left by startup, committing
+///        after every \c batch of them
+/// @param n Number of entries of the table
+/// @param updates Number of updates
+void updates(size_t n, size_t updates) {
+  cout << "Random updates of " << updates << " entries" << endl;
+  cout << setw(15) << "Batch" << setw(15) << "Time(sec)" << endl;
+  for(size_t batch = 1; batch <= 10000; batch *= 10) {
+    disk_map<int, int> d(map_file, disk_access::read_write);
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+    for(size_t i = 1; i <= updates; ++i) {
+      d.insert_or_assign(int(rand() % (2*n)), int(i));
+      if(i % batch == 0)
+        d.commit();
+    }
+    d.commit();
+    cout << setw(15) << batch << setw(15) << seconds_since(start) << endl;
+  }
+}
+
+/// @brief Main function to time all your functions
+int main() {
+  startup(1 << 24, 1000000);
+  updates(1 << 24, 20000);
+  remove(text_file);
+  remove(map_file);
+}
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of flat map lookups in sorted and Eytzinger layout against
+///        map and B-tree map
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "btree_map.h"
+#include "flat_map.h"
+#include "map.h"
+
+using namespace std;
+using namespace chrono;
+
+using mystl::btree_map;
+using mystl::flat_layout;
+using mystl::flat_map;
+using mystl::map;
+
+/// @brief Sink for looked up values, keeps the optimizer from dropping them
+volatile size_t sink;
+
+/// @return Seconds since \c start
+double seconds_since(high_resolution_clock::time_point start) {
+  return duration_cast<duration<double>>(
+      high_resolution_clock::now() - start).count();
+}
+
+/// @return \c q keys drawn uniformly from 0, 2, ..., 2(n - 1)
+vector<int> present_keys(size_t n, size_t q) {
+  vector<int> v;
+  for(size_t i = 0; i < q; ++i)
+    v.push_back(int(2*((size_t(rand()) << 16 ^ size_t(rand())) % n)));
+  return v;
+}
+
+/// @return Nanoseconds per lookup of \c queries in \c m, whose values equal
+///         their keys
+///
+/// Each key is xored with the difference of the previous value and key, zero
+/// but unknown to the compiler, so every lookup waits for the one before and
+/// the time is the latency of a lookup rather than the throughput of many
+/// overlapping ones.
+template<typename Map>
+double latency(const Map& m, const vector<int>& queries) {
+  int d = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(int q : queries) {
+    int k = q ^ d;
+    d = m.find(k)->second - k;
+  }
+  double t = seconds_since(start);
+  sink = d;
+  return 1e9*t/queries.size();
+}
+
+/// @brief latency for flat_map, whose find returns a pointer to the value
+template<typename Key, typename Value, flat_layout Layout>
+double latency(const flat_map<Key, Value, Layout>& m,
+    const vector<int>& queries) {
+  int d = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(int q : queries) {
+    int k = q ^ d;
+    d = *m.find(k) - k;
+  }
+  double t = seconds_since(start);
+  sink = d;
+  return 1e9*t/queries.size();
+}
+
+/// @brief Print lookup latency at sizes 1K to 100M
+/// @param queries Lookups per size
+/// @param tree_max Largest size to also build map and B-tree map at, the
+///        tree maps of 100M keys do not fit in a few GB of memory
+void lookup_latency(size_t queries, size_t tree_max) {
+  cout << "Dependent random lookups of present int keys (ns per lookup)"
+    << endl;
+  cout << setw(12) << "Keys" << setw(10) << "map" << setw(10) << "btree"
+    << setw(10) << "sorted" << setw(11) << "eytzinger" << endl;
+  const size_t sizes[] = {1000, 1000000, 10000000, 100000000};
+  for(size_t n : sizes) {
+    vector<int> q = present_keys(n, queries);
+    cout << setw(12) << n;
+    if(n <= tree_max) {
+      {
+        map<int, int> m;
+        for(size_t i = 0; i < n; ++i)
+          m.emplace_hint(m.cend(), int(2*i), int(2*i));
+        cout << setw(10) << latency(m, q);
+      }
+      {
+        btree_map<int, int> b;
+        for(size_t i = 0; i < n; ++i)
+          b.emplace(int(2*i), int(2*i));
+        cout << setw(10) << latency(b, q);
+      }
+    }
+    else
+      cout << setw(10) << "-" << setw(10) << "-";
+    vector<pair<int, int>> e;
+    for(size_t i = 0; i < n; ++i)
+      e.push_back(make_pair(int(2*i), int(2*i)));
+    {
+      flat_map<int, int, flat_layout::sorted> s(e.begin(), e.end());
+      cout << setw(10) << latency(s, q);
+    }
+    {
+      flat_map<int, int, flat_layout::eytzinger> f(e.begin(), e.end());
+      cout << setw(11) << latency(f, q) << endl;
+    }
+  }
+}
+
+/// @brief Main function to time all your functions
+int main() {
+  lookup_latency(2000000, 10000000);
+}
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of LRU, CLOCK and sharded caches on Zipf distributed traces
+///        against an LRU cache built from map and a list
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lru_cache.h"
+#include "map.h"
+
+using namespace std;
+using namespace chrono;
+
+using mystl::clock_cache;
+using mystl::lru_cache;
+using mystl::map;
+using mystl::sharded_cache;
+
+/// @return Seconds since \c start
+double seconds_since(high_resolution_clock::time_point start) {
+  return duration_cast<duration<double>>(
+      high_resolution_clock::now() - start).count();
+}
+
+/// @brief LRU cache as hand-rolled from map and a list of entries, most
+///        recent first
+class map_list_cache {
+  public:
+    /// @brief Constructor
+    /// @param c Most entries held at once
+    map_list_cache(size_t c) : cap(c) {}
+
+    /// @return Value at \c k made most recent, nullptr if absent
+    int* get(int k) {
+      auto i = index.find(k);
+      if(i == index.end())
+        return nullptr;
+      entries.splice(entries.begin(), entries, i->second);
+      return &i->second->second;
+    }
+    /// @brief Insert \c k with value \c v, evicting the least recent entry
+    ///        of a full cache
+    void put(int k, int v) {
+      if(index.size() == cap) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+      }
+      entries.push_front(make_pair(k, v));
+      index[k] = entries.begin();
+    }
+
+  private:
+    list<pair<int, int>> entries;                 ///< Entries by recency
+    map<int, list<pair<int, int>>::iterator> index; ///< Entry of each key
+    size_t cap;                                   ///< Most entries held
+};
+
+/// @return \c n requests over keys 0 to \c keys - 1, the key of rank r drawn
+///         with probability proportional to 1/r^skew
+vector<int> zipf_trace(size_t keys, double skew, size_t n) {
+  vector<double> cdf(keys);
+  double total = 0;
+  for(size_t r = 0; r < keys; ++r)
+    cdf[r] = total += pow(double(r + 1), -skew);
+  vector<int> hot;
+  for(size_t i = 0; i < keys; ++i)
+    hot.push_back(int(i));
+  random_shuffle(hot.begin(), hot.end());
+  vector<int> t;
+  t.reserve(n);
+  for(size_t i = 0; i < n; ++i) {
+    double u = total * rand() / (double(RAND_MAX) + 1);
+    t.push_back(hot[upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin()]);
+  }
+  return t;
+}
+
+/// @brief Replay \c trace on \c cache, putting every missed key
+/// @return Hit rate and seconds taken
+template<class Cache>
+pair<double, double> replay(Cache& cache, const vector<int>& trace) {
+  size_t hits = 0;
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(int k : trace) {
+    if(cache.get(k))
+      ++hits;
+    else
+      cache.put(k, k);
+  }
+  double t = seconds_since(start);
+  return make_pair(double(hits)/trace.size(), t);
+}
+
+/// @brief Print hit rates and times of the caches for Zipf traces of several
+///        skews and cache sizes
+/// @param keys Number of distinct keys
+/// @param requests Length of each trace
+void hit_rates(size_t keys, size_t requests) {
+  cout << "Zipf trace of " << requests << " requests over " << keys
+    << " keys, hit rate and time (sec)" << endl;
+  cout << setw(8) << "Skew" << setw(10) << "Cache" << setw(10) << "LRU hit"
+    << setw(10) << "CLOCK hit" << setw(12) << "map+list" << setw(12) << "LRU"
+    << setw(12) << "CLOCK" << endl;
+  const double skews[] = {0.8, 1.0, 1.2};
+  for(double skew : skews) {
+    vector<int> trace = zipf_trace(keys, skew, requests);
+    for(size_t c = keys/100; c <= keys/10; c *= 10) {
+      map_list_cache b(c);
+      lru_cache<int, int> l(c);
+      clock_cache<int, int> k(c);
+      pair<double, double> tb = replay(b, trace);
+      pair<double, double> tl = replay(l, trace);
+      pair<double, double> tk = replay(k, trace);
+      cout << setw(8) << skew << setw(10) << c << setw(10) << tl.first
+        << setw(10) << tk.first << setw(12) << tb.second << setw(12)
+        << tl.second << setw(12) << tk.second << endl;
+    }
+  }
+}
+
+/// @brief Seconds taken by \c threads threads each replaying its share of
+///        \c trace on one sharded cache
+template<class Cache>
+double replay_sharded(size_t capacity, const vector<int>& trace,
+    size_t threads) {
+  sharded_cache<Cache> cache(capacity);
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  vector<thread> t;
+  for(size_t j = 0; j < threads; ++j)
+    t.push_back(thread([&cache, &trace, threads, j]() {
+      int v;
+      for(size_t i = j; i < trace.size(); i += threads)
+        if(!cache.get(trace[i], v))
+          cache.put(trace[i], trace[i]);
+      }));
+  for(auto&& x : t)
+    x.join();
+  return seconds_since(start);
+}
+
+/// @brief Print times of the sharded caches replaying a Zipf trace on
+///        growing numbers of threads
+/// @param keys Number of distinct keys
+/// @param requests Length of the trace
+void sharded_throughput(size_t keys, size_t requests) {
+  vector<int> trace = zipf_trace(keys, 1.0, requests);
+  cout << "Sharded caches of " << keys/10 << " entries, Zipf 1.0 trace of "
+    << requests << " requests (sec)" << endl;
+  cout << setw(10) << "Threads" << setw(15) << "Sharded LRU" << setw(15)
+    << "Sharded CLOCK" << endl;
+  for(size_t threads = 1; threads <= 8; threads *= 2)
+    cout << setw(10) << threads << setw(15)
+      << replay_sharded<lru_cache<int, int>>(keys/10, trace, threads)
+      << setw(15)
+      << replay_sharded<clock_cache<int, int>>(keys/10, trace, threads)
+      << endl;
+}
+
+/// @brief Main function to time all your functions
+int main() {
+  hit_rates(1 << 20, 5000000);
+  sharded_throughput(1 << 20, 5000000);
+}
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of persistent map snapshots and updates against map copies
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "map.h"
+#include "persistent_map.h"
+
+using namespace std;
+using namespace chrono;
+
+using mystl::map;
+using mystl::persistent_map;
+
+/// @brief Sink for looked up values, keeps the optimizer from dropping them
+volatile size_t sink;
+
+/// @brief Function to time n random inserts, each making a new version
+/// @param n Input size
+void insert_n_random_persistent(size_t n) {
+  persistent_map<int, int> m;
+  for(size_t i = 0; i < n; ++i) {
+    int j = rand();
+    m = m.insert(make_pair(j, j));
+  }
+  sink = m.size();
+}
+
+/// @brief Function to time n random inserts into map
+/// @param n Input size
+void insert_n_random_map(size_t n) {
+  map<int, int> m;
+  for(size_t i = 0; i < n; ++i) {
+    int j = rand();
+    m[j] = j;
+  }
+  sink = m.size();
+}
+
+/// @brief Seconds per call of \c f, averaged over \c reps calls
+template<typename Func>
+double seconds_per_call(Func f, size_t reps) {
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  for(size_t i = 0; i < reps; ++i)
+    f();
+  duration<double> diff = duration_cast<duration<double>>(
+      high_resolution_clock::now() - start);
+  return diff.count() / reps;
+}
+
+/// @brief Time snapshots of maps of up to max_size sorted entries, the deep
+///        copy of map against the shared copy of persistent_map
+/// @param max_size Largest map
+void snapshot_n(size_t max_size) {
+  cout << "Snapshot of an n entry map" << endl;
+  cout << setw(15) << "Size" << setw(15) << "map copy" << setw(15)
+    << "persistent" << endl;
+  for(size_t n = 1024; n <= max_size; n *= 4) {
+    vector<pair<int, int>> v;
+    for(size_t i = 0; i < n; ++i)
+      v.push_back(make_pair(int(i), int(i)));
+    const map<int, int> m(v.begin(), v.end());
+    const persistent_map<int, int> p(v.begin(), v.end());
+
+    double copy = seconds_per_call([&m]() {
+        map<int, int> c(m);
+        sink = c.size();
+        }, max(size_t(1), (1 << 22) / n));
+    double snapshot = seconds_per_call([&p]() {
+        persistent_map<int, int> c(p);
+        sink = c.size();
+        }, 1000000);
+    cout << setw(15) << n << setw(15) << copy << setw(15) << snapshot << endl;
+  }
+}
+
+/// @brief Time a snapshot of a persistent map of n entries and updates to a
+///        version while the snapshot is held
+/// @param n Number of entries
+void snapshot_large(size_t n) {
+  vector<pair<int, int>> v;
+  v.reserve(n);
+  for(size_t i = 0; i < n; ++i)
+    v.push_back(make_pair(int(2*i), int(i)));
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  persistent_map<int, int> p(v.begin(), v.end());
+  duration<double> build = high_resolution_clock::now() - start;
+  v = vector<pair<int, int>>();
+
+  double snapshot = seconds_per_call([&p]() {
+      persistent_map<int, int> c(p);
+      sink = c.size();
+      }, 1000000);
+
+  persistent_map<int, int> s(p);
+  size_t k = 1;
+  double update = seconds_per_call([&p, &k, n]() {
+      p = p.insert(make_pair(int(k % (2*n)), 0));
+      k += 2*7919;
+      }, 100000);
+
+  cout << "Persistent map of " << n << " entries" << endl;
+  cout << setw(30) << "Sorted build (sec)" << setw(15) << build.count() << endl;
+  cout << setw(30) << "Snapshot (sec)" << setw(15) << snapshot << endl;
+  cout << setw(30) << "Insert, snapshot held (sec)" << setw(15) << update
+    << endl;
+  sink = s.size() + p.size();
+}
+
+/// @brief Control timing of a single function
+/// @tparam Func Function type
+/// @param f Function taking a single size_t parameter
+/// @param max_size Maximum size of test. For linear - 2^23 is good, for
+///                 quadrati - 2^18 is probably good enough, but its up to you.
+/// @param name Name of function for nice output
+///
+/// Essentially this function outputs timings for powers of 2 from 2 to
+/// max_size. For each timing it repeats the test at least 10 times to ensure
+/// a good average time.
+template<typename Func>
+void time_function(Func f, size_t max_size, string name) {
+  cout << "Function: " << name << endl;
+  cout << setw(15) << "Size" << setw(15) << "Time(sec)" << endl;
+
+  // Loop to control input size
+  for(size_t i = 2; i < max_size; i*=2) {
+    cout << setw(15) << i;
+
+    // create a clock
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+
+    // loop a specific number of times to make the clock tick
+    size_t num_itr = max(size_t(10), max_size / i);
+    for(size_t j = 0; j < num_itr; ++j)
+      f(i);
+
+    // calculate time
+    high_resolution_clock::time_point stop = high_resolution_clock::now();
+    duration<double> diff = duration_cast<duration<double>>(stop - start);
+
+    cout << setw(15) << diff.count() / num_itr << endl;
+  }
+}
+
+/// @brief Main function to time all your functions
+int main() {
+  snapshot_n(pow(2, 22));
+  snapshot_large(50000000);
+  time_function(insert_n_random_map, pow(2, 20), "Random n inserts, map");
+  time_function(insert_n_random_persistent, pow(2, 20),
+      "Random n inserts, persistent_map");
+}
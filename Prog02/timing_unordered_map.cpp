@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Timing of unordered map against std::unordered_map
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "unordered_map.h"
+
+using namespace std;
+using namespace chrono;
+
+/// @brief Sink for looked up values, keeps the optimizer from dropping them
+volatile size_t sink;
+
+/// @brief Random keys, generated once so all maps see the same input
+vector<int> keys;
+
+/// @brief Function to time n inserts of random keys
+/// @tparam Map Map type
+/// @param n Input size
+template<class Map>
+void insert_n_random(size_t n) {
+  Map m;
+  for(size_t i = 0; i < n; ++i)
+    m[keys[i]] = i;
+  sink = m.size();
+}
+
+/// @brief Function to time n successful and n unsuccessful lookups in a map of
+///        n random keys, including building it
+/// @tparam Map Map type
+/// @param n Input size
+template<class Map>
+void find_n_random(size_t n) {
+  Map m;
+  for(size_t i = 0; i < n; ++i)
+    m[keys[i]] = i;
+  size_t s = 0;
+  for(size_t i = 0; i < n; ++i) {
+    s += m.find(keys[n - 1 - i])->second;
+    s += m.count(~keys[i]);
+  }
+  sink = s;
+}
+
+/// @brief Function to time n random inserts followed by erasing all of them in
+///        a different order, then n inserts of new keys into the churned table
+/// @tparam Map Map type
+/// @param n Input size
+template<class Map>
+void insert_erase_n_random(size_t n) {
+  Map m;
+  for(size_t i = 0; i < n; ++i)
+    m[keys[i]] = i;
+  for(size_t i = 0; i < n; i += 2)
+    m.erase(keys[i]);
+  for(size_t i = 1; i < n; i += 2)
+    m.erase(keys[i]);
+  for(size_t i = 0; i < n; ++i)
+    m[~keys[i]] = i;
+  sink = m.size();
+}
+
+/// @brief Control timing of a single function
+/// @tparam Func Function type
+/// @param f Function taking a single size_t parameter
+/// @param max_size Maximum size of test. For linear - 2^23 is good, for
+///                 quadrati - 2^18 is probably good enough, but its up to you.
+/// @param name Name of function for nice output
+///
+/// Essentially this function outputs timings for powers of 2 from 2 to
+/// max_size. For each timing it repeats the test at least 10 times to ensure
+/// a good average time.
+template<typename Func>
+void time_function(Func f, size_t max_size, string name) {
+  cout << "Function: " << name << endl;
+  cout << setw(15) << "Size" << setw(15) << "Time(sec)" << endl;
+
+  // Loop to control input size
+  for(size_t i = 2; i < max_size; i*=2) {
+    cout << setw(15) << i;
+
+    // create a clock
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+
+    // loop a specific number of times to make the clock tick
+    size_t num_itr = max(size_t(10), max_size / i);
+    for(size_t j = 0; j < num_itr; ++j)
+      f(i);
+
+    // calculate time
+    high_resolution_clock::time_point stop = high_resolution_clock::now();
+    duration<double> diff = duration_cast<duration<double>>(stop - start);
+
+    cout << setw(15) << diff.count() / num_itr << endl;
+  }
+}
+
+/// @brief Main function to time all your functions
+int main() {
+  typedef std::unordered_map<int, size_t> std_map;
+  typedef mystl::unordered_map<int, size_t> my_map;
+
+  for(size_t i = 0; i < pow(2, 21); ++i)
+    keys.push_back(rand());
+
+  time_function(insert_n_random<std_map>, pow(2, 21),
+      "Random n inserts, std::unordered_map");
+  time_function(insert_n_random<my_map>, pow(2, 21),
+      "Random n inserts, mystl::unordered_map");
+  time_function(find_n_random<std_map>, pow(2, 21),
+      "Random n inserts and 2n finds, std::unordered_map");
+  time_function(find_n_random<my_map>, pow(2, 21),
+      "Random n inserts and 2n finds, mystl::unordered_map");
+  time_function(insert_erase_n_random<std_map>, pow(2, 21),
+      "Random n inserts, n erases, n inserts, std::unordered_map");
+  time_function(insert_erase_n_random<my_map>, pow(2, 21),
+      "Random n inserts, n erases, n inserts, mystl::unordered_map");
+}
@@ -0,0 +1,732 @@
+#ifndef _UNORDERED_MAP_H_
+#define _UNORDERED_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace mystl {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Unordered map implemented as an open addressing hash table with
+///        control bytes probed 16 at a time
+/// @ingroup MySTL
+/// @tparam Key Key type
+/// @tparam Value Value type
+/// @tparam Hash Hash function object type
+/// @tparam KeyEqual Key equality function object type
+///
+/// Every slot has a control byte: empty, or the low 7 bits of the hash of its
+/// key. A lookup loads the 16 control bytes starting at the home slot of the
+/// key and compares them all at once (a single SSE2 compare when available),
+/// so only slots whose 7 hash bits match are ever touched, and an empty byte
+/// in the window ends the search. Probing is linear at slot granularity,
+/// which allows erase to shift the following run of entries back into the
+/// hole instead of leaving a tombstone, so lookups never slow down from
+/// churn. The table doubles when it would become more than 3/4 full.
+///
+/// The hash is mixed before use, so weak hashes such as the identity
+/// std::hash of integers work well. Insertions may invalidate all iterators,
+/// erasure invalidates iterators to the erased element and may move others.
+////////////////////////////////////////////////////////////////////////////////
+template<typename Key, typename Value, class Hash = std::hash<Key>,
+  class KeyEqual = std::equal_to<Key>>
+class unordered_map {
+
+  template<typename>
+    class hash_iterator; ///< Forward declare iterator class
+
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    typedef Key key_type;      ///< Public access to Key type
+    typedef Value mapped_type; ///< Public access to Value type
+    typedef std::pair<const key_type, mapped_type>
+      value_type;              ///< Entry type
+    typedef Hash hasher;       ///< Hash function type
+    typedef KeyEqual key_equal; ///< Key equality type
+    typedef hash_iterator<value_type>
+      iterator;                ///< Forward iterator
+    typedef hash_iterator<const value_type>
+      const_iterator;          ///< Const forward iterator
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor, allocates nothing until the first insertion
+    /// @param h Hash function
+    /// @param eq Key equality
+    explicit unordered_map(const Hash& h = Hash(),
+        const KeyEqual& eq = KeyEqual()) :
+      ctrl(empty_group()), slots(nullptr), cap(0), sz(0), hash(h), equal(eq) {}
+    /// @brief Copy constructor
+    /// @param m Other map
+    unordered_map(const unordered_map& m) :
+      ctrl(empty_group()), slots(nullptr), cap(0), sz(0), hash(m.hash),
+      equal(m.equal) {
+      copy(m);
+    }
+    /// @brief Destructor
+    ~unordered_map() {
+      destroy_values();
+      deallocate();
+    }
+
+    /// @brief Copy assignment
+    /// @param m Other map
+    /// @return Reference to self
+    unordered_map& operator=(const unordered_map& m) {
+      if(this != &m) {
+        clear();
+        hash = m.hash;
+        equal = m.equal;
+        copy(m);
+      }
+      return *this;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Iterators
+    /// @{
+
+    /// @return Iterator to beginning
+    iterator begin() {return iterator(ctrl, slots, ctrl + cap, true);}
+    /// @return Iterator to end
+    iterator end() {return iterator(ctrl + cap, slots + cap, ctrl + cap);}
+    /// @return Iterator to beginning
+    const_iterator begin() const {return cbegin();}
+    /// @return Iterator to end
+    const_iterator end() const {return cend();}
+    /// @return Iterator to beginning
+    const_iterator cbegin() const {
+      return const_iterator(ctrl, slots, ctrl + cap, true);
+    }
+    /// @return Iterator to end
+    const_iterator cend() const {
+      return const_iterator(ctrl + cap, slots + cap, ctrl + cap);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Capacity
+    /// @{
+
+    /// @return Size of map
+    size_t size() const {return sz;}
+    /// @return Does the map contain anything?
+    bool empty() const {return sz == 0;}
+    /// @return Number of slots
+    size_t capacity() const {return cap;}
+    /// @brief Make room for \c n entries without further rehashing
+    /// @param n Number of entries
+    void reserve(size_t n) {
+      if(n == 0)
+        return;
+      size_t c = cap ? cap : group_width;
+      while(n > max_load(c))
+        c *= 2;
+      if(c != cap)
+        rehash(c);
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Element Access
+    /// @{
+
+    /// @param k Input key
+    /// @return Value at given key, inserting a default constructed value if
+    ///         \c k is not found
+    Value& operator[](const Key& k) {
+      return try_emplace(k).first->second;
+    }
+    /// @param k Input key, moved from only if it is inserted
+    /// @return Value at given key
+    Value& operator[](Key&& k) {
+      return try_emplace(std::move(k)).first->second;
+    }
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    Value& at(const Key& k) {
+      size_t i = finder(k);
+      if(i == cap)
+        throw std::out_of_range("out of range");
+      return entry(i).second;
+    }
+
+    /// @param k Input key
+    /// @return Value at given key
+    ///
+    /// If \c k is not found in the container, the function throws an
+    /// \c out_of_range exception.
+    const Value& at(const Key& k) const {
+      size_t i = finder(k);
+      if(i == cap)
+        throw std::out_of_range("out of range");
+      return entry(i).second;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Insert element into map
+    /// @param v Key, Value pair
+    /// @return pair of iterator and bool. Iterator pointing to found element or
+    ///         already existing element. bool is true if a new element was
+    ///         inserted and false if it existed.
+    std::pair<iterator, bool> insert(const value_type& v) {
+      return inserter(v.first, v);
+    }
+    /// @brief Insert element constructed from \c args if its key is absent
+    /// @tparam Args Argument types of a value_type constructor
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    template<typename... Args>
+      std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type v(std::forward<Args>(args)...);
+        return inserter(v.first, std::move(v));
+      }
+    /// @brief Insert element with key \c k and value constructed from \c args
+    ///        if \c k is absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam Args Argument types of a Value constructor
+    /// @param k Key
+    /// @param args Arguments
+    /// @return pair of iterator and bool as in insert
+    template<typename K, typename... Args>
+      std::pair<iterator, bool> try_emplace(K&& k, Args&&... args) {
+        return inserter(k, std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(k)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+      }
+    /// @brief Assign \c obj to the value at \c k, inserting \c k if absent
+    /// @tparam K Key argument type, Key or const Key&
+    /// @tparam M Value argument type
+    /// @param k Key
+    /// @param obj Value
+    /// @return pair of iterator and bool. bool is true if a new element was
+    ///         inserted and false if an existing one was assigned.
+    template<typename K, typename M>
+      std::pair<iterator, bool> insert_or_assign(K&& k, M&& obj) {
+        size_t i = finder(k);
+        if(i != cap) {
+          entry(i).second = std::forward<M>(obj);
+          return std::make_pair(at_slot(i), false);
+        }
+        return try_emplace(std::forward<K>(k), std::forward<M>(obj));
+      }
+    /// @brief Remove element at specified position
+    /// @param position Position
+    /// @return Iterator to the element which now follows the erased one
+    ///
+    /// Entries after the hole may shift back into it, so the returned
+    /// iterator can point at \c position itself. When the shift wraps around
+    /// the end of the table, an erase-while-iterating loop may see an element
+    /// twice, but never skips one.
+    iterator erase(const_iterator position) {
+      size_t i = position.s - slots;
+      eraser(i);
+      iterator r = at_slot(i);
+      if(!is_full(ctrl[i]))
+        ++r;
+      return r;
+    }
+    /// @brief Remove element with key \c k
+    /// @param k Key
+    /// @return Number of elements removed (in this case it is at most 1)
+    size_t erase(const Key& k) {
+      size_t i = finder(k);
+      if(i == cap)
+        return 0;
+      eraser(i);
+      return 1;
+    }
+    /// @brief Remove all elements, keeping the capacity
+    void clear() {
+      destroy_values();
+      if(cap)
+        std::memset(ctrl, empty_ctrl, cap + group_width - 1);
+      sz = 0;
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Operations
+    /// @{
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, end() otherwise
+    iterator find(const Key& k) {
+      return at_slot(finder(k));
+    }
+
+    /// @brief Search the container for an element with key \c k
+    /// @param k Key
+    /// @return Iterator to position if found, cend() otherwise
+    const_iterator find(const Key& k) const {
+      size_t i = finder(k);
+      return const_iterator(ctrl + i, slots + i, ctrl + cap);
+    }
+
+    /// @brief Count elements with specific keys
+    /// @param k Key
+    /// @return Count of elements with key \c k, 0 or 1
+    size_t count(const Key& k) const {
+      return finder(k) != cap ? 1 : 0;
+    }
+
+    /// @brief Search the container for the keys of a range
+    /// @tparam ForwardIterator Forward iterator over keys
+    /// @tparam OutputIterator Output iterator taking iterators
+    /// @param first Start of keys
+    /// @param last End of keys
+    /// @param out Receives for each key an iterator to its element, or end()
+    /// @return \c out past the last written iterator
+    ///
+    /// Each key is hashed batch_width keys ahead of its probe, prefetching the
+    /// control bytes and the entry at its home slot, so the cache misses of
+    /// consecutive lookups overlap instead of stalling one after another.
+    template<typename ForwardIterator, typename OutputIterator>
+      OutputIterator find_batch(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) {
+        return batch_finder<iterator>(first, last, out);
+      }
+    /// @brief Search the container for the keys of a range
+    /// @tparam ForwardIterator Forward iterator over keys
+    /// @tparam OutputIterator Output iterator taking const iterators
+    /// @param first Start of keys
+    /// @param last End of keys
+    /// @param out Receives for each key an iterator to its element, or cend()
+    /// @return \c out past the last written iterator
+    template<typename ForwardIterator, typename OutputIterator>
+      OutputIterator find_batch(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) const {
+        return batch_finder<const_iterator>(first, last, out);
+      }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Helpers
+    /// @{
+
+    typedef typename std::aligned_storage<sizeof(value_type),
+            alignof(value_type)>::type slot; ///< Raw storage of an entry
+
+    static const size_t group_width = 16;      ///< Control bytes per probe
+    static const signed char empty_ctrl = -128; ///< Control byte of an empty
+                                                ///< slot, full slots hold 7
+                                                ///< hash bits
+
+    /// @return Control bytes of a table without slots, one all-empty window
+    static signed char* empty_group() {
+      static signed char g[group_width] = {
+        empty_ctrl, empty_ctrl, empty_ctrl, empty_ctrl,
+        empty_ctrl, empty_ctrl, empty_ctrl, empty_ctrl,
+        empty_ctrl, empty_ctrl, empty_ctrl, empty_ctrl,
+        empty_ctrl, empty_ctrl, empty_ctrl, empty_ctrl};
+      return g;
+    }
+
+    /// @return Does control byte \c c mark a full slot?
+    static bool is_full(signed char c) {return c >= 0;}
+
+    /// @param c Capacity
+    /// @return Largest number of entries a table of capacity \c c holds
+    static size_t max_load(size_t c) {return c - c/4;}
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief 16 control bytes loaded at once, matches return one bit per byte
+    ////////////////////////////////////////////////////////////////////////////
+    struct group {
+#ifdef __SSE2__
+      /// @brief Load the window starting at \c c
+      explicit group(const signed char* c) :
+        bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c))) {}
+      /// @return Bit mask of the bytes equal to \c h
+      unsigned match(signed char h) const {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h)));
+      }
+      /// @return Bit mask of the empty bytes
+      unsigned match_empty() const {return match(empty_ctrl);}
+
+      __m128i bytes; ///< Control bytes
+#else
+      /// @brief Load the window starting at \c c
+      explicit group(const signed char* c) {std::memcpy(bytes, c, group_width);}
+      /// @return Bit mask of the bytes equal to \c h
+      unsigned match(signed char h) const {
+        unsigned m = 0;
+        for(size_t i = 0; i < group_width; ++i)
+          m |= unsigned(bytes[i] == h) << i;
+        return m;
+      }
+      /// @return Bit mask of the empty bytes
+      unsigned match_empty() const {return match(empty_ctrl);}
+
+      signed char bytes[group_width]; ///< Control bytes
+#endif
+    };
+
+    /// @brief Mix the user hash so that both the slot index and the 7 stored
+    ///        bits depend on every bit of it
+    size_t mix(const Key& k) const {
+      const unsigned long long golden = 0x9E3779B97F4A7C15ull;
+      size_t h = hash(k)*static_cast<size_t>(golden);
+      return h ^ (h >> (sizeof(size_t)*4));
+    }
+    /// @return Home slot of mixed hash \c h
+    size_t home(size_t h) const {return (h >> 7) & (cap - 1);}
+    /// @return Control byte of mixed hash \c h
+    static signed char h2(size_t h) {return static_cast<signed char>(h & 0x7F);}
+
+    /// @return Entry in slot \c i
+    value_type& entry(size_t i) {
+      return *reinterpret_cast<value_type*>(&slots[i]);
+    }
+    /// @return Entry in slot \c i
+    const value_type& entry(size_t i) const {
+      return *reinterpret_cast<const value_type*>(&slots[i]);
+    }
+    /// @return Iterator to slot \c i, or end() for \c cap
+    iterator at_slot(size_t i) {
+      return iterator(ctrl + i, slots + i, ctrl + cap);
+    }
+
+    /// @brief Set the control byte of slot \c i, and its clone past the end
+    ///        which lets a window starting near the end wrap around
+    void set_ctrl(size_t i, signed char c) {
+      ctrl[i] = c;
+      if(i < group_width - 1)
+        ctrl[cap + i] = c;
+    }
+
+    /// @brief Utility for finding the slot of key \c k
+    /// @param k Key
+    /// @return Slot index, or cap if \c k does not exist
+    size_t finder(const Key& k) const {
+      return sz == 0 ? cap : finder(k, mix(k));
+    }
+
+    /// @brief Utility for finding the slot of key \c k in a non-empty table
+    /// @param k Key
+    /// @param h Mixed hash of \c k
+    /// @return Slot index, or cap if \c k does not exist
+    size_t finder(const Key& k, size_t h) const {
+      signed char c = h2(h);
+      size_t mask = cap - 1;
+      for(size_t pos = home(h); ; pos = (pos + group_width) & mask) {
+        group g(ctrl + pos);
+        for(unsigned m = g.match(c); m; m &= m - 1) {
+          size_t i = (pos + __builtin_ctz(m)) & mask;
+          if(equal(entry(i).first, k))
+            return i;
+        }
+        if(g.match_empty())
+          return cap;
+      }
+    }
+
+    static const size_t batch_width = 16; ///< Lookups in flight in find_batch
+
+    /// @brief Utility for find_batch
+    /// @tparam It Iterator type to write
+    ///
+    /// Software pipelined, the key batch_width places ahead is hashed and
+    /// its home slot prefetched before the current one is probed.
+    template<typename It, typename ForwardIterator, typename OutputIterator>
+      OutputIterator batch_finder(ForwardIterator first, ForwardIterator last,
+          OutputIterator out) const {
+        if(sz == 0) {
+          for(; first != last; ++first)
+            *out++ = It(ctrl + cap, slots + cap, ctrl + cap);
+          return out;
+        }
+        size_t h[batch_width];
+        ForwardIterator ahead = first;
+        for(size_t i = 0; i < batch_width && ahead != last; ++i, ++ahead)
+          h[i] = hash_ahead(*ahead);
+        for(size_t i = 0; first != last; ++first, i = (i + 1) % batch_width) {
+          size_t j = finder(*first, h[i]);
+          if(ahead != last) {
+            h[i] = hash_ahead(*ahead);
+            ++ahead;
+          }
+          *out++ = It(ctrl + j, slots + j, ctrl + cap);
+        }
+        return out;
+      }
+
+    /// @return Mixed hash of \c k, prefetching its home slot
+    size_t hash_ahead(const Key& k) const {
+      size_t h = mix(k);
+      __builtin_prefetch(ctrl + home(h));
+      __builtin_prefetch(slots + home(h));
+      return h;
+    }
+
+    /// @param h Mixed hash
+    /// @return First empty slot at or after the home slot of \c h
+    size_t free_slot(size_t h) const {
+      size_t mask = cap - 1;
+      for(size_t pos = home(h); ; pos = (pos + group_width) & mask) {
+        unsigned m = group(ctrl + pos).match_empty();
+        if(m)
+          return (pos + __builtin_ctz(m)) & mask;
+      }
+    }
+
+    /// @brief Construct an entry in empty slot \c i from \c args
+    /// @return Slot index
+    template<typename... Args>
+      size_t construct_at(size_t i, size_t h, Args&&... args) {
+        ::new(static_cast<void*>(&slots[i])) value_type(std::forward<Args>(args)...);
+        set_ctrl(i, h2(h));
+        ++sz;
+        return i;
+      }
+
+    /// @brief Insert an entry with key \c k constructed from \c args unless
+    ///        \c k exists
+    /// @param k Key of the new entry
+    /// @param args Arguments of a value_type constructor
+    /// @return pair of iterator and bool as in insert
+    template<typename... Args>
+      std::pair<iterator, bool> inserter(const Key& k, Args&&... args) {
+        size_t i = finder(k);
+        if(i != cap)
+          return std::make_pair(at_slot(i), false);
+        size_t h = mix(k);
+        if(sz + 1 > max_load(cap))
+          reserve(sz + 1);
+        i = construct_at(free_slot(h), h, std::forward<Args>(args)...);
+        return std::make_pair(at_slot(i), true);
+      }
+
+    /// @brief Erase the entry in slot \c i and close the hole
+    /// @param i Full slot
+    ///
+    /// Backward shift deletion: walk the run of full slots after the hole and
+    /// move back every entry whose home slot does not lie between the hole
+    /// and itself, so no lookup ever has to step over an empty slot.
+    void eraser(size_t i) {
+      size_t mask = cap - 1;
+      entry(i).~value_type();
+      set_ctrl(i, empty_ctrl);
+      --sz;
+      for(size_t j = (i + 1) & mask; is_full(ctrl[j]); j = (j + 1) & mask) {
+        size_t hj = home(mix(entry(j).first));
+        if(((j - hj) & mask) >= ((j - i) & mask)) {
+          ::new(static_cast<void*>(&slots[i])) value_type(std::move(entry(j)));
+          entry(j).~value_type();
+          set_ctrl(i, ctrl[j]);
+          set_ctrl(j, empty_ctrl);
+          i = j;
+        }
+      }
+    }
+
+    /// @brief Move all entries into a table of capacity \c c
+    /// @param c New capacity, a power of two no less than group_width
+    void rehash(size_t c) {
+      signed char* old_ctrl = ctrl;
+      slot* old_slots = slots;
+      size_t old_cap = cap;
+      ctrl = new signed char[c + group_width - 1];
+      std::memset(ctrl, empty_ctrl, c + group_width - 1);
+      slots = static_cast<slot*>(::operator new(c*sizeof(slot)));
+      cap = c;
+      sz = 0;
+      for(size_t i = 0; i < old_cap; ++i)
+        if(is_full(old_ctrl[i])) {
+          value_type& v = *reinterpret_cast<value_type*>(&old_slots[i]);
+          size_t h = mix(v.first);
+          construct_at(free_slot(h), h, std::move(v));
+          v.~value_type();
+        }
+      if(old_cap) {
+        delete[] old_ctrl;
+        ::operator delete(old_slots);
+      }
+    }
+
+    /// @brief Insert copies of all entries of \c m into this empty map
+    /// @param m Other map
+    void copy(const unordered_map& m) {
+      reserve(m.sz);
+      for(const_iterator i = m.cbegin(); i != m.cend(); ++i) {
+        size_t h = mix(i->first);
+        construct_at(free_slot(h), h, *i);
+      }
+    }
+
+    /// @brief Run the destructor of every entry
+    void destroy_values() {
+      if(std::is_trivially_destructible<value_type>::value)
+        return;
+      for(size_t i = 0; i < cap; ++i)
+        if(is_full(ctrl[i]))
+          entry(i).~value_type();
+    }
+
+    /// @brief Free the table
+    void deallocate() {
+      if(cap) {
+        delete[] ctrl;
+        ::operator delete(slots);
+      }
+    }
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Data
+    /// @{
+
+    signed char* ctrl; ///< Control byte of each slot followed by clones of the
+                       ///< first group_width - 1 ones
+    slot* slots;       ///< Entry storage
+    size_t cap;        ///< Number of slots, zero or a power of two
+    size_t sz;         ///< Number of entries
+    Hash hash;         ///< Hash function
+    KeyEqual equal;    ///< Key equality
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @name Types
+    /// @{
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Forward iterator over the full slots of the table
+    /// @tparam U value_type of map
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename U>
+      class hash_iterator : public std::iterator<std::forward_iterator_tag, U> {
+        public:
+          //////////////////////////////////////////////////////////////////////
+          /// @name Constructors
+          /// @{
+
+          /// @brief Construction
+          /// @param c Control byte of position
+          /// @param v Slot of position
+          /// @param e Control byte one past the last slot
+          /// @param skip Advance to the first full slot at or after \c c
+          hash_iterator(const signed char* c = nullptr, slot* v = nullptr,
+              const signed char* e = nullptr, bool skip = false) :
+            ctrl(c), s(v), end(e) {
+            if(skip) skip_empty();
+          }
+
+          /// @brief Copy construction
+          /// @param i Other iterator
+          hash_iterator(const hash_iterator<typename std::remove_const<U>::type>& i) :
+            ctrl(i.ctrl), s(i.s), end(i.end) {}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Comparison
+          /// @{
+
+          /// @brief Equality comparison
+          /// @param i Iterator
+          bool operator==(const hash_iterator& i) const {return ctrl == i.ctrl;}
+          /// @brief Inequality comparison
+          /// @param i Iterator
+          bool operator!=(const hash_iterator& i) const {return ctrl != i.ctrl;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Dereference
+          /// @{
+
+          /// @brief Dereference operator
+          U& operator*() const {return *reinterpret_cast<U*>(s);}
+          /// @brief Dereference operator
+          U* operator->() const {return reinterpret_cast<U*>(s);}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+          //////////////////////////////////////////////////////////////////////
+          /// @name Advancement
+          /// @{
+
+          /// @brief Pre-increment
+          hash_iterator& operator++() {++ctrl; ++s; skip_empty(); return *this;}
+          /// @brief Post-increment
+          hash_iterator operator++(int) {hash_iterator tmp(*this); ++(*this); return tmp;}
+
+          /// @}
+          //////////////////////////////////////////////////////////////////////
+
+        private:
+          /// @brief Advance to the next full slot or the end
+          void skip_empty() {
+            while(ctrl != end && !is_full(*ctrl)) {
+              ++ctrl;
+              ++s;
+            }
+          }
+
+          const signed char* ctrl; ///< Control byte of position
+          slot* s;                 ///< Slot of position
+          const signed char* end;  ///< End of the control bytes
+
+          friend class unordered_map;
+      };
+
+    /// @}
+    ////////////////////////////////////////////////////////////////////////////
+
+};
+
+}
+
+#endif
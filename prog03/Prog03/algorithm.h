@@ -16,7 +16,9 @@
 #ifndef _ALGORITHM_H_
 #define _ALGORITHM_H_
 
+#include <iterator>
 #include <limits>
+#include <utility>
 #include <vector>
 #include <iostream>
 
@@ -29,10 +31,9 @@ namespace mystl {
 /// @param b Second value
 template<typename T>
   void swap(T& a, T& b) {
-    /// @todo Implement swapping values
-	T temp=b;
-	b=a;
-	a=temp;
+    T temp = std::move(b);
+    b = std::move(a);
+    a = std::move(temp);
   }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,17 +108,19 @@ template<class RandomAccessIterator, class Compare>
 template<class RandomAccessIterator, class Compare>
   void insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
       Compare comp) {
-	  for(RandomAccessIterator i=first+1; i!=last; i++){
-		RandomAccessIterator j = i; 
-			while(j>first && comp(*(j),*(j-1))){
-			swap(*(j-1),*j);
-			j--;
-			}
-			/* std::cout<<"______________"<<std::endl;
-			for(RandomAccessIterator a=first; a < last; a++)
-				std::cout<<*a<<std::endl; */
-	  } 
-	  
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+    if(first == last)
+      return;
+    // Shift larger elements right and move the element into the hole, one
+    // move per step instead of a swap
+    for(RandomAccessIterator i = first + 1; i != last; ++i) {
+      value_type v = std::move(*i);
+      RandomAccessIterator j = i;
+      for(; j != first && comp(v, *(j - 1)); --j)
+        *j = std::move(*(j - 1));
+      *j = std::move(v);
+    }
   }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -144,6 +147,35 @@ template<class RandomAccessIterator, class Compare>
 	  //insertion_sort(first,last,comp);
   }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Restore the max heap (by \c comp) rooted at \c i of the heap
+///        [first, first + n) whose subtrees are heaps
+/// @tparam RandomAccessIterator Random Access Iterator
+/// @tparam Distance Difference type of the iterator
+/// @tparam Compare Comparator function
+/// @param first Start of heap
+/// @param i Index of the root to sift down
+/// @param n Number of elements of the heap
+/// @param comp Comparator function
+///
+/// The root is moved out once and larger children moved up into the hole.
+template<class RandomAccessIterator, class Distance, class Compare>
+  void sift_down(RandomAccessIterator first, Distance i, Distance n,
+      Compare comp) {
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+    value_type v = std::move(*(first + i));
+    for(Distance c = 2*i + 1; c < n; c = 2*i + 1) {
+      if(c + 1 < n && comp(*(first + c), *(first + c + 1)))
+        ++c;
+      if(!comp(v, *(first + c)))
+        break;
+      *(first + i) = std::move(*(first + c));
+      i = c;
+    }
+    *(first + i) = std::move(v);
+  }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Sort the range [first, last) into nondecreasing order
 /// @tparam RandomAccessIterator Random Access Iterator
@@ -156,10 +188,19 @@ template<class RandomAccessIterator, class Compare>
 ///             is considered to go before the second in the ordering it
 ///             defines.
 ///
-/// Heap Sort.
+/// Heap Sort. O(n log n) in the worst case, the fallback of intro_sort.
 template<class RandomAccessIterator, class Compare>
   void heap_sort(RandomAccessIterator first, RandomAccessIterator last,
       Compare comp) {
+    typedef typename
+      std::iterator_traits<RandomAccessIterator>::difference_type diff;
+    diff n = last - first;
+    for(diff i = n/2; i-- > 0;)
+      sift_down(first, i, n, comp);
+    for(diff e = n - 1; e > 0; --e) {
+      mystl::swap(*first, *(first + e));
+      sift_down(first, diff(0), e, comp);
+    }
   }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -191,6 +232,101 @@ template<class RandomAccessIterator, class Compare>
   
  
 
+/// Ranges up to this size are left to insertion sort by intro_sort
+const size_t intro_sort_cutoff = 16;
+
+/// Ranges larger than this pick the pivot by ninther instead of median of
+/// three
+const size_t ninther_cutoff = 128;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Utility for partition_pivot, the median of three elements
+/// @tparam RandomAccessIterator Random Access Iterator
+/// @tparam Compare Comparator function
+/// @return The one of \c a, \c b and \c c whose element is the median
+template<class RandomAccessIterator, class Compare>
+  RandomAccessIterator median_of_three(RandomAccessIterator a,
+      RandomAccessIterator b, RandomAccessIterator c, Compare comp) {
+    if(comp(*a, *b))
+      return comp(*b, *c) ? b : comp(*a, *c) ? c : a;
+    return comp(*a, *c) ? a : comp(*b, *c) ? c : b;
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Partition [first, last), at least 3 elements, around a pivot
+/// @tparam RandomAccessIterator Random Access Iterator
+/// @tparam Compare Comparator function
+/// @param first Initial position of sequence to be partitioned
+/// @param last Final position of sequence to be partitioned
+/// @param comp Comparator function
+/// @return Cut such that no element of [first, cut) goes after one of
+///         [cut, last), both parts non-empty
+///
+/// The pivot is the median of the first, middle and last element, or for
+/// more than ninther_cutoff elements the median of the medians of three
+/// such triples (Tukey's ninther), and is moved to \c first. Both scans stop
+/// at elements equal to the pivot, so runs of equal keys split evenly
+/// instead of degrading to O(n^2). The other samples guarantee an element
+/// on either side of the pivot, so the scans need no bounds checks.
+template<class RandomAccessIterator, class Compare>
+  RandomAccessIterator partition_pivot(RandomAccessIterator first,
+      RandomAccessIterator last, Compare comp) {
+    auto n = last - first;
+    RandomAccessIterator mid = first + n/2;
+    RandomAccessIterator p;
+    if(size_t(n) > ninther_cutoff) {
+      auto s = n/8;
+      p = median_of_three(
+          median_of_three(first, first + s, first + 2*s, comp),
+          median_of_three(mid - s, mid, mid + s, comp),
+          median_of_three(last - 1 - 2*s, last - 1 - s, last - 1, comp),
+          comp);
+    }
+    else
+      p = median_of_three(first, mid, last - 1, comp);
+    mystl::swap(*first, *p);
+
+    RandomAccessIterator left = first + 1, right = last;
+    while(true) {
+      while(comp(*left, *first))
+        ++left;
+      --right;
+      while(comp(*first, *right))
+        --right;
+      if(!(left < right))
+        return left;
+      mystl::swap(*left, *right);
+      ++left;
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Utility for intro_sort
+/// @param depth Partitioning levels left before falling back to heap sort
+template<class RandomAccessIterator, class Compare>
+  void intro_sort_loop(RandomAccessIterator first, RandomAccessIterator last,
+      size_t depth, Compare comp) {
+    // Recurse into the smaller part and loop on the larger, so the stack
+    // stays O(log n) deep
+    while(size_t(last - first) > intro_sort_cutoff) {
+      if(depth == 0) {
+        heap_sort(first, last, comp);
+        return;
+      }
+      --depth;
+      RandomAccessIterator cut = partition_pivot(first, last, comp);
+      if(cut - first < last - cut) {
+        intro_sort_loop(first, cut, depth, comp);
+        first = cut;
+      }
+      else {
+        intro_sort_loop(cut, last, depth, comp);
+        last = cut;
+      }
+    }
+    insertion_sort(first, last, comp);
+  }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Sort the range [first, last) into nondecreasing order
 /// @tparam RandomAccessIterator Random Access Iterator
@@ -203,33 +339,51 @@ template<class RandomAccessIterator, class Compare>
 ///             is considered to go before the second in the ordering it
 ///             defines.
 ///
-/// Quick Sort.
+/// Quick Sort, pivot and partition as in partition_pivot.
 template<class RandomAccessIterator, class Compare>
   void quick_sort(RandomAccessIterator first, RandomAccessIterator last,
       Compare comp) {
-	int distance = last - first; 
-	if(distance<=0)
-		return;
-    typename RandomAccessIterator::value_type pivot = *(first + distance/2);
-    
-    if (distance != 0)
-        std::swap(*(first + distance/2), *first);
-    
-    int i = 1;
-    for (int j = 1; j < distance; j++){
-        if ( comp(*(first + j), pivot) ){
-            swap( *(first+j), *(first+i));
-            i++;
-        }
+    // Recurse into the smaller part and loop on the larger, so the stack
+    // stays O(log n) deep
+    while(last - first > 2) {
+      RandomAccessIterator cut = partition_pivot(first, last, comp);
+      if(cut - first < last - cut) {
+        quick_sort(first, cut, comp);
+        first = cut;
+      }
+      else {
+        quick_sort(cut, last, comp);
+        last = cut;
+      }
     }
-    
-    swap(*first, *(first + i - 1));
-    
-    quick_sort(first, first+i-1,comp);
-    quick_sort(first+i, last,comp);
-}
-	  
-  
+    if(last - first == 2 && comp(*(first + 1), *first))
+      mystl::swap(*first, *(first + 1));
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Sort the range [first, last) into nondecreasing order
+/// @tparam RandomAccessIterator Random Access Iterator
+/// @tparam Compare Comparator function
+/// @param first Initial position of sequence to be sorted
+/// @param last Final position of sequence to be sorted
+/// @param comp Binary function that accepts two elements in the range as
+///             arguments and returns a value convertable to bool. The value
+///             returned indicates whether the element passed as first argument
+///             is considered to go before the second in the ordering it
+///             defines.
+///
+/// Intro Sort (Musser). Quick sort that leaves ranges of at most
+/// intro_sort_cutoff elements to insertion sort, and switches a range to
+/// heap sort once its partitions have nested 2 log2(n) deep, so the worst
+/// case is O(n log n) instead of O(n^2).
+template<class RandomAccessIterator, class Compare>
+  void intro_sort(RandomAccessIterator first, RandomAccessIterator last,
+      Compare comp) {
+    size_t depth = 0;
+    for(auto n = last - first; n > 1; n /= 2)
+      depth += 2;
+    intro_sort_loop(first, last, depth, comp);
+  }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Sort the range [first, last) into nondecreasing order
@@ -250,8 +404,7 @@ template<class RandomAccessIterator, class Compare>
 template<class RandomAccessIterator, class Compare>
   void sort(RandomAccessIterator first, RandomAccessIterator last,
       Compare comp) {
-    /// @todo Call your fast sort of choice
-	quick_sort(first,last,comp);
+    intro_sort(first, last, comp);
   }
 
 ////////////////////////////////////////////////////////////////////////////////
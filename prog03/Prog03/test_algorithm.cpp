@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -37,6 +39,16 @@ class algorithm_test : public test_class {
       test_sort_integers_already_sorted();
 
       test_sort_strings();
+
+      test_heap_sort_integers();
+
+      test_quick_sort_integers();
+
+      test_sort_input_shapes();
+
+      test_sort_pointers();
+
+      test_sort_move_only();
     }
 
   private:
@@ -149,6 +161,95 @@ class algorithm_test : public test_class {
           "Sort on strings failed");
     }
 
+    ///@brief Test heap_sort using integers, including empty and single
+    ///       element ranges
+    void test_heap_sort_integers() {
+      vector<int> v = {3, 2, 5, 6, 8, 4, 3, 1};
+      vector<int> sorted = {1, 2, 3, 3, 4, 5, 6, 8};
+      vector<int> e, one = {7};
+
+      mystl::heap_sort(v.begin(), v.end(), std::less<int>());
+      mystl::heap_sort(e.begin(), e.end(), std::less<int>());
+      mystl::heap_sort(one.begin(), one.end(), std::less<int>());
+
+      assert_msg(v == sorted && e.empty() && one == vector<int>{7},
+          "Heap sort on integers failed");
+    }
+
+    ///@brief Test quick_sort using integers with many repeats
+    void test_quick_sort_integers() {
+      vector<int> v;
+      for(int i = 0; i < 1000; ++i)
+        v.push_back((i*7919) % 13);
+      vector<int> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+
+      mystl::quick_sort(v.begin(), v.end(), std::less<int>());
+
+      assert_msg(v == sorted, "Quick sort on integers failed");
+    }
+
+    ///@brief Test sort on random, sorted, reverse sorted and few unique
+    ///       sequences of every size up to 300, then of 3000 and 30000,
+    ///       large enough for ninther pivots and deep partitioning
+    void test_sort_input_shapes() {
+      srand(73);
+      bool ok = true;
+      for(int n = 0; ok && n <= 30000; n = n < 300 ? n + 1 : 10*n) {
+        for(int shape = 0; ok && shape < 4; ++shape) {
+          vector<int> v;
+          for(int i = 0; i < n; ++i)
+            v.push_back(shape == 0 ? rand() : shape == 1 ? i :
+                shape == 2 ? -i : rand() % 4);
+          vector<int> sorted = v;
+          std::sort(sorted.begin(), sorted.end());
+
+          mystl::sort(v.begin(), v.end(), std::less<int>());
+          ok = v == sorted;
+        }
+      }
+
+      assert_msg(ok, "Sort on input shapes failed");
+    }
+
+    ///@brief Test sort on raw pointers, whose value type is only known
+    ///       through iterator_traits
+    void test_sort_pointers() {
+      int a[40];
+      for(int i = 0; i < 40; ++i)
+        a[i] = (i*17) % 40;
+
+      mystl::sort(a, a + 40, std::less<int>());
+      mystl::heap_sort(a, a + 40, std::greater<int>());
+
+      bool ok = true;
+      for(int i = 0; ok && i < 40; ++i)
+        ok = a[i] == 39 - i;
+
+      assert_msg(ok, "Sort on pointers failed");
+    }
+
+    ///@brief Test sort and heap_sort on elements that can only be moved
+    void test_sort_move_only() {
+      vector<std::unique_ptr<int>> v;
+      for(int i = 0; i < 500; ++i)
+        v.push_back(std::unique_ptr<int>(new int((i*37) % 500)));
+      auto less = [](const std::unique_ptr<int>& a,
+          const std::unique_ptr<int>& b) {return *a < *b;};
+      auto greater = [](const std::unique_ptr<int>& a,
+          const std::unique_ptr<int>& b) {return *b < *a;};
+
+      mystl::sort(v.begin(), v.end(), less);
+      bool ok = true;
+      for(int i = 0; ok && i < 500; ++i)
+        ok = *v[i] == i;
+      mystl::heap_sort(v.begin(), v.end(), greater);
+      for(int i = 0; ok && i < 500; ++i)
+        ok = *v[i] == 499 - i;
+
+      assert_msg(ok, "Sort on move only elements failed");
+    }
+
 };
 
 int main() {
@@ -199,18 +199,18 @@ void time_function(Func f, size_t max_size, string name) {
 int main() {
   //time_function(bubble_sort_random_sequence_k, pow(2, 15), "Bubble Sort Random Sequence");
   time_function(slow_sort_random_sequence_k, pow(2, 17), "Slow Sort Random Sequence");
-  //time_function(sort_random_sequence_k, pow(2, 23), "Sort Random Sequence");
+  time_function(sort_random_sequence_k, pow(2, 23), "Sort Random Sequence");
   
   //time_function(bubble_sort_ordered_k, pow(2, 15), "Bubble Sort Ordered Sequence");
   time_function(slow_sort_ordered_k, pow(2, 17), "Slow Sort Ordered Sequence");
-  //time_function(sort_ordered_k, pow(2, 23), "Sort Ordered Sequence");
+  time_function(sort_ordered_k, pow(2, 23), "Sort Ordered Sequence");
  
  // time_function(bubble_sort_r_ordered_k, pow(2, 15), "Bubble Sort Reverse Ordered Sequence");
   time_function(slow_sort_r_ordered_k, pow(2, 17), "Slow Sort Reverse Ordered Sequence");
-  //time_function(sort_r_ordered_k, pow(2, 23), "Sort Reverse Ordered Sequence");
+  time_function(sort_r_ordered_k, pow(2, 23), "Sort Reverse Ordered Sequence");
   
   //time_function(bubble_sort_unique_k, pow(2, 15), "Bubble Sort Unique Elements Sequence");
   time_function(slow_sort_unique_k, pow(2, 17), "Slow Sort Unique Elements Sequence");
-  //time_function(sort_unique_k, pow(2, 18), "Sort Unique Elements Sequence");
+  time_function(sort_unique_k, pow(2, 23), "Sort Unique Elements Sequence");
   
 }
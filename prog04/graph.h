@@ -32,6 +32,9 @@ template<typename VertexProperty, typename EdgeProperty>
     /// @name Types
     /// @{
       
+      typedef VertexProperty vertex_property; //<vertex property type
+      typedef EdgeProperty edge_property; //<edge property type
+
       typedef size_t vertex_descriptor; //<unique vertex identifier
 
       typedef pair<size_t, size_t> edge_descriptor; //<unique edge identifier
@@ -184,7 +187,7 @@ template<typename VertexProperty, typename EdgeProperty>
 		verts[end]->add_edge_out(from);
 		verts[end]->add_edge_in(to);
 		num_edge=num_edge+2;
-		vert_desc+=2;
+		edge_desc+=2;
 	  }
 	  //erases the vertex by calling nullout, null in and make empty
       void erase_vertex(vertex_descriptor a){
@@ -1,6 +1,14 @@
 #ifndef _GRAPH_ALGORITHMS_H_
 #define _GRAPH_ALGORITHMS_H_
 
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+#include "indexed_priority_queue.h"
+#include "radix_heap.h"
+
 namespace mystl {
 
 //Here is an example list of the basic algorithms we will work with in class. I
@@ -25,39 +33,198 @@ template<typename Graph, typename ParentMap>
 
   
   //takes in a graph and parentmap. 
-  //populates parentmap with child-parent key value pairs
+  //populates parentmap with child-parent key value pairs, the root of every
+  //tree in the forest is its own parent
 template<typename Graph, typename ParentMap>
   void breadth_first_search(const Graph& g, ParentMap& p){
-		vector<bool> visitedYet;
-		for(int i=0;i<g.num_of_vertices();i++){
-			visited[i]=false;
-		}
-		size_t start=0;
-		while(!visted.empty){
-			list<size_t> visited.push_back(start);
-			for(auto i=g.find_vertex(start)->begin();i!=g.find_vertex(start)->end;i++){
-			if(visitedYet[i->property()]=false){
-				p[i->property]=start;
-				visitedYet[i->property()]=true;
-				visited.push_back(i->property());
+		typedef typename Graph::vertex_descriptor vertex_descriptor;
+		size_t n=g.vertices_cend()-g.vertices_cbegin();
+		std::vector<bool> visitedYet(n, false);
+		std::queue<vertex_descriptor> visited;
+		for(vertex_descriptor start=0;start<n;start++){
+			if(visitedYet[start])
+				continue;
+			visitedYet[start]=true;
+			p[start]=start;
+			visited.push(start);
+			while(!visited.empty()){
+				vertex_descriptor u=visited.front();
+				visited.pop();
+				auto vert=*g.find_vertex(u);
+				for(auto i=vert->cbegin();i!=vert->cend();i++){
+					vertex_descriptor v=(*i)->target();
+					//erased edges point outside of the vertex range
+					if(v<n && !visitedYet[v]){
+						p[v]=u;
+						visitedYet[v]=true;
+						visited.push(v);
+					}
 				}
+			}
+		}
+  }
+
+  //takes in a graph and parentmap, Heap is an indexed priority queue over
+  //vertex descriptors, e.g., indexed_priority_queue or pairing_heap.
+  //populates parentmap with the minimum spanning forest, the root of every
+  //tree is its own parent. Uses decrease_key so every vertex is in the heap
+  //at most once.
+template<typename Heap, typename Graph, typename ParentMap>
+  void mst_prim_jarniks(const Graph& g, ParentMap& p){
+		typedef typename Graph::vertex_descriptor vertex_descriptor;
+		typedef typename Graph::edge_property edge_property;
+		size_t n=g.vertices_cend()-g.vertices_cbegin();
+		std::vector<bool> reached(n, false);
+		Heap q(n);
+		for(vertex_descriptor root=0;root<n;root++){
+			if(reached[root])
+				continue;
+			reached[root]=true;
+			p[root]=root;
+			q.push(root, edge_property());
+			while(!q.empty()){
+				vertex_descriptor u=q.top();
+				q.pop();
+				auto vert=*g.find_vertex(u);
+				for(auto i=vert->cbegin();i!=vert->cend();i++){
+					vertex_descriptor v=(*i)->target();
+					if(v>=n)
+						continue;
+					const edge_property& w=(*i)->property();
+					if(!reached[v]){
+						reached[v]=true;
+						p[v]=u;
+						q.push(v, w);
+					}
+					else if(q.contains(v) && w<q.priority(v)){
+						p[v]=u;
+						q.decrease_key(v, w);
+					}
 				}
-				start++;
+			}
 		}
-		
   }
-  
-  
-  
 
+  //minimum spanning forest using a 4-ary indexed heap
 template<typename Graph, typename ParentMap>
-  void mst_prim_jarniks(const Graph& g, ParentMap& p);
+  void mst_prim_jarniks(const Graph& g, ParentMap& p){
+		mst_prim_jarniks<indexed_priority_queue<typename Graph::edge_property>>(
+				g, p);
+  }
 
 template<typename Graph, typename ParentMap>
   void mst_kruskals(const Graph& g, ParentMap& p);
 
+  //takes in a graph, parentmap and distancemap, Heap is an indexed priority
+  //queue over vertex descriptors, e.g., indexed_priority_queue or
+  //pairing_heap. The source is the first vertex. Populates parentmap with the
+  //shortest path tree (the source is its own parent) and distancemap with the
+  //path weights of every vertex reachable from the source. Uses decrease_key
+  //so every vertex is in the heap at most once.
+template<typename Heap, typename Graph, typename ParentMap, typename DistanceMap>
+  void sssp_dijkstras(const Graph& g, ParentMap& p, DistanceMap& d){
+		typedef typename Graph::vertex_descriptor vertex_descriptor;
+		typedef typename Graph::edge_property edge_property;
+		size_t n=g.vertices_cend()-g.vertices_cbegin();
+		if(n==0)
+			return;
+		std::vector<bool> reached(n, false);
+		Heap q(n);
+		vertex_descriptor source=0;
+		reached[source]=true;
+		p[source]=source;
+		d[source]=edge_property();
+		q.push(source, edge_property());
+		while(!q.empty()){
+			vertex_descriptor u=q.top();
+			edge_property du=q.top_priority();
+			q.pop();
+			auto vert=*g.find_vertex(u);
+			for(auto i=vert->cbegin();i!=vert->cend();i++){
+				vertex_descriptor v=(*i)->target();
+				if(v>=n)
+					continue;
+				edge_property dv=du+(*i)->property();
+				if(!reached[v]){
+					reached[v]=true;
+					p[v]=u;
+					d[v]=dv;
+					q.push(v, dv);
+				}
+				else if(q.contains(v) && dv<q.priority(v)){
+					p[v]=u;
+					d[v]=dv;
+					q.decrease_key(v, dv);
+				}
+			}
+		}
+  }
+
+  //single source shortest paths for nonnegative integer edge properties
+  //using a monotone radix heap. There is no decrease_key, so a vertex is
+  //pushed again on every improvement and stale entries are skipped when they
+  //are popped. Same source and output as sssp_dijkstras.
 template<typename Graph, typename ParentMap, typename DistanceMap>
-  void sssp_dijkstras(const Graph& g, ParentMap& p, DistanceMap& d);
+  void sssp_dijkstras_radix(const Graph& g, ParentMap& p, DistanceMap& d){
+		typedef typename Graph::vertex_descriptor vertex_descriptor;
+		typedef typename Graph::edge_property edge_property;
+		typedef typename std::make_unsigned<edge_property>::type key_type;
+		size_t n=g.vertices_cend()-g.vertices_cbegin();
+		if(n==0)
+			return;
+		std::vector<bool> done(n, false);
+		std::vector<key_type> best(n, std::numeric_limits<key_type>::max());
+		radix_heap<key_type, vertex_descriptor> q;
+		vertex_descriptor source=0;
+		best[source]=0;
+		p[source]=source;
+		d[source]=edge_property();
+		q.push(0, source);
+		while(!q.empty()){
+			key_type du=q.top().first;
+			vertex_descriptor u=q.top().second;
+			q.pop();
+			if(done[u])
+				continue;
+			done[u]=true;
+			auto vert=*g.find_vertex(u);
+			for(auto i=vert->cbegin();i!=vert->cend();i++){
+				vertex_descriptor v=(*i)->target();
+				if(v>=n || done[v])
+					continue;
+				key_type dv=du+key_type((*i)->property());
+				if(dv<best[v]){
+					best[v]=dv;
+					p[v]=u;
+					d[v]=edge_property(dv);
+					q.push(dv, v);
+				}
+			}
+		}
+  }
+
+  //integer edge properties use the radix heap
+template<typename Graph, typename ParentMap, typename DistanceMap>
+  void sssp_dijkstras(const Graph& g, ParentMap& p, DistanceMap& d,
+			std::true_type){
+		sssp_dijkstras_radix(g, p, d);
+  }
+
+  //all other edge properties use a 4-ary indexed heap
+template<typename Graph, typename ParentMap, typename DistanceMap>
+  void sssp_dijkstras(const Graph& g, ParentMap& p, DistanceMap& d,
+			std::false_type){
+		sssp_dijkstras<indexed_priority_queue<typename Graph::edge_property>>(
+				g, p, d);
+  }
+
+  //single source shortest paths, the priority queue is chosen by the type of
+  //the edge property
+template<typename Graph, typename ParentMap, typename DistanceMap>
+  void sssp_dijkstras(const Graph& g, ParentMap& p, DistanceMap& d){
+		sssp_dijkstras(g, p, d,
+				std::is_integral<typename Graph::edge_property>());
+  }
 
 template<typename Graph, typename ParentMap, typename DistanceMap>
   void sssp_bellman_ford(const Graph& g, ParentMap& p, DistanceMap& d);
@@ -1,7 +1,15 @@
 #include "graph.h"
 #include "graph_algorithms.h"
+#include "pairing_heap.h"
+#include "priority_queue.h"
+#include "unordered_map.h"
 using mystl::graph;
 using mystl::breadth_first_search;
+using mystl::indexed_priority_queue;
+using mystl::mst_prim_jarniks;
+using mystl::pairing_heap;
+using mystl::sssp_dijkstras;
+using mystl::sssp_dijkstras_radix;
 
 #include <chrono>
 #include <climits>
@@ -9,12 +17,21 @@ using mystl::breadth_first_search;
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <unordered_map>
+#include <type_traits>
 #include <string>
 #include <utility>
 using namespace std;
 using namespace chrono;
 
+/// @brief Random edge weight, in [0, 1] for floating point edge properties and
+///        in [1, 1000] for integral ones
+template<typename EdgeProperty>
+EdgeProperty random_weight() {
+  if(is_integral<EdgeProperty>::value)
+    return EdgeProperty(1 + rand() % 1000);
+  return EdgeProperty(double(rand()) / RAND_MAX);
+}
+
 /// @brief create a complete graph of size n
 void initialize_complete_graph(graph<int, double>& g, size_t n) {
   // add vertices
@@ -33,7 +50,8 @@ void initialize_complete_graph(graph<int, double>& g, size_t n) {
 }
 
 /// @brief create a mesh of size n
-void initialize_mesh_graph(graph<int, double>& g, size_t n) {
+template<typename EdgeProperty>
+void initialize_mesh_graph(graph<int, EdgeProperty>& g, size_t n) {
   //make n a square number
   size_t rootn = sqrt(n);
   n = rootn*rootn;
@@ -48,29 +66,30 @@ void initialize_mesh_graph(graph<int, double>& g, size_t n) {
     size_t y = i + rootn;
 
     if(x % rootn != 0)
-      g.insert_edge_undirected(i, x, double(rand()) / RAND_MAX);
+      g.insert_edge_undirected(i, x, random_weight<EdgeProperty>());
 
     if(y < n)
-      g.insert_edge_undirected(i, y, double(rand()) / RAND_MAX);
+      g.insert_edge_undirected(i, y, random_weight<EdgeProperty>());
   }
 }
 
 /// @brief create a mesh of size n
-void initialize_random_graph(graph<int, double>& g, size_t n) {
+template<typename EdgeProperty>
+void initialize_random_graph(graph<int, EdgeProperty>& g, size_t n) {
   // add vertices
   for(size_t i = 0; i < n; ++i)
     g.insert_vertex(i);
 
   // add edges for connectivity
   for(size_t i=0; i < n - 1; ++i)
-    g.insert_edge_undirected(i, i+1, double(rand()) / RAND_MAX);
+    g.insert_edge_undirected(i, i+1, random_weight<EdgeProperty>());
 
   size_t num_edges = n*sqrt(n)/2;
   for(size_t i=0; i < num_edges; ++i) {
     size_t s = rand() % n;
     size_t t = rand() % n;
     if(s != t)
-      g.insert_edge_undirected(s, t, double(rand()) / RAND_MAX);
+      g.insert_edge_undirected(s, t, random_weight<EdgeProperty>());
     else
       --i;
   }
@@ -91,7 +110,7 @@ void time_graph(Initializer i, size_t n) {
 
   //run BFS
   typedef graph_id::vertex_descriptor vertex_descriptor;
-  unordered_map<vertex_descriptor, vertex_descriptor> parent_map;
+  mystl::unordered_map<vertex_descriptor, vertex_descriptor> parent_map;
   breadth_first_search(g, parent_map);
 
   //test find operations
@@ -133,6 +152,111 @@ void time_graph(Initializer i, size_t n) {
   breadth_first_search(g, parent_map);
 }
 
+/// @brief Dijkstra's without decrease key, i.e., lazily re-insert a vertex on
+///        every improvement and skip stale heap entries. This is the baseline
+///        the indexed heaps are compared against.
+template<typename Graph, typename ParentMap, typename DistanceMap>
+void sssp_dijkstras_lazy(const Graph& g, ParentMap& p, DistanceMap& d) {
+  typedef typename Graph::vertex_descriptor vertex_descriptor;
+  typedef typename Graph::edge_property edge_property;
+  typedef pair<edge_property, vertex_descriptor> entry;
+  size_t n = g.vertices_cend() - g.vertices_cbegin();
+  vector<bool> done(n, false);
+  mystl::priority_queue<entry, mystl::vector<entry>, greater<entry>> q;
+  p[0] = 0;
+  d[0] = 0;
+  q.push(entry(0, 0));
+  while(!q.empty()) {
+    entry e = q.top();
+    q.pop();
+    if(done[e.second])
+      continue;
+    done[e.second] = true;
+    auto vert = *g.find_vertex(e.second);
+    for(auto i = vert->cbegin(); i != vert->cend(); ++i) {
+      vertex_descriptor v = (*i)->target();
+      if(v >= n || done[v])
+        continue;
+      edge_property dv = e.first + (*i)->property();
+      auto di = d.find(v);
+      if(di == d.end() || dv < di->second) {
+        p[v] = e.second;
+        d[v] = dv;
+        q.push(entry(dv, v));
+      }
+    }
+  }
+}
+
+/// @brief Time a single shortest path/spanning tree algorithm
+/// @tparam Func Function type
+/// @param f Function taking the graph to run the algorithm on
+/// @return Time in seconds
+template<typename Func>
+double time_algorithm(Func f) {
+  high_resolution_clock::time_point start = high_resolution_clock::now();
+  f();
+  high_resolution_clock::time_point stop = high_resolution_clock::now();
+  return duration_cast<duration<double>>(stop - start).count();
+}
+
+/// @brief Time Dijkstra's and Prim-Jarnik's with each priority queue on a
+///        graph of size n
+template<typename Initializer>
+void time_shortest_paths(Initializer i, size_t n, string name) {
+  typedef graph<int, double> graph_id;
+  typedef graph_id::vertex_descriptor vertex_descriptor;
+  typedef indexed_priority_queue<double> indexed_heap;
+  typedef pairing_heap<double> pair_heap;
+  graph_id g;
+  i(g, n);
+
+  mystl::unordered_map<vertex_descriptor, vertex_descriptor> p;
+  mystl::unordered_map<vertex_descriptor, double> d;
+
+  cout << setw(20) << name << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear(); d.clear();
+      sssp_dijkstras_lazy(g, p, d);}) << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear(); d.clear();
+      sssp_dijkstras<indexed_heap>(g, p, d);}) << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear(); d.clear();
+      sssp_dijkstras<pair_heap>(g, p, d);}) << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear();
+      mst_prim_jarniks<indexed_heap>(g, p);}) << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear();
+      mst_prim_jarniks<pair_heap>(g, p);}) << endl;
+}
+
+/// @brief Time Dijkstra's with a binary heap and with a radix heap on a graph
+///        of size n with integer weights
+template<typename Initializer>
+void time_integer_shortest_paths(Initializer i, size_t n, string name) {
+  typedef graph<int, unsigned> graph_iu;
+  typedef graph_iu::vertex_descriptor vertex_descriptor;
+  typedef indexed_priority_queue<unsigned, less<unsigned>, 2> binary_heap;
+  graph_iu g;
+  i(g, n);
+
+  mystl::unordered_map<vertex_descriptor, vertex_descriptor> p;
+  mystl::unordered_map<vertex_descriptor, unsigned> d;
+
+  cout << setw(20) << name << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear(); d.clear();
+      sssp_dijkstras_lazy(g, p, d);}) << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear(); d.clear();
+      sssp_dijkstras<binary_heap>(g, p, d);}) << ",";
+  cout << setw(15) << time_algorithm([&]() {
+      p.clear(); d.clear();
+      sssp_dijkstras_radix(g, p, d);}) << endl;
+}
+
 /// @brief Control timing of a single function
 /// @tparam Func Function type
 /// @param f Function taking a single size_t parameter
@@ -173,6 +297,17 @@ int main(int argc, char** argv) {
   size_t   random_size = atoi(argv[3]);
 
   time_function(initialize_complete_graph, complete_size, "Complete");
-  time_function(    initialize_mesh_graph,     mesh_size,     "Mesh");
-  time_function(  initialize_random_graph,   random_size,   "Random");
+  time_function(    initialize_mesh_graph<double>,     mesh_size,     "Mesh");
+  time_function(  initialize_random_graph<double>,   random_size,   "Random");
+
+  cout << setw(20) << "Graph," << setw(16) << "Lazy SSSP,"
+       << setw(16) << "Indexed SSSP," << setw(16) << "Pairing SSSP,"
+       << setw(16) << "Indexed MST," << setw(15) << "Pairing MST" << endl;
+  time_shortest_paths(    initialize_mesh_graph<double>,     mesh_size,     "Mesh");
+  time_shortest_paths(  initialize_random_graph<double>,   random_size,   "Random");
+
+  cout << setw(20) << "Integer graph," << setw(16) << "Lazy binary,"
+       << setw(16) << "Indexed binary," << setw(15) << "Radix" << endl;
+  time_integer_shortest_paths(    initialize_mesh_graph<unsigned>,     mesh_size,     "Mesh");
+  time_integer_shortest_paths(  initialize_random_graph<unsigned>,   random_size,   "Random");
 }
\ No newline at end of file